@@ -0,0 +1,89 @@
+#ifndef CommonTools_MVAUtils_FlatGBRForest_h
+#define CommonTools_MVAUtils_FlatGBRForest_h
+
+//--------------------------------------------------------------------------------------------------
+//
+// FlatGBRForest
+//
+// Read-only copy of a GBRForest laid out for evaluation. The nodes of all the trees are packed in
+// contiguous arrays, and the trees which are not deeper than maxPerfectDepth are stored as perfect
+// binary trees in breadth-first order: the children of node i are 2i+1 and 2i+2, so the traversal
+// is a fixed number of branch-free steps. The leaves above the full depth are padded with nodes
+// which always go left, their responses being copied to the padded leaves. Deeper trees keep the
+// left/right indices of GBRTree.
+//
+// GetResponses evaluates the forest for many candidates, tree by tree, so that the nodes of a tree
+// stay in cache and the traversals of several candidates are interleaved. The responses are
+// summed in the same order as GBRForest::GetResponse, so the results are identical.
+//
+//--------------------------------------------------------------------------------------------------
+
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+
+#include <cmath>
+#include <vector>
+
+class FlatGBRForest {
+public:
+  explicit FlatGBRForest(const GBRForest& forest, unsigned int maxPerfectDepth = 8);
+
+  double GetResponse(const float* vector) const;
+  double GetGradBoostClassifier(const float* vector) const {
+    return 2.0 / (1.0 + std::exp(-2.0 * GetResponse(vector))) - 1;
+  }
+  double GetAdaBoostClassifier(const float* vector) const { return GetResponse(vector); }
+  double GetClassifier(const float* vector) const { return GetGradBoostClassifier(vector); }
+
+  // responses[i] = GetResponse(vectors + i * stride) for i < n
+  void GetResponses(const float* vectors, unsigned int n, unsigned int stride, double* responses) const;
+
+  unsigned int nTrees() const { return trees_.size(); }
+  unsigned int nPerfectTrees() const;
+
+private:
+  struct Tree {
+    unsigned int firstNode;
+    unsigned int firstResponse;
+    int depth;  // -1 for the trees which keep the left/right indices
+  };
+
+  double treeResponse(const Tree& tree, const float* vector) const;
+
+  double initialResponse_;
+  std::vector<Tree> trees_;
+  std::vector<unsigned char> cutIndices_;
+  std::vector<float> cutVals_;
+  // only for the trees with depth -1, relative to firstNode (nodes) and firstResponse (leaves, <= 0)
+  std::vector<int> leftIndices_;
+  std::vector<int> rightIndices_;
+  std::vector<float> responses_;
+};
+
+//_______________________________________________________________________
+inline double FlatGBRForest::treeResponse(const Tree& tree, const float* vector) const {
+  const unsigned char* cutIndices = cutIndices_.data() + tree.firstNode;
+  const float* cutVals = cutVals_.data() + tree.firstNode;
+  if (tree.depth >= 0) {
+    unsigned int index = 0;
+    for (int d = 0; d < tree.depth; ++d)
+      index = 2 * index + 1 + (vector[cutIndices[index]] > cutVals[index]);
+    return responses_[tree.firstResponse + index - ((1u << tree.depth) - 1)];
+  }
+  const int* left = leftIndices_.data() + tree.firstNode;
+  const int* right = rightIndices_.data() + tree.firstNode;
+  int index = 0;
+  do {
+    index = vector[cutIndices[index]] > cutVals[index] ? right[index] : left[index];
+  } while (index > 0);
+  return responses_[tree.firstResponse - index];
+}
+
+//_______________________________________________________________________
+inline double FlatGBRForest::GetResponse(const float* vector) const {
+  double response = initialResponse_;
+  for (auto const& tree : trees_)
+    response += treeResponse(tree, vector);
+  return response;
+}
+
+#endif
@@ -11,6 +11,7 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
 #include "FWCore/ParameterSet/interface/FileInPath.h"
 
 #include <memory>
@@ -24,4 +25,8 @@ std::unique_ptr<const GBRForest> createGBRForest(const std::string &weightsFile,
 std::unique_ptr<const GBRForest> createGBRForest(const edm::FileInPath &weightsFile,
                                                  std::vector<std::string> &varNames);
 
+// Create a FlatGBRForest, the evaluation layout of the GBRForest, from an XML weight file
+std::unique_ptr<const FlatGBRForest> createFlatGBRForest(const std::string &weightsFile);
+std::unique_ptr<const FlatGBRForest> createFlatGBRForest(const edm::FileInPath &weightsFile);
+
 #endif
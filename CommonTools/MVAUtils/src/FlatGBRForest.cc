@@ -0,0 +1,121 @@
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+  // number of cuts on the longest path from node to a leaf
+  int depth(const GBRTree& tree, int node) {
+    int left = tree.LeftIndices()[node];
+    int right = tree.RightIndices()[node];
+    return 1 + std::max(left > 0 ? depth(tree, left) : 0, right > 0 ? depth(tree, right) : 0);
+  }
+
+  struct PerfectTreeFiller {
+    const GBRTree& tree;
+    const int depth;
+    unsigned char* cutIndices;
+    float* cutVals;
+    float* responses;
+
+    void fillNode(int node, unsigned int index, int level) {
+      cutIndices[index] = tree.CutIndices()[node];
+      cutVals[index] = tree.CutVals()[node];
+      fillChild(tree.LeftIndices()[node], 2 * index + 1, level + 1);
+      fillChild(tree.RightIndices()[node], 2 * index + 2, level + 1);
+    }
+
+    void fillChild(int child, unsigned int index, int level) {
+      if (child > 0)
+        fillNode(child, index, level);
+      else
+        fillLeaf(tree.Responses()[-child], index, level);
+    }
+
+    // a leaf above the full depth becomes a node which always goes left (also for NaN or +inf inputs)
+    void fillLeaf(float response, unsigned int index, int level) {
+      if (level == depth) {
+        responses[index - ((1u << depth) - 1)] = response;
+        return;
+      }
+      cutIndices[index] = 0;
+      cutVals[index] = std::numeric_limits<float>::infinity();
+      fillLeaf(response, 2 * index + 1, level + 1);
+      fillLeaf(response, 2 * index + 2, level + 1);
+    }
+  };
+
+}  // namespace
+
+FlatGBRForest::FlatGBRForest(const GBRForest& forest, unsigned int maxPerfectDepth)
+    : initialResponse_(forest.InitialResponse()) {
+  trees_.reserve(forest.Trees().size());
+  for (auto const& tree : forest.Trees()) {
+    Tree flat{static_cast<unsigned int>(cutIndices_.size()), static_cast<unsigned int>(responses_.size()), -1};
+    int d = tree.CutIndices().empty() ? 0 : depth(tree, 0);
+    if (d <= static_cast<int>(maxPerfectDepth)) {
+      flat.depth = d;
+      unsigned int nNodes = (1u << d) - 1;
+      cutIndices_.resize(flat.firstNode + nNodes);
+      cutVals_.resize(flat.firstNode + nNodes);
+      responses_.resize(flat.firstResponse + nNodes + 1);
+      PerfectTreeFiller filler{tree,
+                               d,
+                               cutIndices_.data() + flat.firstNode,
+                               cutVals_.data() + flat.firstNode,
+                               responses_.data() + flat.firstResponse};
+      if (d == 0)
+        filler.fillLeaf(tree.Responses()[0], 0, 0);
+      else
+        filler.fillNode(0, 0, 0);
+    } else {
+      cutIndices_.insert(cutIndices_.end(), tree.CutIndices().begin(), tree.CutIndices().end());
+      cutVals_.insert(cutVals_.end(), tree.CutVals().begin(), tree.CutVals().end());
+      leftIndices_.resize(flat.firstNode);
+      rightIndices_.resize(flat.firstNode);
+      leftIndices_.insert(leftIndices_.end(), tree.LeftIndices().begin(), tree.LeftIndices().end());
+      rightIndices_.insert(rightIndices_.end(), tree.RightIndices().begin(), tree.RightIndices().end());
+      responses_.insert(responses_.end(), tree.Responses().begin(), tree.Responses().end());
+    }
+    trees_.push_back(flat);
+  }
+  leftIndices_.shrink_to_fit();
+  rightIndices_.shrink_to_fit();
+}
+
+unsigned int FlatGBRForest::nPerfectTrees() const {
+  return std::count_if(trees_.begin(), trees_.end(), [](const Tree& tree) { return tree.depth >= 0; });
+}
+
+void FlatGBRForest::GetResponses(const float* vectors,
+                                 unsigned int n,
+                                 unsigned int stride,
+                                 double* responses) const {
+  constexpr unsigned int N = 8;
+
+  std::fill(responses, responses + n, initialResponse_);
+  for (auto const& tree : trees_) {
+    if (tree.depth < 0) {
+      for (unsigned int i = 0; i < n; ++i)
+        responses[i] += treeResponse(tree, vectors + i * stride);
+      continue;
+    }
+
+    // the traversals of N candidates are interleaved, they are independent and have the same length
+    const unsigned char* cutIndices = cutIndices_.data() + tree.firstNode;
+    const float* cutVals = cutVals_.data() + tree.firstNode;
+    const float* leaves = responses_.data() + tree.firstResponse;
+    const unsigned int nNodes = (1u << tree.depth) - 1;
+    for (unsigned int first = 0; first < n; first += N) {
+      const unsigned int m = std::min(N, n - first);
+      const float* vector = vectors + first * stride;
+      unsigned int index[N] = {};
+      for (int d = 0; d < tree.depth; ++d)
+        for (unsigned int l = 0; l < m; ++l)
+          index[l] = 2 * index[l] + 1 + (vector[l * stride + cutIndices[index[l]]] > cutVals[index[l]]);
+      for (unsigned int l = 0; l < m; ++l)
+        responses[first + l] += leaves[index[l] - nNodes];
+    }
+  }
+}
@@ -268,3 +268,11 @@ std::unique_ptr<const GBRForest> createGBRForest(const edm::FileInPath& weightsF
                                                  std::vector<std::string>& varNames) {
   return createGBRForest(weightsFile.fullPath(), varNames);
 }
+
+std::unique_ptr<const FlatGBRForest> createFlatGBRForest(const std::string& weightsFile) {
+  return std::make_unique<const FlatGBRForest>(*createGBRForest(weightsFile));
+}
+
+std::unique_ptr<const FlatGBRForest> createFlatGBRForest(const edm::FileInPath& weightsFile) {
+  return createFlatGBRForest(weightsFile.fullPath());
+}
@@ -0,0 +1,135 @@
+/* Unit test for FlatGBRForest: GetResponse and GetResponses give the same responses as
+   GBRForest::GetResponse, for perfect and indexed trees, and for NaN or infinite inputs
+
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+class testFlatGBRForest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testFlatGBRForest);
+  CPPUNIT_TEST(testLayout);
+  CPPUNIT_TEST(testResponses);
+  CPPUNIT_TEST(testMaxPerfectDepth);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown() {}
+
+  void testLayout();
+  void testResponses();
+  void testMaxPerfectDepth();
+
+private:
+  // adds a node to tree with children down to maxDepth cuts, returns its index
+  int grow(GBRTree& tree, int depth, int maxDepth);
+  void compare(unsigned int maxPerfectDepth);
+
+  static constexpr unsigned int nVariables = 12;
+  // the candidates are not packed, to check the stride
+  static constexpr unsigned int stride = nVariables + 3;
+  static constexpr unsigned int nCandidates = 203;
+
+  std::mt19937 engine_;
+  GBRForest forest_;
+  std::vector<float> vectors_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testFlatGBRForest);
+
+int testFlatGBRForest::grow(GBRTree& tree, int depth, int maxDepth) {
+  std::uniform_int_distribution<unsigned int> variable(0, nVariables - 1);
+  std::uniform_int_distribution<int> coin(0, 3);
+  std::normal_distribution<float> gauss(0.f, 1.f);
+
+  int node = tree.CutIndices().size();
+  tree.CutIndices().push_back(variable(engine_));
+  tree.CutVals().push_back(gauss(engine_));
+  tree.LeftIndices().push_back(0);
+  tree.RightIndices().push_back(0);
+  for (int side = 0; side < 2; ++side) {
+    // the right children go on to the full depth, the left ones stop at random
+    int child;
+    if (depth + 1 >= maxDepth || (side == 0 && coin(engine_) == 0)) {
+      child = -static_cast<int>(tree.Responses().size());
+      tree.Responses().push_back(gauss(engine_));
+    } else {
+      child = grow(tree, depth + 1, maxDepth);
+    }
+    (side == 0 ? tree.LeftIndices() : tree.RightIndices())[node] = child;
+  }
+  return node;
+}
+
+void testFlatGBRForest::setUp() {
+  engine_.seed(1);
+  forest_ = GBRForest();
+  forest_.SetInitialResponse(0.3);
+  // trees of 1 to 12 cuts, deeper than the default maxPerfectDepth for the last ones
+  for (int maxDepth = 1; maxDepth <= 12; ++maxDepth) {
+    for (int i = 0; i < 3; ++i) {
+      forest_.Trees().emplace_back();
+      grow(forest_.Trees().back(), 0, maxDepth);
+    }
+  }
+
+  std::normal_distribution<float> gauss(0.f, 1.f);
+  vectors_.resize(nCandidates * stride);
+  for (auto& x : vectors_)
+    x = gauss(engine_);
+  // NaN and infinite inputs go left at every cut, like in GBRTree, and inputs equal to a cut go left
+  const auto& tree = forest_.Trees().front();
+  for (unsigned int c = 0; c < nCandidates; c += 7) {
+    float* vector = vectors_.data() + c * stride;
+    vector[c % nVariables] = std::numeric_limits<float>::quiet_NaN();
+    vector[(c + 1) % nVariables] = (c % 2 ? 1 : -1) * std::numeric_limits<float>::infinity();
+    vector[tree.CutIndices()[0]] = tree.CutVals()[0];
+  }
+  for (unsigned int c = 3; c < nCandidates; c += 11)
+    for (unsigned int v = 0; v < nVariables; ++v)
+      vectors_[c * stride + v] = std::numeric_limits<float>::quiet_NaN();
+}
+
+void testFlatGBRForest::compare(unsigned int maxPerfectDepth) {
+  FlatGBRForest flat(forest_, maxPerfectDepth);
+  CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(forest_.Trees().size()), flat.nTrees());
+
+  std::vector<double> responses(nCandidates, 0.);
+  flat.GetResponses(vectors_.data(), nCandidates, stride, responses.data());
+  for (unsigned int c = 0; c < nCandidates; ++c) {
+    const float* vector = vectors_.data() + c * stride;
+    double response = forest_.GetResponse(vector);
+    // the responses are summed in the same order, so they are identical
+    CPPUNIT_ASSERT_EQUAL(response, flat.GetResponse(vector));
+    CPPUNIT_ASSERT_EQUAL(response, responses[c]);
+    CPPUNIT_ASSERT_EQUAL(forest_.GetClassifier(vector), flat.GetClassifier(vector));
+  }
+
+  // fewer candidates than a batch, and none
+  flat.GetResponses(vectors_.data(), 5, stride, responses.data());
+  for (unsigned int c = 0; c < 5; ++c)
+    CPPUNIT_ASSERT_EQUAL(forest_.GetResponse(vectors_.data() + c * stride), responses[c]);
+  flat.GetResponses(vectors_.data(), 0, stride, nullptr);
+}
+
+void testFlatGBRForest::testLayout() {
+  // 3 trees for each depth of 1 to 12 cuts
+  CPPUNIT_ASSERT_EQUAL(0u, FlatGBRForest(forest_, 0).nPerfectTrees());
+  CPPUNIT_ASSERT_EQUAL(24u, FlatGBRForest(forest_).nPerfectTrees());
+  CPPUNIT_ASSERT_EQUAL(36u, FlatGBRForest(forest_, 12).nPerfectTrees());
+}
+
+void testFlatGBRForest::testResponses() { compare(8); }
+
+void testFlatGBRForest::testMaxPerfectDepth() {
+  compare(0);
+  compare(4);
+  compare(12);
+}
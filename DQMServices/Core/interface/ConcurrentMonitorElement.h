@@ -6,21 +6,79 @@
  * ...
  */
 
+#include <memory>
 #include <mutex>
+#include <vector>
 #include <tbb/spin_mutex.h>
 
 #include "DQMServices/Core/interface/MonitorElement.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+
+/* Private copies of a histogram MonitorElement, one per stream.
+ *
+ * A stream fills its own copy without taking any lock. The copy of a stream is created
+ * from the MonitorElement the first time the stream fills it, so that axis labels and
+ * options set after booking are picked up, and is added to the MonitorElement and reset
+ * by the DQMStore each time the stream ends a luminosity block.
+ */
+class ConcurrentMonitorElementStreamCopies {
+private:
+  MonitorElement* me_;
+  mutable tbb::spin_mutex lock_;
+  std::vector<std::unique_ptr<MonitorElement>> copies_;
+
+public:
+  ConcurrentMonitorElementStreamCopies(MonitorElement* me, unsigned int nStreams) : me_(me), copies_(nStreams) {}
+
+  // non-copiable, non-movable
+  ConcurrentMonitorElementStreamCopies(ConcurrentMonitorElementStreamCopies const&) = delete;
+  ConcurrentMonitorElementStreamCopies& operator=(ConcurrentMonitorElementStreamCopies const&) = delete;
+
+  // protects the shared MonitorElement
+  tbb::spin_mutex& lock() const { return lock_; }
+
+  // only to be called from the stream itself
+  MonitorElement* streamCopy(unsigned int stream) {
+    auto& copy = copies_[stream];
+    if (not copy) {
+      std::lock_guard<tbb::spin_mutex> guard(lock_);
+      copy = std::make_unique<MonitorElement>(*me_);
+      copy->Reset();
+    }
+    return copy.get();
+  }
+
+  // only to be called when the stream is not filling, e.g. at the end of a luminosity block
+  void merge(unsigned int stream) {
+    auto& copy = copies_[stream];
+    if (not copy or copy->getTH1()->GetEntries() == 0)
+      return;
+    {
+      std::lock_guard<tbb::spin_mutex> guard(lock_);
+      me_->getTH1()->Add(copy->getTH1());
+      me_->update();
+    }
+    copy->Reset();
+  }
+};
 
 class ConcurrentMonitorElement {
 private:
   mutable MonitorElement* me_;
   mutable tbb::spin_mutex lock_;
+  std::shared_ptr<ConcurrentMonitorElementStreamCopies> streamCopies_;
+
+  // when the DQMStore merges stream copies into me_ it holds the lock of the copies
+  tbb::spin_mutex& fillLock() const { return streamCopies_ ? streamCopies_->lock() : lock_; }
 
 public:
   ConcurrentMonitorElement(void) : me_(nullptr) {}
 
   explicit ConcurrentMonitorElement(MonitorElement* me) : me_(me) {}
 
+  ConcurrentMonitorElement(MonitorElement* me, std::shared_ptr<ConcurrentMonitorElementStreamCopies> streamCopies)
+      : me_(me), streamCopies_(std::move(streamCopies)) {}
+
   // non-copiable
   ConcurrentMonitorElement(ConcurrentMonitorElement const&) = delete;
 
@@ -29,6 +87,7 @@ public:
     std::lock_guard<tbb::spin_mutex> guard(other.lock_);
     me_ = other.me_;
     other.me_ = nullptr;
+    streamCopies_ = std::move(other.streamCopies_);
   }
 
   // not copy-assignable
@@ -42,6 +101,7 @@ public:
     std::lock_guard<tbb::spin_mutex> others(other.lock_, std::adopt_lock);
     me_ = other.me_;
     other.me_ = nullptr;
+    streamCopies_ = std::move(other.streamCopies_);
     return *this;
   }
 
@@ -51,20 +111,38 @@ public:
   // expose as a const method to mean that it is concurrent-safe
   template <typename... Args>
   void fill(Args&&... args) const {
-    std::lock_guard<tbb::spin_mutex> guard(lock_);
+    std::lock_guard<tbb::spin_mutex> guard(fillLock());
     me_->Fill(std::forward<Args>(args)...);
   }
 
+  // fill the private copy of the stream if the DQMStore created per-stream copies for
+  // this MonitorElement, otherwise the same as fill(...)
+  template <typename... Args>
+  void streamFill(edm::StreamID stream, Args&&... args) const {
+    if (streamCopies_) {
+      streamCopies_->streamCopy(stream.value())->Fill(std::forward<Args>(args)...);
+    } else {
+      fill(std::forward<Args>(args)...);
+    }
+  }
+
   // expose as a const method to mean that it is concurrent-safe
   void shiftFillLast(double y, double ye = 0., int32_t xscale = 1) const {
-    std::lock_guard<tbb::spin_mutex> guard(lock_);
+    std::lock_guard<tbb::spin_mutex> guard(fillLock());
     me_->ShiftFillLast(y, ye, xscale);
   }
 
+  // only consistent when nothing is being filled, e.g. at the end of a run
+  double getEntries() const {
+    std::lock_guard<tbb::spin_mutex> guard(fillLock());
+    return me_->getEntries();
+  }
+
   // reset the internal pointer
   void reset() {
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_ = nullptr;
+    streamCopies_.reset();
   }
 
   operator bool() const {
@@ -22,6 +22,9 @@ private:
   void analyze(edm::StreamID, edm::Event const&, edm::EventSetup const&) const final;
 
   virtual void dqmAnalyze(edm::Event const&, edm::EventSetup const&, H const&) const = 0;
+
+  // the per-stream copies of the ConcurrentMonitorElements have been merged when this is called
+  virtual void dqmEndRun(edm::Run const&, edm::EventSetup const&, H const&) const {}
 };
 
 template <typename H, typename... Args>
@@ -40,7 +43,9 @@ std::shared_ptr<H> DQMGlobalEDAnalyzer<H, Args...>::globalBeginRun(edm::Run cons
 }
 
 template <typename H, typename... Args>
-void DQMGlobalEDAnalyzer<H, Args...>::globalEndRun(edm::Run const&, edm::EventSetup const&) const {}
+void DQMGlobalEDAnalyzer<H, Args...>::globalEndRun(edm::Run const& run, edm::EventSetup const& setup) const {
+  dqmEndRun(run, setup, *this->runCache(run.index()));
+}
 
 template <typename H, typename... Args>
 void DQMGlobalEDAnalyzer<H, Args...>::analyze(edm::StreamID,
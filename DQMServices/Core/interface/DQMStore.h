@@ -30,6 +30,7 @@ namespace edm {
   class ParameterSet;
   class ActivityRegistry;
   class GlobalContext;
+  class StreamContext;
 }  // namespace edm
 namespace lat {
   class Regexp;
@@ -215,6 +216,7 @@ public:
   private:
     explicit IBooker(DQMStore* store) noexcept : owner_{store} { assert(store); }
 
+  protected:
     // Embedded classes do not natively own a pointer to the embedding
     // class. We therefore need to store a pointer to the main
     // DQMStore instance (owner_).
@@ -655,6 +657,12 @@ public:
   bool load(std::string const& filename, OpenRunDirs stripdirs = StripRunDirs, bool fileMustExist = true);
   bool mtEnabled() { return enableMultiThread_; };
 
+  // Keep the ROOT objects of all MonitorElements compressed until they
+  // are accessed again, see MonitorElement::compact. Only done if the
+  // compactHistograms option is enabled, by DQMRootSource in harvesting,
+  // and for the MonitorElements of at least compactMinBins bins.
+  void compactContents();
+
 public:
   // -------------------------------------------------------------------------
   // ---------------------- Public print methods -----------------------------
@@ -726,12 +734,15 @@ private:
   void reset();
   void forceReset();
   void postGlobalBeginLumi(const edm::GlobalContext&);
+  void postStreamEndLumi(const edm::StreamContext&);
+  void postGlobalEndRun(const edm::GlobalContext&);
 
   bool extract(TObject* obj, std::string const& dir, bool overwrite, bool collateHistograms);
   TObject* extractNextObject(TBufferFile&) const;
 
   // ---------------------- Booking ------------------------------------
   MonitorElement* initialise(MonitorElement* me, std::string const& path);
+  ConcurrentMonitorElement makeConcurrentMonitorElement(MonitorElement* me);
   MonitorElement* book_(std::string const& dir, std::string const& name, char const* context);
   template <class HISTO, class COLLATE>
   MonitorElement* book_(
@@ -802,6 +813,13 @@ private:
   bool enableMultiThread_{false};
   bool LSbasedMode_;
   bool forceResetOnBeginLumi_{false};
+  // set to true in configuration if ConcurrentMonitorElements get per-stream copies.
+  bool concurrentMEsPerStream_{false};
+  unsigned int nStreams_{1};
+  // set to true in configuration if MonitorElements are compacted after each harvested input file.
+  bool compactHistograms_{false};
+  // number of bins, including under- and overflows, from which a MonitorElement is compacted.
+  int compactMinBins_{10000};
   std::string readSelectedDirectory_{};
   uint32_t run_{};
   uint32_t moduleId_{};
@@ -819,6 +837,9 @@ private:
   QAMap qalgos_;
   QTestSpecs qtestspecs_;
 
+  // per-stream copies of the ConcurrentMonitorElements, with the run they were booked for
+  std::vector<std::pair<uint32_t, std::shared_ptr<ConcurrentMonitorElementStreamCopies>>> streamCopies_;
+
   std::mutex book_mutex_;
 
   friend class edm::DQMHttpSource;
@@ -16,9 +16,12 @@
 #include "TObjString.h"
 #include "TAxis.h"
 #include <sys/time.h>
+#include <tbb/spin_mutex.h>
+#include <atomic>
 #include <string>
 #include <set>
 #include <map>
+#include <vector>
 #include <sstream>
 #include <iomanip>
 #include <cassert>
@@ -62,12 +65,16 @@ public:
   };
 
 private:
-  DQMNet::CoreObject data_;        //< Core object information.
-  Scalar scalar_;                  //< Current scalar value.
-  TH1 *object_;                    //< Current ROOT object value.
-  TH1 *reference_;                 //< Current ROOT reference object.
-  TH1 *refvalue_;                  //< Soft reference if any.
-  std::vector<QReport> qreports_;  //< QReports associated to this object.
+  DQMNet::CoreObject data_;                     //< Core object information.
+  Scalar scalar_;                               //< Current scalar value.
+  mutable TH1 *object_;                         //< Current ROOT object value, null while compacted.
+  TH1 *reference_;                              //< Current ROOT reference object.
+  TH1 *refvalue_;                               //< Soft reference if any.
+  std::vector<QReport> qreports_;               //< QReports associated to this object.
+  mutable std::vector<char> packed_;            //< Compressed streamed ROOT object while compacted.
+  mutable uint32_t packedSize_;                 //< Size of the streamed ROOT object before compression.
+  mutable std::atomic<bool> compacted_{false};  //< Whether packed_ holds the ROOT object.
+  mutable tbb::spin_mutex packedLock_;          //< Serialises compacting and expanding.
 
   MonitorElement *initialise(Kind kind);
   MonitorElement *initialise(Kind kind, TH1 *rootobj);
@@ -75,6 +82,16 @@ private:
   void globalize() { data_.moduleId = 0; }
   void setLumi(uint32_t ls) { data_.lumi = ls; }
 
+  /// Replace the ROOT object by its compressed streamed form, which
+  /// only takes space for the bins actually filled. The ROOT object
+  /// is rebuilt on the next access, so any TH1 pointer obtained
+  /// before is invalidated. Soft-reset MEs are never compacted.
+  /// Must not be called while the ME may be in use by another thread.
+  void compact() const;
+  bool isCompacted() const { return compacted_.load(std::memory_order_acquire); }
+  /// Rebuild the ROOT object if compacted. Safe to call concurrently.
+  TH1 *expandRootObject() const;
+
 public:
   MonitorElement();
   MonitorElement(const std::string *path, const std::string &name);
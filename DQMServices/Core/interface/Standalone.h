@@ -9,11 +9,13 @@
 #include "FWCore/ServiceRegistry/interface/ModuleCallingContext.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
+#include "FWCore/ServiceRegistry/interface/StreamContext.h"
 #include "FWCore/ServiceRegistry/interface/SystemBounds.h"
 #include "FWCore/Utilities/interface/LuminosityBlockIndex.h"
 #include "FWCore/Utilities/interface/RunIndex.h"
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 #else
+#include "FWCore/Utilities/interface/StreamID.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -106,6 +108,9 @@ namespace edm {
     template <typename F>
     void watchPostModuleGlobalEndRun(F) {}
 
+    template <typename T>
+    void watchPostStreamEndLumi(void *, T) {}
+
     PreallocationSignal preallocateSignal_;
   };
 
@@ -120,6 +125,17 @@ namespace edm {
     LuminosityBlockID luminosityBlockID() const { return LuminosityBlockID(); }
   };
 
+  class EventID {
+  public:
+    unsigned int run() const { return 0; }
+  };
+
+  class StreamContext {
+  public:
+    StreamID streamID() const { return StreamID::invalidStreamID(); }
+    EventID eventID() const { return EventID(); }
+  };
+
   class ModuleDescription {
   public:
     unsigned int id() const { return 0; }
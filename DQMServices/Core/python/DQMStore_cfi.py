@@ -14,4 +14,17 @@ DQMStore = cms.Service("DQMStore",
     # similar to LSBasedMode but for offline. Explicitly sets LumiFLag on all
     # MEs/modules that allow it (canSaveByLumi)
     saveByLumi = cms.untracked.bool(False),
+    # give the ConcurrentMonitorElements one copy per stream, filled without
+    # locking through streamFill() and merged at the end of each lumisection
+    concurrentMEsPerStream = cms.untracked.bool(False),
+    # keep the histograms compressed in memory after each input file is
+    # merged by DQMRootSource in harvesting jobs, until they are used again.
+    # Compacting deletes the ROOT objects: any TH1 pointer obtained from a
+    # MonitorElement before an input file boundary is invalid after it and
+    # must be fetched again with getTH1() and the like.
+    compactHistograms = cms.untracked.bool(False),
+    # only the histograms with at least this number of bins (including the
+    # under- and overflows) are compacted, the smaller ones would cost more
+    # to compress and expand at every input file than they save
+    compactMinBins = cms.untracked.int32(10000),
 )
@@ -0,0 +1,44 @@
+import FWCore.ParameterSet.Config as cms
+
+myWorkflow = '/My/Test/Workflow'
+
+process = cms.Process("DQMGLOBALMULTITHREAD")
+process.load("DQMServices.Core.DQM_cfg")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(200)
+)
+
+process.source = cms.Source("EmptySource",
+                            numberEventsInRun = cms.untracked.uint32(50),
+                            firstLuminosityBlock = cms.untracked.uint32(1),
+                            firstEvent = cms.untracked.uint32(1),
+                            firstRun = cms.untracked.uint32(1),
+                            numberEventsInLuminosityBlock = cms.untracked.uint32(10))
+
+process.load("DQMServices.Components.DQMFileSaver_cfi")
+process.dqmSaver.saveByRun = cms.untracked.int32(1)
+process.dqmSaver.workflow = cms.untracked.string(myWorkflow)
+
+process.dqm_global_multi_thread_a = cms.EDAnalyzer('DQMTestGlobalMultiThread',
+                                                   folder = cms.untracked.string("A_Folder/Module"),
+                                                   fillValue = cms.untracked.double(2.))
+process.dqm_global_multi_thread_b = cms.EDAnalyzer('DQMTestGlobalMultiThread',
+                                                   folder = cms.untracked.string("B_Folder/Module"),
+                                                   fillValue = cms.untracked.double(3.))
+
+process.p = cms.Path(process.dqm_global_multi_thread_a
+                     * process.dqm_global_multi_thread_b
+                     * process.dqmSaver)
+
+process.options = cms.untracked.PSet(
+    numberOfStreams = cms.untracked.uint32( 5 ),
+    numberOfThreads = cms.untracked.uint32( 5 ),
+)
+
+# Enable MultiThread DQM, with lock-free per-stream filling of the ConcurrentMonitorElements
+process.dqmSaver.enableMultiThread = cms.untracked.bool(True)
+process.DQMStore.enableMultiThread = cms.untracked.bool(True)
+process.DQMStore.concurrentMEsPerStream = cms.untracked.bool(True)
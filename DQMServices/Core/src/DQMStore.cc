@@ -18,7 +18,10 @@
 #include "TBufferFile.h"
 #include <boost/algorithm/string.hpp>
 #include <boost/range/iterator_range_core.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
+#include <algorithm>
 #include <iterator>
 #include <cerrno>
 #include <exception>
@@ -465,23 +468,23 @@ void DQMStore::IGetter::setCurrentFolder(std::string const& fullpath) { owner_->
 // ConcurrentBooker methods
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookInt(TString const& name) {
   MonitorElement* me = IBooker::bookInt(name);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookFloat(TString const& name) {
   MonitorElement* me = IBooker::bookFloat(name);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookString(TString const& name, TString const& value) {
   MonitorElement* me = IBooker::bookString(name, value);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1D(
     TString const& name, TString const& title, int const nchX, double const lowX, double const highX) {
   MonitorElement* me = IBooker::book1D(name, title, nchX, lowX, highX);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1D(TString const& name,
@@ -489,34 +492,34 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1D(TString const& name,
                                                             int nchX,
                                                             float const* xbinsize) {
   MonitorElement* me = IBooker::book1D(name, title, nchX, xbinsize);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 };
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1D(TString const& name, TH1F* object) {
   MonitorElement* me = IBooker::book1D(name, object);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1S(
     TString const& name, TString const& title, int nchX, double lowX, double highX) {
   MonitorElement* me = IBooker::book1S(name, title, nchX, lowX, highX);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1S(TString const& name, TH1S* object) {
   MonitorElement* me = IBooker::book1S(name, object);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1DD(
     TString const& name, TString const& title, int nchX, double lowX, double highX) {
   MonitorElement* me = IBooker::book1DD(name, title, nchX, lowX, highX);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1DD(TString const& name, TH1D* object) {
   MonitorElement* me = IBooker::book1DD(name, object);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2D(TString const& name,
@@ -528,18 +531,18 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2D(TString const& name,
                                                             double lowY,
                                                             double highY) {
   MonitorElement* me = IBooker::book2D(name, title, nchX, lowX, highX, nchY, lowY, highY);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2D(
     TString const& name, TString const& title, int nchX, float const* xbinsize, int nchY, float const* ybinsize) {
   MonitorElement* me = IBooker::book2D(name, title, nchX, xbinsize, nchY, ybinsize);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2D(TString const& name, TH2F* object) {
   MonitorElement* me = IBooker::book2D(name, object);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2S(TString const& name,
@@ -551,18 +554,18 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2S(TString const& name,
                                                             double lowY,
                                                             double highY) {
   MonitorElement* me = IBooker::book2S(name, title, nchX, lowX, highX, nchY, lowY, highY);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2S(
     TString const& name, TString const& title, int nchX, float const* xbinsize, int nchY, float const* ybinsize) {
   MonitorElement* me = IBooker::book2S(name, title, nchX, xbinsize, nchY, ybinsize);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2S(TString const& name, TH2S* object) {
   MonitorElement* me = IBooker::book2S(name, object);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2DD(TString const& name,
@@ -574,12 +577,12 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2DD(TString const& name
                                                              double lowY,
                                                              double highY) {
   MonitorElement* me = IBooker::book2DD(name, title, nchX, lowX, highX, nchY, lowY, highY);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2DD(TString const& name, TH2D* object) {
   MonitorElement* me = IBooker::book2DD(name, object);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book3D(TString const& name,
@@ -594,12 +597,12 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::book3D(TString const& name,
                                                             double lowZ,
                                                             double highZ) {
   MonitorElement* me = IBooker::book3D(name, title, nchX, lowX, highX, nchY, lowY, highY, nchZ, lowZ, highZ);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::book3D(TString const& name, TH3F* object) {
   MonitorElement* me = IBooker::book3D(name, object);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name,
@@ -612,7 +615,7 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const&
                                                                  double highY,
                                                                  char const* option) {
   MonitorElement* me = IBooker::bookProfile(name, title, nchX, lowX, highX, nchY, lowY, highY, option);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name,
@@ -624,7 +627,7 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const&
                                                                  double highY,
                                                                  char const* option) {
   MonitorElement* me = IBooker::bookProfile(name, title, nchX, (double)lowX, highX, lowY, highY, option);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name,
@@ -636,7 +639,7 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const&
                                                                  double highY,
                                                                  char const* option) {
   MonitorElement* me = IBooker::bookProfile(name, title, nchX, xbinsize, nchY, lowY, highY, option);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name,
@@ -647,12 +650,12 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const&
                                                                  double highY,
                                                                  char const* option) {
   MonitorElement* me = IBooker::bookProfile(name, title, nchX, xbinsize, lowY, highY, option);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name, TProfile* object) {
   MonitorElement* me = IBooker::bookProfile(name, object);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile2D(TString const& name,
@@ -667,7 +670,7 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile2D(TString const
                                                                    double highZ,
                                                                    char const* option) {
   MonitorElement* me = IBooker::bookProfile2D(name, title, nchX, lowX, highX, nchY, lowY, highY, lowZ, highZ, option);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
 }
 
 ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile2D(TString const& name,
@@ -684,7 +687,21 @@ ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile2D(TString const
                                                                    char const* option) {
   MonitorElement* me =
       IBooker::bookProfile2D(name, title, nchX, lowX, highX, nchY, lowY, highY, nchZ, lowZ, highZ, option);
-  return ConcurrentMonitorElement(me);
+  return owner_->makeConcurrentMonitorElement(me);
+}
+
+/** Called while holding the booking lock. If per-stream copies are
+ * enabled and there is more than one stream, histograms get one private
+ * copy per stream which is merged back at the end of each lumisection
+ * of the stream, see postStreamEndLumi.
+ */
+ConcurrentMonitorElement DQMStore::makeConcurrentMonitorElement(MonitorElement* me) {
+  if (not concurrentMEsPerStream_ or nStreams_ < 2 or me->kind() <= MonitorElement::DQM_KIND_STRING) {
+    return ConcurrentMonitorElement(me);
+  }
+  auto copies = std::make_shared<ConcurrentMonitorElementStreamCopies>(me, nStreams_);
+  streamCopies_.emplace_back(run_, copies);
+  return ConcurrentMonitorElement(me, std::move(copies));
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -693,6 +710,7 @@ DQMStore::DQMStore(edm::ParameterSet const& pset, edm::ActivityRegistry& ar) : D
     if (iBounds.maxNumberOfStreams() > 1) {
       enableMultiThread_ = true;
     }
+    nStreams_ = iBounds.maxNumberOfStreams();
   });
   if (pset.getUntrackedParameter<bool>("forceResetOnBeginRun", false)) {
     ar.watchPostSourceRun([this](edm::RunIndex) { forceReset(); });
@@ -704,6 +722,10 @@ DQMStore::DQMStore(edm::ParameterSet const& pset, edm::ActivityRegistry& ar) : D
 #endif
   }
   ar.watchPostGlobalBeginLumi(this, &DQMStore::postGlobalBeginLumi);
+  if (concurrentMEsPerStream_) {
+    ar.watchPostStreamEndLumi(this, &DQMStore::postStreamEndLumi);
+    ar.watchPostGlobalEndRun(this, &DQMStore::postGlobalEndRun);
+  }
 }
 
 DQMStore::DQMStore(edm::ParameterSet const& pset) { initializeFrom(pset); }
@@ -745,6 +767,16 @@ void DQMStore::initializeFrom(edm::ParameterSet const& pset) {
   if (doSaveByLumi_)
     std::cout << "DQMStore: saveByLumi option is enabled\n";
 
+  concurrentMEsPerStream_ = pset.getUntrackedParameter<bool>("concurrentMEsPerStream", false);
+  if (concurrentMEsPerStream_)
+    std::cout << "DQMStore: concurrentMEsPerStream option is enabled\n";
+
+  compactHistograms_ = pset.getUntrackedParameter<bool>("compactHistograms", false);
+  compactMinBins_ = pset.getUntrackedParameter<int>("compactMinBins", 10000);
+  if (compactHistograms_)
+    std::cout << "DQMStore: compactHistograms option is enabled for histograms of at least " << compactMinBins_
+              << " bins\n";
+
   std::string ref = pset.getUntrackedParameter<std::string>("referenceFileName", "");
   if (!ref.empty()) {
     std::cout << "DQMStore: using reference file '" << ref << "'\n";
@@ -1248,7 +1280,7 @@ MonitorElement* DQMStore::book_(
       // dir we assign the object_ of the reference MonitorElement to the
       // reference_ property of our new MonitorElement.
       me->data_.flags |= DQMNet::DQM_PROP_HAS_REFERENCE;
-      me->reference_ = referenceME->object_;
+      me->reference_ = referenceME->expandRootObject();
     }
 
     // Return the monitor element.
@@ -2058,6 +2090,70 @@ void DQMStore::postGlobalBeginLumi(edm::GlobalContext const& gc) {
   }
 }
 
+/** Called after each streamEndLuminosityBlock.
+ * Add the copies the stream filled during the lumisection to the
+ * ConcurrentMonitorElements. The booking lock is only taken once to
+ * find the copies of the current run, the MonitorElements are then
+ * merged in parallel, each one under its own lock.
+ */
+void DQMStore::postStreamEndLumi(edm::StreamContext const& sc) {
+  uint32_t run = sc.eventID().run();
+  unsigned int stream = sc.streamID().value();
+
+  std::vector<std::shared_ptr<ConcurrentMonitorElementStreamCopies>> copies;
+  {
+    std::lock_guard<std::mutex> guard(book_mutex_);
+    for (auto const& entry : streamCopies_) {
+      if (entry.first == run)
+        copies.push_back(entry.second);
+    }
+  }
+
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, copies.size()),
+                    [&copies, stream](tbb::blocked_range<std::size_t> const& range) {
+                      for (auto i = range.begin(); i != range.end(); ++i) {
+                        copies[i]->merge(stream);
+                      }
+                    });
+}
+
+/** Compact the ROOT objects of the MonitorElements of at least
+ * compactMinBins bins, except those of the reference directory which
+ * other MonitorElements point to. They are expanded again the first time
+ * they are accessed. The smaller histograms, most of the MEs but a small
+ * part of the memory, are left alone: compressing them and expanding
+ * them again when the next input file is merged would cost more than
+ * it saves.
+ * Does nothing unless the compactHistograms option is enabled. Only
+ * meant to be called by the DQMRootSource of harvesting jobs after an
+ * input file is merged, when no module is using the MonitorElements.
+ */
+void DQMStore::compactContents() {
+  if (not compactHistograms_)
+    return;
+  std::lock_guard<std::mutex> guard(book_mutex_);
+  for (auto const& me : data_) {
+    if (me.kind() < MonitorElement::DQM_KIND_TH1F or isSubdirectory(s_referenceDirName, *me.data_.dirname))
+      continue;
+    if (me.isCompacted() or me.object_->GetNcells() < compactMinBins_)
+      continue;
+    me.compact();
+  }
+}
+
+/** Called after all globalEndRun.
+ * Drop the per-stream copies of the run, they are all merged by now.
+ */
+void DQMStore::postGlobalEndRun(edm::GlobalContext const& gc) {
+  uint32_t run = gc.luminosityBlockID().run();
+
+  std::lock_guard<std::mutex> guard(book_mutex_);
+  streamCopies_.erase(std::remove_if(streamCopies_.begin(),
+                                     streamCopies_.end(),
+                                     [run](auto const& entry) { return entry.first == run; }),
+                      streamCopies_.end());
+}
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
@@ -2416,7 +2512,7 @@ bool DQMStore::extract(TObject* obj, std::string const& dir, bool const overwrit
       // MonitorElement to the reference_ property of the corresponding
       // non-reference MonitorElement.
       master->data_.flags |= DQMNet::DQM_PROP_HAS_REFERENCE;
-      master->reference_ = refcheck->object_;
+      master->reference_ = refcheck->expandRootObject();
     }
   }
 
@@ -2476,7 +2572,7 @@ void DQMStore::saveMonitorElementToROOT(MonitorElement const& me, TFile& file) {
   if (me.kind() < MonitorElement::DQM_KIND_TH1F) {
     TObjString(me.tagString().c_str()).Write();
   } else {
-    me.object_->Write();
+    me.expandRootObject()->Write();
   }
 
   // Save quality reports if this is not in reference section.
@@ -2681,7 +2777,7 @@ void DQMStore::saveMonitorElementToPB(MonitorElement const& me, dqmstorepb::ROOT
     TObjString object(me.tagString().c_str());
     buffer.WriteObject(&object);
   } else {
-    buffer.WriteObject(me.object_);
+    buffer.WriteObject(me.expandRootObject());
   }
   dqmstorepb::ROOTFilePB::Histo& histo = *file.add_histo();
   histo.set_full_pathname(*me.data_.dirname + '/' + me.data_.objname);
@@ -3,10 +3,12 @@
 #include "DQMServices/Core/interface/MonitorElement.h"
 #include "DQMServices/Core/interface/QTest.h"
 #include "DQMServices/Core/src/DQMError.h"
+#include "TBufferFile.h"
 #include "TClass.h"
 #include "TMath.h"
 #include "TList.h"
 #include "THashList.h"
+#include <zlib.h>
 #include <iostream>
 #include <cassert>
 #include <cfloat>
@@ -151,7 +153,7 @@ MonitorElement *MonitorElement::initialise(Kind kind, const std::string &value)
   return this;
 }
 
-MonitorElement::MonitorElement() : object_(nullptr), reference_(nullptr), refvalue_(nullptr) {
+MonitorElement::MonitorElement() : object_(nullptr), reference_(nullptr), refvalue_(nullptr), packedSize_(0) {
   data_.version = 0;
   data_.dirname = nullptr;
   data_.run = 0;
@@ -165,7 +167,7 @@ MonitorElement::MonitorElement() : object_(nullptr), reference_(nullptr), refval
 }
 
 MonitorElement::MonitorElement(const std::string *path, const std::string &name)
-    : object_(nullptr), reference_(nullptr), refvalue_(nullptr) {
+    : object_(nullptr), reference_(nullptr), refvalue_(nullptr), packedSize_(0) {
   data_.version = 0;
   data_.run = 0;
   data_.lumi = 0;
@@ -180,7 +182,7 @@ MonitorElement::MonitorElement(const std::string *path, const std::string &name)
 }
 
 MonitorElement::MonitorElement(const std::string *path, const std::string &name, uint32_t run, uint32_t moduleId)
-    : object_(nullptr), reference_(nullptr), refvalue_(nullptr) {
+    : object_(nullptr), reference_(nullptr), refvalue_(nullptr), packedSize_(0) {
   data_.version = 0;
   data_.run = run;
   data_.lumi = 0;
@@ -200,12 +202,19 @@ MonitorElement::MonitorElement(const MonitorElement &x, MonitorElementNoCloneTag
       object_(nullptr),
       reference_(x.reference_),
       refvalue_(nullptr),
-      qreports_(x.qreports_) {}
+      qreports_(x.qreports_),
+      packedSize_(0) {}
 
 MonitorElement::MonitorElement(const MonitorElement &x)
     : MonitorElement::MonitorElement(x, MonitorElementNoCloneTag()) {
   if (x.object_)
     object_ = static_cast<TH1 *>(x.object_->Clone());
+  else if (x.isCompacted()) {
+    std::lock_guard<tbb::spin_mutex> guard(x.packedLock_);
+    packed_ = x.packed_;
+    packedSize_ = x.packedSize_;
+    compacted_ = x.compacted_.load();
+  }
 
   if (x.refvalue_)
     refvalue_ = static_cast<TH1 *>(x.refvalue_->Clone());
@@ -214,6 +223,10 @@ MonitorElement::MonitorElement(const MonitorElement &x)
 MonitorElement::MonitorElement(MonitorElement &&o) : MonitorElement::MonitorElement(o, MonitorElementNoCloneTag()) {
   object_ = o.object_;
   refvalue_ = o.refvalue_;
+  packed_.swap(o.packed_);
+  packedSize_ = o.packedSize_;
+  compacted_ = o.compacted_.load();
+  o.compacted_ = false;
 
   o.object_ = nullptr;
   o.refvalue_ = nullptr;
@@ -632,7 +645,63 @@ TH1 *MonitorElement::accessRootObject(const char *func, int reqdim) const {
                   func,
                   data_.objname.c_str());
 
-  return checkRootObject(data_.objname, object_, func, reqdim);
+  return checkRootObject(data_.objname, expandRootObject(), func, reqdim);
+}
+
+void MonitorElement::compact() const {
+  std::lock_guard<tbb::spin_mutex> guard(packedLock_);
+  if (!object_ || refvalue_)
+    return;
+
+  TBufferFile buffer(TBufferFile::kWrite);
+  buffer.WriteObject(object_);
+
+  uLongf size = compressBound(buffer.Length());
+  std::vector<char> packed(size);
+  if (compress2(reinterpret_cast<Bytef *>(packed.data()),
+                &size,
+                reinterpret_cast<Bytef const *>(buffer.Buffer()),
+                buffer.Length(),
+                Z_BEST_SPEED) != Z_OK)
+    return;
+  packed.resize(size);
+  packed.shrink_to_fit();
+
+  packed_.swap(packed);
+  packedSize_ = buffer.Length();
+  delete object_;
+  object_ = nullptr;
+  compacted_.store(true, std::memory_order_release);
+}
+
+TH1 *MonitorElement::expandRootObject() const {
+  // fills and getters only pay for an atomic load unless the ME is compacted
+  if (not compacted_.load(std::memory_order_acquire))
+    return object_;
+
+  std::lock_guard<tbb::spin_mutex> guard(packedLock_);
+  if (not compacted_.load(std::memory_order_relaxed))
+    return object_;
+
+  std::vector<char> streamed(packedSize_);
+  uLongf size = packedSize_;
+  if (uncompress(reinterpret_cast<Bytef *>(streamed.data()),
+                 &size,
+                 reinterpret_cast<Bytef const *>(packed_.data()),
+                 packed_.size()) != Z_OK ||
+      size != packedSize_)
+    raiseDQMError("MonitorElement",
+                  "Failed to expand the compacted ROOT object of monitor element '%s'",
+                  data_.objname.c_str());
+
+  TBufferFile buffer(TBufferFile::kRead, packedSize_, streamed.data(), kFALSE);
+  object_ = static_cast<TH1 *>(buffer.ReadObject(TH1::Class()));
+  object_->SetDirectory(nullptr);
+
+  std::vector<char>().swap(packed_);
+  packedSize_ = 0;
+  compacted_.store(false, std::memory_order_release);
+  return object_;
 }
 
 /*** getter methods (wrapper around ROOT methods) ****/
@@ -874,6 +943,7 @@ TAxis *MonitorElement::getAxis(const char *func, int axis) const {
 /// (makes copy of current contents; will be subtracted from future contents)
 void MonitorElement::softReset() {
   update();
+  expandRootObject();
 
   // Create the reference object the first time this is called.
   // On subsequent calls accumulate the current value to the
@@ -985,6 +1055,7 @@ void MonitorElement::softReset() {
 /// reverts action of softReset
 void MonitorElement::disableSoftReset() {
   if (refvalue_) {
+    expandRootObject();
     if (kind() == DQM_KIND_TH1F || kind() == DQM_KIND_TH1S || kind() == DQM_KIND_TH1D || kind() == DQM_KIND_TH2F ||
         kind() == DQM_KIND_TH2S || kind() == DQM_KIND_TH2D || kind() == DQM_KIND_TH3F) {
       auto *orig = static_cast<TH1 *>(object_);
@@ -1228,7 +1299,7 @@ void MonitorElement::updateQReportStats() {
 // -------------------------------------------------------------------
 TObject *MonitorElement::getRootObject() const {
   const_cast<MonitorElement *>(this)->update();
-  return object_;
+  return expandRootObject();
 }
 
 TH1 *MonitorElement::getTH1() const {
@@ -0,0 +1,72 @@
+#include "DQMServices/Core/interface/DQMGlobalEDAnalyzer.h"
+#include "DQMServices/Core/interface/ConcurrentMonitorElement.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <atomic>
+#include <string>
+
+struct DQMTestGlobalMultiThreadHistograms {
+  ConcurrentMonitorElement myHisto;
+  ConcurrentMonitorElement myProfile;
+  // number of events analyzed in the run, by all the streams
+  mutable std::atomic<unsigned int> events{0};
+};
+
+class DQMTestGlobalMultiThread : public DQMGlobalEDAnalyzer<DQMTestGlobalMultiThreadHistograms> {
+public:
+  explicit DQMTestGlobalMultiThread(const edm::ParameterSet &);
+
+private:
+  void bookHistograms(DQMStore::ConcurrentBooker &,
+                      edm::Run const &,
+                      edm::EventSetup const &,
+                      DQMTestGlobalMultiThreadHistograms &) const override;
+
+  void dqmAnalyze(edm::Event const &,
+                  edm::EventSetup const &,
+                  DQMTestGlobalMultiThreadHistograms const &) const override;
+
+  void dqmEndRun(edm::Run const &, edm::EventSetup const &, DQMTestGlobalMultiThreadHistograms const &) const override;
+
+  std::string folder_;
+  double fill_value_;
+};
+
+DQMTestGlobalMultiThread::DQMTestGlobalMultiThread(const edm::ParameterSet &pset)
+    : folder_(pset.getUntrackedParameter<std::string>("folder")),
+      fill_value_(pset.getUntrackedParameter<double>("fillValue", 1.)) {}
+
+void DQMTestGlobalMultiThread::bookHistograms(DQMStore::ConcurrentBooker &b,
+                                              edm::Run const & /* iRun*/,
+                                              edm::EventSetup const & /* iSetup*/,
+                                              DQMTestGlobalMultiThreadHistograms &h) const {
+  b.setCurrentFolder(folder_);
+  h.myHisto = b.book1D("MyHisto", "MyHisto", 100, -0.5, 99.5);
+  h.myProfile = b.bookProfile("MyProfile", "MyProfile", 100, -0.5, 99.5, 0., 1000.);
+}
+
+void DQMTestGlobalMultiThread::dqmAnalyze(edm::Event const &iEvent,
+                                          edm::EventSetup const &,
+                                          DQMTestGlobalMultiThreadHistograms const &h) const {
+  h.myHisto.streamFill(iEvent.streamID(), fill_value_);
+  h.myProfile.streamFill(iEvent.streamID(), fill_value_, static_cast<double>(iEvent.id().event()));
+  ++h.events;
+}
+
+void DQMTestGlobalMultiThread::dqmEndRun(edm::Run const &iRun,
+                                         edm::EventSetup const &,
+                                         DQMTestGlobalMultiThreadHistograms const &h) const {
+  // every event must have been filled once, whichever stream it was processed by
+  unsigned int events = h.events;
+  if (events == 0 or h.myHisto.getEntries() != events or h.myProfile.getEntries() != events) {
+    throw cms::Exception("DQMTestGlobalMultiThread")
+        << "run " << iRun.run() << " in " << folder_ << ": " << events << " events analyzed but MyHisto has "
+        << h.myHisto.getEntries() << " entries and MyProfile " << h.myProfile.getEntries();
+  }
+}
+
+// define this as a plug-in
+DEFINE_FWK_MODULE(DQMTestGlobalMultiThread);
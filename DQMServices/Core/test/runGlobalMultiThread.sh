@@ -0,0 +1,11 @@
+#!/bin/sh
+
+function die { echo $1: status $2 ;  exit $2; }
+
+pushd ${LOCAL_TMP_DIR}
+
+# DQMTestGlobalMultiThread fails at the end of each run if the per-stream copies of its
+# histograms, filled by 5 streams, do not add up to the number of events of the run
+cmsRun ${LOCAL_TEST_DIR}/../python/test/dqm_testGlobalMultiThread_cfg.py || die 'Failure using dqm_testGlobalMultiThread_cfg.py' $?
+
+popd
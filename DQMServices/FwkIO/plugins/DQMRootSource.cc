@@ -23,6 +23,7 @@
 #include "TH1.h"
 #include "TH2.h"
 #include "TProfile.h"
+#include "tbb/parallel_for_each.h"
 
 // user include files
 #include "FWCore/Framework/interface/InputSource.h"
@@ -203,6 +204,10 @@ namespace {
     virtual ~TreeReaderBase() {}
 
     MonitorElement* read(ULong64_t iIndex, DQMStore& iStore, bool iIsLumi) { return doRead(iIndex, iStore, iIsLumi); }
+    //like read but merging into an already existing element is postponed until mergeDeferred is called
+    void readDeferred(ULong64_t iIndex, DQMStore& iStore, bool iIsLumi) { doReadDeferred(iIndex, iStore, iIsLumi); }
+    //merges everything postponed by readDeferred, different elements are merged concurrently
+    void mergeDeferred() { doMergeDeferred(); }
     virtual void setTree(TTree* iTree) = 0;
 
   protected:
@@ -210,6 +215,8 @@ namespace {
 
   private:
     virtual MonitorElement* doRead(ULong64_t iIndex, DQMStore& iStore, bool iIsLumi) = 0;
+    virtual void doReadDeferred(ULong64_t iIndex, DQMStore& iStore, bool iIsLumi) { doRead(iIndex, iStore, iIsLumi); }
+    virtual void doMergeDeferred() {}
   };
 
   template <class T>
@@ -236,6 +243,41 @@ namespace {
       }
       return element;
     }
+    void doReadDeferred(ULong64_t iIndex, DQMStore& iStore, bool iIsLumi) override {
+      //read into an object we own so it can outlive the next GetEntry
+      auto value = std::make_unique<T>();
+      m_buffer = value.get();
+      m_tree->SetBranchAddress(kValueBranch, &m_buffer);
+      m_tree->GetEntry(iIndex);
+      m_buffer = nullptr;
+
+      MonitorElement* element = iStore.get(*m_fullName);
+      if (nullptr == element) {
+        //booking modifies the DQMStore so it can not be postponed
+        std::string path;
+        const char* name;
+        splitName(*m_fullName, path, name);
+        iStore.setCurrentFolder(path);
+        element = createElement(iStore, name, value.get());
+        if (iIsLumi) {
+          element->setLumiFlag();
+        }
+      } else {
+        m_deferred[element].push_back(std::move(value));
+      }
+      if (0 != m_tag) {
+        iStore.tag(element, m_tag);
+      }
+    }
+    void doMergeDeferred() override {
+      //each element only sees its own values so no two tasks touch the same element
+      tbb::parallel_for_each(m_deferred.begin(), m_deferred.end(), [](auto& iElementAndValues) {
+        for (auto& value : iElementAndValues.second) {
+          mergeWithElement(iElementAndValues.first, value.get());
+        }
+      });
+      m_deferred.clear();
+    }
     void setTree(TTree* iTree) override {
       m_tree = iTree;
       m_tree->SetBranchAddress(kFullNameBranch, &m_fullName);
@@ -248,6 +290,7 @@ namespace {
     std::string* m_fullName;
     T* m_buffer;
     uint32_t m_tag;
+    std::map<MonitorElement*, std::vector<std::unique_ptr<T>>> m_deferred;
   };
 
   template <class T>
@@ -388,6 +431,7 @@ private:
   unsigned int m_lastSeenLumi2;
   unsigned int m_filterOnRun;
   bool m_skipBadFiles;
+  bool m_mergeConcurrently;
   std::vector<edm::LuminosityBlockRange> m_lumisToProcess;
   std::vector<edm::RunNumber_t> m_runsToProcess;
 
@@ -414,6 +458,9 @@ void DQMRootSource::fillDescriptions(edm::ConfigurationDescriptions& description
   desc.addUntracked<std::vector<std::string> >("fileNames")->setComment("Names of files to be processed.");
   desc.addUntracked<unsigned int>("filterOnRun", 0)->setComment("Just limit the process to the selected run.");
   desc.addUntracked<bool>("skipBadFiles", false)->setComment("Skip the file if it is not valid");
+  desc.addUntracked<bool>("mergeConcurrently", false)
+      ->setComment(
+          "Read all elements of a run or lumi first and then merge them into the existing elements concurrently.");
   desc.addUntracked<std::string>("overrideCatalog", std::string())
       ->setComment("An alternate file catalog to use instead of the standard site one.");
   std::vector<edm::LuminosityBlockRange> defaultLumis;
@@ -441,6 +488,7 @@ DQMRootSource::DQMRootSource(edm::ParameterSet const& iPSet, const edm::InputSou
       m_lastSeenLumi2(0),
       m_filterOnRun(iPSet.getUntrackedParameter<unsigned int>("filterOnRun", 0)),
       m_skipBadFiles(iPSet.getUntrackedParameter<bool>("skipBadFiles", false)),
+      m_mergeConcurrently(iPSet.getUntrackedParameter<bool>("mergeConcurrently", false)),
       m_lumisToProcess(iPSet.getUntrackedParameter<std::vector<edm::LuminosityBlockRange> >(
           "lumisToProcess", std::vector<edm::LuminosityBlockRange>())),
       m_justOpenedFileSoNeedToGenerateRunTransition(false),
@@ -650,6 +698,10 @@ void DQMRootSource::closeFile_() {
   }
   edm::Service<edm::JobReport> jr;
   jr->inputFileClosed(edm::InputType::Primary, m_jrToken);
+
+  //the elements of the file are merged, keep them compacted until they are used again
+  edm::Service<DQMStore> store;
+  store->compactContents();
 }
 
 void DQMRootSource::readElements() {
@@ -669,11 +721,17 @@ void DQMRootSource::readElements() {
       ULong64_t endIndex = runLumiRange.m_lastIndex + 1;
       for (; index != endIndex; ++index) {
         bool isLumi = runLumiRange.m_lumi != 0;
-        if (m_shouldReadMEs)
-          reader->read(index, *store, isLumi);
+        if (m_shouldReadMEs) {
+          if (m_mergeConcurrently)
+            reader->readDeferred(index, *store, isLumi);
+          else
+            reader->read(index, *store, isLumi);
+        }
 
         //std::cout << runLumiRange.m_run << " " << runLumiRange.m_lumi <<" "<<index<< " " << runLumiRange.m_type << std::endl;
       }
+      if (m_shouldReadMEs && m_mergeConcurrently)
+        reader->mergeDeferred();
     }
 
     if (m_presentIndexItr != m_orderedIndices.end()) {
@@ -3,7 +3,10 @@ from builtins import range
 import ROOT as R
 import sys
 
-f = R.TFile.Open("dqm_merged_file1_file2.root")
+fileName = "dqm_merged_file1_file2.root"
+if len(sys.argv) > 1:
+    fileName = sys.argv[1]
+f = R.TFile.Open(fileName)
 
 th1fs = f.Get("TH1Fs")
 
@@ -112,6 +112,16 @@ pushd ${LOCAL_TMP_DIR}
   echo ${testConfig} ------------------------------------------------------------
   cmsRun -p ${LOCAL_TEST_DIR}/${testConfig} || die "cmsRun ${testConfig}" $?
 
+  testConfig=merge_file1_file2_concurrent_cfg.py
+  rm -f dqm_merged_file1_file2_concurrent.root
+  echo ${testConfig} ------------------------------------------------------------
+  cmsRun -p ${LOCAL_TEST_DIR}/${testConfig} || die "cmsRun ${testConfig}" $?
+
+  checkFile=check_merged_file1_file2.py
+  fileToCheck=dqm_merged_file1_file2_concurrent.root
+  echo ${checkFile} ${fileToCheck} ------------------------------------------------------------
+  python ${LOCAL_TEST_DIR}/${checkFile} ${fileToCheck} || die "python ${checkFile} ${fileToCheck}" $?
+
   testConfig=merge_file1_file3_file2_cfg.py
   rm -f dqm_merged_file1_file3_file2.root
   echo ${testConfig} ------------------------------------------------------------
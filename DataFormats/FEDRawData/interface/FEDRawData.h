@@ -48,6 +48,11 @@ public:
   /// the size is a multiple of the size of a FED word (8 bytes)
   void resize(size_t newsize);
 
+  /// Replace the content by a copy of the size bytes at data, without the
+  /// initialization of the buffer done by resize. It is required that
+  /// the size is a multiple of the size of a FED word (8 bytes)
+  void assign(const unsigned char *data, size_t size);
+
 private:
   Data data_;
 };
@@ -8,6 +8,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <DataFormats/FEDRawData/interface/FEDRawData.h>
+#include <FWCore/Utilities/interface/Exception.h>
 
 #include <iostream>
 
@@ -16,6 +17,7 @@ class testFEDRawData : public CppUnit::TestFixture {
 
   CPPUNIT_TEST(testCtor);
   CPPUNIT_TEST(testdata);
+  CPPUNIT_TEST(testAssign);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -24,6 +26,7 @@ public:
   void tearDown() {}
   void testCtor();
   void testdata();
+  void testAssign();
 };
 
 ///registration of the test so that the runner can find it
@@ -50,4 +53,24 @@ void testFEDRawData::testdata() {
   CPPUNIT_ASSERT(buf[47] == 'c');
 }
 
+void testFEDRawData::testAssign() {
+  unsigned char buf[32];
+  for (unsigned int i = 0; i < sizeof(buf); ++i)
+    buf[i] = i;
+
+  FEDRawData f(48);
+  f.assign(buf, 16);
+  CPPUNIT_ASSERT(f.size() == size_t(16));
+  CPPUNIT_ASSERT(f.data() != buf);
+  CPPUNIT_ASSERT(f.data()[0] == 0);
+  CPPUNIT_ASSERT(f.data()[15] == 15);
+
+  f.assign(buf + 8, 24);
+  CPPUNIT_ASSERT(f.size() == size_t(24));
+  CPPUNIT_ASSERT(f.data()[0] == 8);
+  CPPUNIT_ASSERT(f.data()[23] == 31);
+
+  CPPUNIT_ASSERT_THROW(f.assign(buf, 12), cms::Exception);
+}
+
 #include <Utilities/Testing/interface/CppUnit_testdriver.icpp>
@@ -0,0 +1,81 @@
+#ifndef DataFormats_SiPixelCluster_SiPixelClustersSoA_h
+#define DataFormats_SiPixelCluster_SiPixelClustersSoA_h
+
+/** \class SiPixelClustersSoA
+ *
+ *  Pixel clusters of an event as a structure of arrays, transient.
+ *  The clusters of a module are contiguous, the modules being in increasing detId order, and the
+ *  pixels of a cluster are contiguous. Cluster i of the event is made of the pixels
+ *  pixelBegin(i) ... pixelEnd(i)-1, and the clusters of module m are moduleBegin(m) ... moduleEnd(m)-1.
+ *
+ *  Filled with beginModule(detId), then addPixel(row, col, adc) for each pixel of a cluster
+ *  followed by endCluster(), for each cluster of the module.
+ */
+
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class SiPixelClustersSoA {
+public:
+  SiPixelClustersSoA() : moduleStart_(1, 0), pixelStart_(1, 0) {}
+
+  void reserve(unsigned int nModules, unsigned int nClusters, unsigned int nPixels) {
+    detId_.reserve(nModules);
+    moduleStart_.reserve(nModules + 1);
+    pixelStart_.reserve(nClusters + 1);
+    row_.reserve(nPixels);
+    col_.reserve(nPixels);
+    adc_.reserve(nPixels);
+  }
+
+  void beginModule(uint32_t detId) {
+    detId_.push_back(detId);
+    moduleStart_.push_back(moduleStart_.back());
+  }
+  void addPixel(uint16_t row, uint16_t col, uint16_t adc) {
+    row_.push_back(row);
+    col_.push_back(col);
+    adc_.push_back(adc);
+  }
+  void endCluster() {
+    pixelStart_.push_back(row_.size());
+    ++moduleStart_.back();
+  }
+
+  unsigned int nModules() const { return detId_.size(); }
+  unsigned int nClusters() const { return pixelStart_.size() - 1; }
+  unsigned int nPixels() const { return row_.size(); }
+
+  uint32_t detId(unsigned int module) const { return detId_[module]; }
+  unsigned int moduleBegin(unsigned int module) const { return moduleStart_[module]; }
+  unsigned int moduleEnd(unsigned int module) const { return moduleStart_[module + 1]; }
+
+  unsigned int pixelBegin(unsigned int cluster) const { return pixelStart_[cluster]; }
+  unsigned int pixelEnd(unsigned int cluster) const { return pixelStart_[cluster + 1]; }
+  unsigned int size(unsigned int cluster) const { return pixelEnd(cluster) - pixelBegin(cluster); }
+
+  /// cluster i as a SiPixelCluster
+  SiPixelCluster cluster(unsigned int i) const {
+    auto first = pixelBegin(i), last = pixelEnd(i);
+    auto xmin = *std::min_element(row_.begin() + first, row_.begin() + last);
+    auto ymin = *std::min_element(col_.begin() + first, col_.begin() + last);
+    return SiPixelCluster(last - first, adc_.data() + first, row_.data() + first, col_.data() + first, xmin, ymin);
+  }
+
+  const uint16_t* row() const { return row_.data(); }
+  const uint16_t* col() const { return col_.data(); }
+  const uint16_t* adc() const { return adc_.data(); }
+
+private:
+  std::vector<uint32_t> detId_;
+  std::vector<uint32_t> moduleStart_;  // nModules()+1 entries
+  std::vector<uint32_t> pixelStart_;   // nClusters()+1 entries
+  std::vector<uint16_t> row_;
+  std::vector<uint16_t> col_;
+  std::vector<uint16_t> adc_;  // charge in electrons, as in SiPixelCluster
+};
+
+#endif
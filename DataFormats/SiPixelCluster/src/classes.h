@@ -5,5 +5,6 @@
 #include "DataFormats/Common/interface/Wrapper.h"
 #include "DataFormats/Common/interface/ContainerMask.h"
 #include "DataFormats/SiPixelCluster/interface/SiPixelClusterShapeCache.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelClustersSoA.h"
 
 #endif  // SIPIXELCLUSTER_CLASSES_H
@@ -0,0 +1,54 @@
+#ifndef DataFormats_TrackerRecHit2D_SiPixelRecHitsSoA_h
+#define DataFormats_TrackerRecHit2D_SiPixelRecHitsSoA_h
+
+/** \class SiPixelRecHitsSoA
+ *
+ *  Local position, error and quality word of pixel hits as a structure of arrays, transient.
+ *  Hit i is the one of cluster i of the SiPixelClustersSoA it was made from.
+ */
+
+#include "DataFormats/GeometryVector/interface/LocalPoint.h"
+#include "DataFormats/GeometryCommonDetAlgo/interface/LocalError.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHitQuality.h"
+
+#include <vector>
+
+class SiPixelRecHitsSoA {
+public:
+  void reserve(unsigned int nHits) {
+    x_.reserve(nHits);
+    y_.reserve(nHits);
+    xx_.reserve(nHits);
+    xy_.reserve(nHits);
+    yy_.reserve(nHits);
+    qualWord_.reserve(nHits);
+  }
+
+  void push_back(const LocalPoint& position, const LocalError& error, SiPixelRecHitQuality::QualWordType qualWord) {
+    x_.push_back(position.x());
+    y_.push_back(position.y());
+    xx_.push_back(error.xx());
+    xy_.push_back(error.xy());
+    yy_.push_back(error.yy());
+    qualWord_.push_back(qualWord);
+  }
+
+  unsigned int size() const { return x_.size(); }
+
+  LocalPoint localPosition(unsigned int i) const { return LocalPoint(x_[i], y_[i]); }
+  LocalError localPositionError(unsigned int i) const { return LocalError(xx_[i], xy_[i], yy_[i]); }
+  SiPixelRecHitQuality::QualWordType qualWord(unsigned int i) const { return qualWord_[i]; }
+
+  const float* x() const { return x_.data(); }
+  const float* y() const { return y_.data(); }
+  const float* xx() const { return xx_.data(); }
+  const float* xy() const { return xy_.data(); }
+  const float* yy() const { return yy_.data(); }
+
+private:
+  std::vector<float> x_, y_;
+  std::vector<float> xx_, xy_, yy_;
+  std::vector<SiPixelRecHitQuality::QualWordType> qualWord_;
+};
+
+#endif
@@ -70,6 +70,12 @@ public:
   typedef cms_uint32_t Word32;
   typedef cms_uint64_t Word64;
 
+  /// Digis in the order of the raw data, with the detId of each of them
+  struct FlatDigis {
+    std::vector<cms_uint32_t> rawIds;
+    std::vector<PixelDigi> digis;
+  };
+
   PixelDataFormatter(const SiPixelFedCabling* map, bool phase1 = false);
 
   void setErrorStatus(bool ErrorStatus);
@@ -81,6 +87,7 @@ public:
   int nWords() const { return theWordCounter; }
 
   void interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& data, Collection& digis, Errors& errors);
+  void interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& data, FlatDigis& digis, Errors& errors);
 
   void formatRawData(unsigned int lvl1_ID, RawData& fedRawData, const Digis& digis, const BadChannels& badChannels);
 
@@ -111,6 +118,9 @@ private:
 
   int checkError(const Word32& data) const;
 
+  template <typename DigiFiller>
+  void unpack(bool& errorsInEvent, int fedId, const FEDRawData& data, DigiFiller& digis, Errors& errors);
+
   int digi2word(cms_uint32_t detId, const PixelDigi& digi, std::map<int, std::vector<Word32> >& words) const;
   int digi2wordPhase1Layer1(cms_uint32_t detId,
                             const PixelDigi& digi,
@@ -122,8 +122,58 @@ void PixelDataFormatter::setModulesToUnpack(const std::set<unsigned int>* module
 
 void PixelDataFormatter::passFrameReverter(const SiPixelFrameReverter* reverter) { theFrameReverter = reverter; }
 
+namespace {
+  // Destinations of the unpacked digis: newModule(rawId) is called when the data of a ROC of
+  // module rawId start, push(digi) for each digi of that ROC.
+  class DetSetVectorFiller {
+  public:
+    explicit DetSetVectorFiller(PixelDataFormatter::Collection& digis) : digis_(digis), detDigis_(nullptr) {}
+    void newModule(cms_uint32_t rawId) {
+      detDigis_ = &digis_.find_or_insert(rawId);
+      if ((*detDigis_).empty())
+        (*detDigis_).data.reserve(32);  // avoid the first relocations
+    }
+    const PixelDigi& push(int row, int col, int adc) {
+      (*detDigis_).data.emplace_back(row, col, adc);
+      return (*detDigis_).data.back();
+    }
+
+  private:
+    PixelDataFormatter::Collection& digis_;
+    edm::DetSet<PixelDigi>* detDigis_;
+  };
+
+  class FlatDigisFiller {
+  public:
+    explicit FlatDigisFiller(PixelDataFormatter::FlatDigis& digis) : digis_(digis), rawId_(0) {}
+    void newModule(cms_uint32_t rawId) { rawId_ = rawId; }
+    const PixelDigi& push(int row, int col, int adc) {
+      digis_.rawIds.push_back(rawId_);
+      digis_.digis.emplace_back(row, col, adc);
+      return digis_.digis.back();
+    }
+
+  private:
+    PixelDataFormatter::FlatDigis& digis_;
+    cms_uint32_t rawId_;
+  };
+}  // namespace
+
 void PixelDataFormatter::interpretRawData(
     bool& errorsInEvent, int fedId, const FEDRawData& rawData, Collection& digis, Errors& errors) {
+  DetSetVectorFiller filler(digis);
+  unpack(errorsInEvent, fedId, rawData, filler, errors);
+}
+
+void PixelDataFormatter::interpretRawData(
+    bool& errorsInEvent, int fedId, const FEDRawData& rawData, FlatDigis& digis, Errors& errors) {
+  FlatDigisFiller filler(digis);
+  unpack(errorsInEvent, fedId, rawData, filler, errors);
+}
+
+template <typename DigiFiller>
+void PixelDataFormatter::unpack(
+    bool& errorsInEvent, int fedId, const FEDRawData& rawData, DigiFiller& digis, Errors& errors) {
   using namespace sipixelobjects;
 
   int nWords = rawData.size() / sizeof(Word64);
@@ -167,7 +217,6 @@ void PixelDataFormatter::interpretRawData(
   int layer = 0;
   PixelROC const* rocp = nullptr;
   bool skipROC = false;
-  edm::DetSet<PixelDigi>* detDigis = nullptr;
 
   const Word32* bw = (const Word32*)(header + 1);
   const Word32* ew = (const Word32*)(trailer);
@@ -225,9 +274,7 @@ void PixelDataFormatter::interpretRawData(
       if (skipROC)
         continue;
 
-      detDigis = &digis.find_or_insert(rawId);
-      if ((*detDigis).empty())
-        (*detDigis).data.reserve(32);  // avoid the first relocations
+      digis.newModule(rawId);
     }
 
     // skip is roc to be skipped ot invalid
@@ -235,7 +282,7 @@ void PixelDataFormatter::interpretRawData(
       UNLIKELY(skipROC || !rocp) continue;
 
     int adc = (ww >> ADC_shift) & ADC_mask;
-    std::unique_ptr<LocalPixel> local;
+    GlobalPixel global;
 
     if (phase1 && layer == 1) {  // special case for layer 1ROC
       // for l1 roc use the roc column and row index instead of dcol and pixel index.
@@ -253,7 +300,7 @@ void PixelDataFormatter::interpretRawData(
           errorcheck->conversionError(fedId, &converter, 3, ww, errors);
           continue;
         }
-      local = std::make_unique<LocalPixel>(localCR);  // local pixel coordinate
+      global = rocp->toGlobal(LocalPixel(localCR));  // global pixel coordinate (in module)
       //if(DANEK) cout<<local->dcol()<<" "<<local->pxid()<<" "<<local->rocCol()<<" "<<local->rocRow()<<endl;
 
     } else {  // phase0 and phase1 except bpix layer 1
@@ -272,14 +319,13 @@ void PixelDataFormatter::interpretRawData(
           errorcheck->conversionError(fedId, &converter, 3, ww, errors);
           continue;
         }
-      local = std::make_unique<LocalPixel>(localDP);  // local pixel coordinate
+      global = rocp->toGlobal(LocalPixel(localDP));  // global pixel coordinate (in module)
       //if(DANEK) cout<<local->dcol()<<" "<<local->pxid()<<" "<<local->rocCol()<<" "<<local->rocRow()<<endl;
     }
 
-    GlobalPixel global = rocp->toGlobal(*local);  // global pixel coordinate (in module)
-    (*detDigis).data.emplace_back(global.row, global.col, adc);
+    const PixelDigi& digi = digis.push(global.row, global.col, adc);
     //if(DANEK) cout<<global.row<<" "<<global.col<<" "<<adc<<endl;
-    LogTrace("") << (*detDigis).data.back();
+    LogTrace("") << digi;
   }
 }
 
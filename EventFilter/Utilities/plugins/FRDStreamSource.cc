@@ -137,8 +137,7 @@ bool FRDStreamSource::setRunAndEventInfo(edm::EventID& id,
       }
     }
     FEDRawData& fedData = rawData_->FEDData(fedId);
-    fedData.resize(fedSize);
-    memcpy(fedData.data(), event + eventSize, fedSize);
+    fedData.assign(event + eventSize, fedSize);
   }
   assert(eventSize == 0);
 
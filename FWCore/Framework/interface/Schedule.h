@@ -107,6 +107,7 @@ namespace edm {
   class OutputModuleCommunicator;
   class ProcessContext;
   class ProductRegistry;
+  class PathsAndConsumesOfModulesBase;
   class PreallocationConfiguration;
   class StreamSchedule;
   class GlobalSchedule;
@@ -282,6 +283,9 @@ namespace edm {
     /// Convert "@currentProcess" in InputTag process names to the actual current process name.
     void convertCurrentProcessAlias(std::string const& processName);
 
+    /// Use the module dependencies to set the order in which each stream starts its trigger paths.
+    void initializeCriticalPathPriorities(PathsAndConsumesOfModulesBase const&);
+
   private:
     void limitOutput(ParameterSet const& proc_pset,
                      BranchIDLists const& branchIDLists,
@@ -536,6 +536,7 @@ namespace edm {
     //NOTE: this may throw
     checkForModuleDependencyCorrectness(pathsAndConsumesOfModules_, printDependencies_);
     actReg_->preBeginJobSignal_(pathsAndConsumesOfModules_, processContext_);
+    schedule_->initializeCriticalPathPriorities(pathsAndConsumesOfModules_);
 
     if (preallocations_.numberOfLuminosityBlocks() > 1) {
       warnAboutModulesRequiringLuminosityBLockSynchronization();
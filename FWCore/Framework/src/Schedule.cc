@@ -1254,6 +1254,12 @@ namespace edm {
     }
   }
 
+  void Schedule::initializeCriticalPathPriorities(PathsAndConsumesOfModulesBase const& iPnC) {
+    for (auto& s : streamSchedules_) {
+      s->initializeCriticalPathPriorities(iPnC);
+    }
+  }
+
   void Schedule::availablePaths(std::vector<std::string>& oLabelsToFill) const {
     streamSchedules_[0]->availablePaths(oLabelsToFill);
   }
@@ -16,6 +16,7 @@
 #include "FWCore/Framework/src/ModuleHolder.h"
 #include "FWCore/Framework/src/WorkerT.h"
 #include "FWCore/Framework/src/ModuleRegistry.h"
+#include "FWCore/ServiceRegistry/interface/PathsAndConsumesOfModulesBase.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
@@ -36,6 +37,8 @@
 #include <list>
 #include <map>
 #include <exception>
+#include <numeric>
+#include <unordered_map>
 
 namespace edm {
   namespace {
@@ -126,6 +129,14 @@ namespace edm {
         }
       }
     }
+
+    //The estimated costs are recalculated using the measured module times after this many events
+    constexpr unsigned int kEventsBetweenPriorityUpdates = 200;
+
+    //Cost assigned to a module which has not yet been timed. Using a non-zero value means
+    // that before any timing information is available the longest chain of dependent
+    // modules is considered to be the critical one.
+    constexpr double kDefaultModuleCost = 1.;
   }  // namespace
 
   // -----------------------------
@@ -162,8 +173,11 @@ namespace edm {
         streamID_(streamID),
         streamContext_(streamID_, processContext),
         endpathsAreActive_(true),
-        skippingEvent_(false) {
+        skippingEvent_(false),
+        eventsUntilPriorityUpdate_(0),
+        prioritizeCriticalPath_(false) {
     ParameterSet const& opts = proc_pset.getUntrackedParameterSet("options", ParameterSet());
+    prioritizeCriticalPath_ = opts.getUntrackedParameter<bool>("prioritizeCriticalPath", false);
     bool hasPath = false;
     std::vector<std::string> const& pathNames = tns.getTrigPaths();
     std::vector<std::string> const& endPathNames = tns.getEndPaths();
@@ -238,8 +252,101 @@ namespace edm {
 
     initializeEarlyDelete(*modReg, opts, preg, allowEarlyDelete);
 
+    //by default start the paths in reverse order so on single threaded the first path will run first
+    trigPathLaunchOrder_.resize(trig_paths_.size());
+    std::iota(trigPathLaunchOrder_.rbegin(), trigPathLaunchOrder_.rend(), 0U);
   }  // StreamSchedule::StreamSchedule
 
+  void StreamSchedule::initializeCriticalPathPriorities(PathsAndConsumesOfModulesBase const& iPnC) {
+    if (not prioritizeCriticalPath_) {
+      return;
+    }
+    std::unordered_map<unsigned int, unsigned int> moduleIDToWorkerIndex;
+    unsigned int index = 0;
+    for (auto const& worker : allWorkers()) {
+      moduleIDToWorkerIndex.emplace(worker->description().id(), index);
+      worker->setTimeEventProcessing(true);
+      ++index;
+    }
+
+    workerToConsumedWorkers_.clear();
+    workerToConsumedWorkers_.resize(allWorkers().size());
+    for (auto const* desc : iPnC.allModules()) {
+      auto itWorker = moduleIDToWorkerIndex.find(desc->id());
+      if (itWorker == moduleIDToWorkerIndex.end()) {
+        continue;
+      }
+      auto& consumed = workerToConsumedWorkers_[itWorker->second];
+      for (auto const* consumedDesc : iPnC.modulesWhoseProductsAreConsumedBy(desc->id())) {
+        auto itConsumed = moduleIDToWorkerIndex.find(consumedDesc->id());
+        if (itConsumed != moduleIDToWorkerIndex.end()) {
+          consumed.push_back(itConsumed->second);
+        }
+      }
+    }
+    updateCriticalPathPriorities();
+  }
+
+  void StreamSchedule::updateCriticalPathPriorities() {
+    eventsUntilPriorityUpdate_ = kEventsBetweenPriorityUpdates;
+
+    auto const& workers = allWorkers();
+    std::unordered_map<Worker const*, unsigned int> workerToIndex;
+    workerToIndex.reserve(workers.size());
+    std::vector<double> cost(workers.size(), kDefaultModuleCost);
+    for (unsigned int i = 0; i < workers.size(); ++i) {
+      workerToIndex.emplace(workers[i], i);
+      double const measured = workers[i]->averageEventRealTime();
+      if (measured > 0.) {
+        cost[i] = measured;
+      }
+    }
+
+    //earliest time a module can start: the longest chain of the modules it (indirectly) depends upon
+    constexpr double kNotYetCalculated = -1.;
+    constexpr double kBeingCalculated = -2.;
+    std::vector<double> earliestStart(workers.size(), kNotYetCalculated);
+    std::function<double(unsigned int)> startOf = [&](unsigned int iIndex) -> double {
+      if (earliestStart[iIndex] >= 0.) {
+        return earliestStart[iIndex];
+      }
+      if (earliestStart[iIndex] == kBeingCalculated) {
+        //cycles are reported elsewhere, just break the recursion
+        return 0.;
+      }
+      earliestStart[iIndex] = kBeingCalculated;
+      double start = 0.;
+      for (auto consumed : workerToConsumedWorkers_[iIndex]) {
+        start = std::max(start, startOf(consumed) + cost[consumed]);
+      }
+      earliestStart[iIndex] = start;
+      return start;
+    };
+
+    //modules on a Path run one after the other, each waiting for its own dependencies
+    std::vector<double> pathFinish(trig_paths_.size(), 0.);
+    for (unsigned int iPath = 0; iPath < trig_paths_.size(); ++iPath) {
+      auto const& path = trig_paths_[iPath];
+      double finish = 0.;
+      for (Path::size_type iModule = 0; iModule < path.size(); ++iModule) {
+        auto itWorker = workerToIndex.find(path.getWorker(iModule));
+        if (itWorker == workerToIndex.end()) {
+          continue;
+        }
+        finish = std::max(finish, startOf(itWorker->second)) + cost[itWorker->second];
+      }
+      pathFinish[iPath] = finish;
+    }
+
+    //the Path expected to finish last is started last so it is the first to run.
+    // Ties keep the configuration order.
+    std::iota(trigPathLaunchOrder_.rbegin(), trigPathLaunchOrder_.rend(), 0U);
+    std::stable_sort(
+        trigPathLaunchOrder_.begin(), trigPathLaunchOrder_.end(), [&pathFinish](unsigned int iLHS, unsigned int iRHS) {
+          return pathFinish[iLHS] < pathFinish[iRHS];
+        });
+  }
+
   void StreamSchedule::initializeEarlyDelete(ModuleRegistry& modReg,
                                              edm::ParameterSet const& opts,
                                              edm::ProductRegistry const& preg,
@@ -634,8 +741,11 @@ namespace edm {
         it->processOneOccurrenceAsync(allPathsDone, ep, es, serviceToken, streamID_, &streamContext_);
       }
 
-      for (auto it = trig_paths_.rbegin(), itEnd = trig_paths_.rend(); it != itEnd; ++it) {
-        it->processOneOccurrenceAsync(pathsDone, ep, es, serviceToken, streamID_, &streamContext_);
+      if (prioritizeCriticalPath_ and 0 == --eventsUntilPriorityUpdate_) {
+        updateCriticalPathPriorities();
+      }
+      for (auto index : trigPathLaunchOrder_) {
+        trig_paths_[index].processOneOccurrenceAsync(pathsDone, ep, es, serviceToken, streamID_, &streamContext_);
       }
 
       ParentContext parentContext(&streamContext_);
@@ -111,6 +111,7 @@ namespace edm {
   class EndPathStatusInserter;
   class PreallocationConfiguration;
   class WaitingTaskHolder;
+  class PathsAndConsumesOfModulesBase;
 
   namespace service {
     class TriggerNamesService;
@@ -258,6 +259,11 @@ namespace edm {
 
     StreamContext const& context() const { return streamContext_; }
 
+    /// Use the data dependencies between modules to decide the order in which
+    /// the trigger paths are started. Only has an effect if the 'prioritizeCriticalPath'
+    /// option was set.
+    void initializeCriticalPathPriorities(PathsAndConsumesOfModulesBase const&);
+
   private:
     //Sentry class to only send a signal if an
     // exception occurs. An exception is identified
@@ -318,6 +324,8 @@ namespace edm {
 
     void addToAllWorkers(Worker* w);
 
+    void updateCriticalPathPriorities();
+
     void resetEarlyDelete();
     void initializeEarlyDelete(ModuleRegistry& modReg,
                                edm::ParameterSet const& opts,
@@ -369,6 +377,14 @@ namespace edm {
     StreamContext streamContext_;
     volatile bool endpathsAreActive_;
     std::atomic<bool> skippingEvent_;
+
+    //Order in which the trigger paths are started. The TBB task spawned
+    // last is the first to be run so the most important Path is last.
+    std::vector<unsigned int> trigPathLaunchOrder_;
+    //For each entry in allWorkers(), the indices of the workers whose products it consumes
+    std::vector<std::vector<unsigned int>> workerToConsumedWorkers_;
+    unsigned int eventsUntilPriorityUpdate_;
+    bool prioritizeCriticalPath_;
   };
 
   void inline StreamSchedule::reportSkipped(EventPrincipal const& ep) const {
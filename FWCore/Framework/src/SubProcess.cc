@@ -230,6 +230,7 @@ namespace edm {
     //NOTE: this may throw
     checkForModuleDependencyCorrectness(pathsAndConsumesOfModules_, false);
     actReg_->preBeginJobSignal_(pathsAndConsumesOfModules_, processContext_);
+    schedule_->initializeCriticalPathPriorities(pathsAndConsumesOfModules_);
     schedule_->beginJob(*preg_, esp_->recordsToProxyIndices());
     for_all(subProcesses_, [](auto& subProcess) { subProcess.doBeginJob(); });
   }
@@ -95,7 +95,9 @@ namespace edm {
         actReg_(),
         earlyDeleteHelper_(nullptr),
         workStarted_(false),
-        ranAcquireWithoutException_(false) {}
+        ranAcquireWithoutException_(false),
+        timeEventProcessing_(false),
+        eventRealTimeInNanoseconds_(0) {}
 
   Worker::~Worker() {}
 
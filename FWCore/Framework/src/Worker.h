@@ -54,6 +54,7 @@ the worker is reset().
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -220,6 +221,7 @@ namespace edm {
       timesPassed_.store(0, std::memory_order_release);
       timesFailed_.store(0, std::memory_order_release);
       timesExcept_.store(0, std::memory_order_release);
+      eventRealTimeInNanoseconds_.store(0, std::memory_order_release);
     }
 
     void addedToPath() { ++numberOfPathsOn_; }
@@ -233,6 +235,18 @@ namespace edm {
 
     int timesPass() const { return timesPassed(); }  // for backward compatibility only - to be removed soon
 
+    ///When enabled, the wall clock time spent in the module's event method is accumulated
+    /// so the scheduler can estimate the cost of running the module.
+    void setTimeEventProcessing(bool iTime) { timeEventProcessing_ = iTime; }
+    ///average wall clock time in nanoseconds per event the module was run, 0 if unknown
+    double averageEventRealTime() const {
+      auto const nRun = timesRun();
+      if (nRun == 0) {
+        return 0.;
+      }
+      return static_cast<double>(eventRealTimeInNanoseconds_.load(std::memory_order_acquire)) / nRun;
+    }
+
     virtual bool hasAccumulator() const = 0;
 
   protected:
@@ -618,6 +632,8 @@ namespace edm {
     edm::WaitingTaskList waitingTasks_;
     std::atomic<bool> workStarted_;
     bool ranAcquireWithoutException_;
+    bool timeEventProcessing_;
+    std::atomic<unsigned long long> eventRealTimeInNanoseconds_;
   };
 
   namespace {
@@ -1095,6 +1111,11 @@ namespace edm {
     if (T::isEvent_) {
       timesRun_.fetch_add(1, std::memory_order_relaxed);
     }
+    bool const timeThisCall = T::isEvent_ and timeEventProcessing_;
+    std::chrono::steady_clock::time_point startTime;
+    if (timeThisCall) {
+      startTime = std::chrono::steady_clock::now();
+    }
 
     bool rc = true;
     try {
@@ -1118,6 +1139,11 @@ namespace edm {
         rc = setPassed<T::isEvent_>();
       }
     }
+    if (timeThisCall) {
+      auto const elapsed =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+      eventRealTimeInNanoseconds_.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
 
     return rc;
   }
@@ -10,6 +10,7 @@ F2=${LOCAL_TEST_DIR}/test_deepCall_unscheduled_fail_cfg.py
 F3=${LOCAL_TEST_DIR}/test_offPath_unscheduled_cfg.py
 F4=${LOCAL_TEST_DIR}/test_onPath_unscheduled_cfg.py
 F5=${LOCAL_TEST_DIR}/test_onPath_wrongOrder_unscheduled_fail_cfg.py
+F6=${LOCAL_TEST_DIR}/test_prioritizeCriticalPath_cfg.py
 
 (cmsRun $F1 ) > test_deepCall_unscheduled.log || die "Failure using $F1" $?
 diff ${LOCAL_TEST_DIR}/unit_test_outputs/test_deepCall_unscheduled.log test_deepCall_unscheduled.log || die "comparing test_deepCall_unscheduled.log" $?
@@ -23,5 +24,15 @@ diff ${LOCAL_TEST_DIR}/unit_test_outputs/test_onPath_unscheduled.log test_onPath
 
 !(cmsRun $F5 ) || die "Failure using $F5" $?
 
+(cmsRun $F6 ) > test_prioritizeCriticalPath.log || die "Failure using $F6" $?
+# in every event of every stream p1 must be started before p2, which has the long chain
+grep "starting: processing" test_prioritizeCriticalPath.log | \
+  awk '/processing event/ { split($0, a, "stream = "); split(a[2], b, " "); started[b[1]] = "" }
+       /processing path/ { split($0, a, "stream = "); p = $0; sub(/.*path \047/, "", p); sub(/\047.*/, "", p)
+                           if (p == "p2") { n++; if (started[a[2]] != "p1") bad++ }
+                           started[a[2]] = started[a[2]] p }
+       END { if (bad > 0 || n != 500) { print "p2 started before p1 in " bad + 0 " of " n + 0 " events"; exit 1 } }' || \
+  die "Paths not started in critical path order in test_prioritizeCriticalPath.log" $?
+
 popd
 
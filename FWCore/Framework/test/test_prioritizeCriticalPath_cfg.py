@@ -0,0 +1,61 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("Test")
+
+process.source = cms.Source("EmptySource")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(500)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(2),
+    prioritizeCriticalPath = cms.untracked.bool(True)
+)
+
+# run_unscheduled.sh checks in the Tracer output that, in every event, the Path with the long
+# chain is started after the other one, so that it is the first to run. Without the option the
+# paths are started in the reverse order of the configuration.
+process.Tracer = cms.Service('Tracer')
+
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations   = cms.untracked.vstring('cout',
+                                           'cerr'
+    ),
+    categories = cms.untracked.vstring(
+        'Tracer'
+    ),
+    cout = cms.untracked.PSet(
+        default = cms.untracked.PSet (
+            limit = cms.untracked.int32(0)
+        ),
+        Tracer = cms.untracked.PSet(
+            limit=cms.untracked.int32(100000000)
+        )
+    )
+)
+
+# a long chain of dependent modules which is only reached through the last Path
+process.busy1 = cms.EDProducer("BusyWaitIntProducer", ivalue = cms.int32(1), iterations = cms.uint32(20000))
+process.busy2 = cms.EDProducer("BusyWaitIntProducer", ivalue = cms.int32(2), iterations = cms.uint32(20000))
+process.i1 = cms.EDProducer("IntProducer", ivalue = cms.int32(1))
+process.i2 = cms.EDProducer("IntProducer", ivalue = cms.int32(2))
+process.chain1 = cms.EDProducer("AddIntsProducer", labels = cms.vstring("i1", "busy1"))
+process.chain2 = cms.EDProducer("AddIntsProducer", labels = cms.vstring("chain1", "busy2"))
+process.chain3 = cms.EDProducer("AddIntsProducer", labels = cms.vstring("chain2", "i2"))
+
+process.i3 = cms.EDProducer("IntProducer", ivalue = cms.int32(3))
+
+process.testShort = cms.EDAnalyzer("IntTestAnalyzer",
+    moduleLabel = cms.untracked.string("i3"),
+    valueMustMatch = cms.untracked.int32(3)
+)
+process.testLong = cms.EDAnalyzer("IntConsumingAnalyzer",
+    getFromModule = cms.untracked.InputTag("chain3")
+)
+
+process.t = cms.Task(process.busy1, process.busy2, process.i1, process.i2, process.chain1, process.chain2, process.chain3)
+
+process.p1 = cms.Path(process.i3 + process.testShort)
+process.p2 = cms.Path(process.testLong, process.t)
@@ -27,6 +27,10 @@ namespace edm {
     description.addUntracked<bool>("throwIfIllegalParameter", true)
         ->setComment("Set false to disable exception throws when configuration validation detects illegal parameters");
     description.addUntracked<bool>("printDependencies", false)->setComment("Print data dependencies between modules");
+    description.addUntracked<bool>("prioritizeCriticalPath", false)
+        ->setComment(
+            "Set true to start first the paths whose modules, together with the modules they depend upon, are "
+            "expected to take the longest to finish based on their measured processing times");
 
     // No default for this one because the parameter value is
     // actually used in the main function in cmsRun.cpp before
@@ -9,6 +9,7 @@
 #include "DataFormats/Provenance/interface/BranchDescription.h"
 #include "DataFormats/Provenance/interface/IndexIntoFile.h"
 #include "DataFormats/Provenance/interface/ProductRegistry.h"
+#include "DataFormats/Provenance/interface/ProductResolverIndexHelper.h"
 #include "DataFormats/Provenance/interface/ThinnedAssociationsHelper.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/Framework/interface/FileBlock.h"
@@ -20,10 +21,16 @@
 #include "FWCore/Framework/interface/RunPrincipal.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/ServiceRegistry/interface/ConsumesInfo.h"
+#include "FWCore/ServiceRegistry/interface/PathsAndConsumesOfModulesBase.h"
+#include "FWCore/ServiceRegistry/interface/StreamContext.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/Utilities/interface/InputType.h"
 
+#include "TTreeCacheUnzip.h"
+
 #include <set>
 
 namespace edm {
@@ -60,6 +67,15 @@ namespace edm {
             << primary.id() << " has inconsistent RunAuxiliary data in the primary and secondary file\n";
       }
     }
+
+    bool enableParallelUnzip(bool iEnable) {
+      // Must be called before any file is opened, TTreeCaches created
+      // afterwards will decompress their baskets in parallel.
+      if (iEnable) {
+        TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kEnable);
+      }
+      return iEnable;
+    }
   }  // namespace
 
   PoolSource::PoolSource(ParameterSet const& pset, InputSourceDescription const& desc)
@@ -82,6 +98,7 @@ namespace edm {
         dropDescendants_(pset.getUntrackedParameter<bool>("dropDescendantsOfDroppedBranches")),
         labelRawDataLikeMC_(pset.getUntrackedParameter<bool>("labelRawDataLikeMC")),
         delayReadingEventProducts_(pset.getUntrackedParameter<bool>("delayReadingEventProducts")),
+        prefetchConsumedProducts_(enableParallelUnzip(pset.getUntrackedParameter<bool>("prefetchConsumedProducts"))),
         runHelper_(makeRunHelper(pset)),
         resourceSharedWithDelayedReaderPtr_(),
         // Note: primaryFileSequence_ and secondaryFileSequence_ need to be initialized last, because they use data members
@@ -93,6 +110,11 @@ namespace edm {
     resourceSharedWithDelayedReaderPtr_ = std::make_unique<SharedResourcesAcquirer>(std::move(resources.first));
     mutexSharedWithDelayedReader_ = resources.second;
 
+    if (prefetchConsumedProducts_) {
+      desc.actReg_->watchPreBeginJob(this, &PoolSource::setBranchesToPrefetch);
+      desc.actReg_->watchPostEvent(this, &PoolSource::releasePrefetchedProducts);
+    }
+
     if (secondaryCatalog_.empty() && pset.getUntrackedParameter<bool>("needSecondaryFileNames", false)) {
       throw Exception(errors::Configuration, "PoolSource") << "'secondaryFileNames' must be specified\n";
     }
@@ -265,6 +287,52 @@ namespace edm {
     return std::make_pair(resourceSharedWithDelayedReaderPtr_.get(), mutexSharedWithDelayedReader_.get());
   }
 
+  void PoolSource::setBranchesToPrefetch(PathsAndConsumesOfModulesBase const& pathsAndConsumes,
+                                         ProcessContext const&) {
+    // The products the modules may get, looked up as the Principal does: by type, and also by
+    // label and instance unless all the products of the type are requested (consumesMany). For a
+    // View the type is the element type, which the lookup matches with the containers and their
+    // base classes. Only the entries of a given process are kept, the lookup also has entries
+    // without process name which stand for the most recent process.
+    auto const& lookup = *productRegistry()->productLookup(InEvent);
+    std::set<ProductResolverIndex> consumed;
+    for (auto const* module : pathsAndConsumes.allModules()) {
+      for (auto const& info : pathsAndConsumes.consumesInfo(module->id())) {
+        if (info.branchType() != InEvent) {
+          continue;
+        }
+        auto matches = info.label().empty() ? lookup.relatedIndexes(info.kindOfType(), info.type())
+                                            : lookup.relatedIndexes(info.kindOfType(),
+                                                                    info.type(),
+                                                                    info.label().c_str(),
+                                                                    info.instance().c_str());
+        for (unsigned int i = 0; i < matches.numberOfMatches(); ++i) {
+          if (matches.isFullyResolved(i) and (info.process().empty() or info.process() == matches.processName(i))) {
+            consumed.insert(matches.index(i));
+          }
+        }
+      }
+    }
+
+    std::vector<BranchID> branchIDs;
+    for (auto const& product : productRegistry()->productList()) {
+      BranchDescription const& desc = product.second;
+      if (desc.branchType() != InEvent or desc.produced() or desc.dropped()) {
+        continue;
+      }
+      if (consumed.count(productRegistry()->indexFrom(desc.branchID())) != 0) {
+        branchIDs.push_back(desc.branchID());
+      }
+    }
+    primaryFileSequence_->setBranchesToPrefetch(branchIDs);
+  }
+
+  // The products prefetched for an event which no module requested are dropped when the event
+  // is done, rather than kept until the next event of the stream.
+  void PoolSource::releasePrefetchedProducts(StreamContext const& streamContext) {
+    primaryFileSequence_->releasePrefetchedProducts(streamContext.streamID().value());
+  }
+
   // Rewind to before the first event that was read.
   void PoolSource::rewind_() { primaryFileSequence_->rewind_(); }
 
@@ -302,6 +370,11 @@ namespace edm {
         ->setComment(
             "If True: do not read a data product from the file until it is requested. If False: all event data "
             "products are read upfront.");
+    desc.addUntracked<bool>("prefetchConsumedProducts", false)
+        ->setComment(
+            "If True: when the first event data product is requested, all event data products consumed by any module "
+            "are read together and the baskets are decompressed in parallel. Only applies if "
+            "'delayReadingEventProducts' is True.");
     ProductSelectorRules::fillDescription(desc, "inputCommands");
     InputSource::fillDescription(desc);
     RootPrimaryFileSequence::fillDescription(desc);
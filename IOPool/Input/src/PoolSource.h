@@ -25,6 +25,9 @@ namespace edm {
 
   class ConfigurationDescriptions;
   class FileCatalogItem;
+  class PathsAndConsumesOfModulesBase;
+  class ProcessContext;
+  class StreamContext;
   class RootPrimaryFileSequence;
   class RootSecondaryFileSequence;
   class RunHelperBase;
@@ -70,6 +73,9 @@ namespace edm {
 
     std::pair<SharedResourcesAcquirer*, std::recursive_mutex*> resourceSharedWithDelayedReader_() override;
 
+    void setBranchesToPrefetch(PathsAndConsumesOfModulesBase const& pathsAndConsumes, ProcessContext const&);
+    void releasePrefetchedProducts(StreamContext const& streamContext);
+
     RootServiceChecker rootServiceChecker_;
     InputFileCatalog catalog_;
     InputFileCatalog secondaryCatalog_;
@@ -86,6 +92,7 @@ namespace edm {
     bool dropDescendants_;
     bool labelRawDataLikeMC_;
     bool delayReadingEventProducts_;
+    bool prefetchConsumedProducts_;
 
     edm::propagate_const<std::unique_ptr<RunHelperBase>> runHelper_;
     std::unique_ptr<SharedResourcesAcquirer>
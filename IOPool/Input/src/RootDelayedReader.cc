@@ -17,6 +17,7 @@
 #include "TClass.h"
 
 #include <cassert>
+#include <mutex>
 
 namespace edm {
 
@@ -41,6 +42,14 @@ namespace edm {
     return std::make_pair(resourceAcquirer_.get(), mutex_.get());
   }
 
+  void RootDelayedReader::setBranchesToPrefetch(std::vector<BranchID> iBranchIDs, unsigned int iNumberOfIndexes) {
+    branchesToPrefetch_ = std::move(iBranchIDs);
+    prefetchedProducts_.clear();
+    if (not branchesToPrefetch_.empty()) {
+      prefetchedProducts_.resize(iNumberOfIndexes);
+    }
+  }
+
   std::unique_ptr<WrapperBase> RootDelayedReader::getProduct_(BranchID const& k, EDProductGetter const* ep) {
     if (lastException_) {
       std::rethrow_exception(lastException_);
@@ -62,20 +71,76 @@ namespace edm {
       }
     }
 
+    if (not prefetchedProducts_.empty() and tree_.branchType() == InEvent) {
+      unsigned int index = ep->transitionIndex();
+      assert(index < prefetchedProducts_.size());
+      auto& prefetched = prefetchedProducts_[index];
+      EntryNumber entry = tree_.entryNumberForIndex(index);
+      if (prefetched.entry_ != entry or prefetched.getter_ != ep) {
+        prefetchProducts(prefetched, entry, ep);
+      }
+      auto itFound = prefetched.products_.find(k.id());
+      if (itFound != prefetched.products_.end()) {
+        auto edp = std::move(itFound->second);
+        prefetched.products_.erase(itFound);
+        ++numberOfRequestedPrefetchedProducts_;
+        return edp;
+      }
+    }
+    return readProduct(*branchInfo, ep);
+  }
+
+  void RootDelayedReader::prefetchProducts(PrefetchedProducts& prefetched,
+                                           EntryNumber entry,
+                                           EDProductGetter const* ep) {
+    prefetched.products_.clear();
+    prefetched.entry_ = -1;
+    prefetched.getter_ = nullptr;
+    // branchesToPrefetch_ is ordered as the branches are in the TTree so the TTreeCache
+    // can satisfy all the reads of one cluster with a single vectored read.
+    for (auto const& id : branchesToPrefetch_) {
+      auto branchInfo = getBranchInfo(id);
+      if (branchInfo and branchInfo->productBranch_) {
+        try {
+          prefetched.products_.emplace(id.id(), readProduct(*branchInfo, ep));
+          ++numberOfPrefetchedProducts_;
+        } catch (...) {
+          // The failure is not reported for the product being requested, which may come from
+          // another branch. The product is read again if it is requested, which then throws.
+          lastException_ = std::exception_ptr();
+        }
+      }
+    }
+    prefetched.entry_ = entry;
+    prefetched.getter_ = ep;
+  }
+
+  void RootDelayedReader::releasePrefetchedProducts(unsigned int iIndex) {
+    if (iIndex < prefetchedProducts_.size()) {
+      std::lock_guard<std::recursive_mutex> guard(*mutex_);
+      auto& prefetched = prefetchedProducts_[iIndex];
+      prefetched.products_.clear();
+      prefetched.entry_ = -1;
+      prefetched.getter_ = nullptr;
+    }
+  }
+
+  std::unique_ptr<WrapperBase> RootDelayedReader::readProduct(BranchInfo const& branchInfo, EDProductGetter const* ep) {
+    TBranch* br = branchInfo.productBranch_;
     setRefCoreStreamer(ep);
     //make code exception safe
     std::shared_ptr<void> refCoreStreamerGuard(nullptr, [](void*) {
       setRefCoreStreamer(false);
       ;
     });
-    TClass* cp = branchInfo->classCache_;
+    TClass* cp = branchInfo.classCache_;
     if (nullptr == cp) {
-      branchInfo->classCache_ = TClass::GetClass(branchInfo->branchDescription_.wrappedName().c_str());
-      cp = branchInfo->classCache_;
-      branchInfo->offsetToWrapperBase_ = cp->GetBaseClassOffset(wrapperBaseTClass_);
+      branchInfo.classCache_ = TClass::GetClass(branchInfo.branchDescription_.wrappedName().c_str());
+      cp = branchInfo.classCache_;
+      branchInfo.offsetToWrapperBase_ = cp->GetBaseClassOffset(wrapperBaseTClass_);
     }
     void* p = cp->New();
-    std::unique_ptr<WrapperBase> edp = getWrapperBasePtr(p, branchInfo->offsetToWrapperBase_);
+    std::unique_ptr<WrapperBase> edp = getWrapperBasePtr(p, branchInfo.offsetToWrapperBase_);
     br->SetAddress(&p);
     try {
       //Run and Lumi only have 1 entry number, which is index 0
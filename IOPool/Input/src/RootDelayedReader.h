@@ -17,6 +17,8 @@ RootDelayedReader.h // used by ROOT input sources
 #include <memory>
 #include <string>
 #include <exception>
+#include <unordered_map>
+#include <vector>
 
 class TClass;
 namespace edm {
@@ -57,8 +59,25 @@ namespace edm {
       postEventReadFromSourceSignal_ = postEventReadSource;
     }
 
+    // When the first product of an event is requested, all the products in iBranchIDs
+    // are read from the file in that order and held until they are requested.
+    void setBranchesToPrefetch(std::vector<BranchID> iBranchIDs, unsigned int iNumberOfIndexes);
+    // Drops the products prefetched for the event of iIndex which were not requested.
+    void releasePrefetchedProducts(unsigned int iIndex);
+    // The numbers of products prefetched from the file and of those which were requested.
+    unsigned long long numberOfPrefetchedProducts() const { return numberOfPrefetchedProducts_; }
+    unsigned long long numberOfRequestedPrefetchedProducts() const { return numberOfRequestedPrefetchedProducts_; }
+
   private:
+    struct PrefetchedProducts {
+      EntryNumber entry_ = -1;
+      EDProductGetter const* getter_ = nullptr;
+      std::unordered_map<unsigned int, std::unique_ptr<WrapperBase>> products_;
+    };
+
     std::unique_ptr<WrapperBase> getProduct_(BranchID const& k, EDProductGetter const* ep) override;
+    std::unique_ptr<WrapperBase> readProduct(BranchInfo const& branchInfo, EDProductGetter const* ep);
+    void prefetchProducts(PrefetchedProducts& prefetched, EntryNumber entry, EDProductGetter const* ep);
     void mergeReaders_(DelayedReader* other) override { nextReader_ = other; }
     void reset_() override { nextReader_ = nullptr; }
     std::pair<SharedResourcesAcquirer*, std::recursive_mutex*> sharedResources_() const override;
@@ -75,6 +94,11 @@ namespace edm {
     std::shared_ptr<std::recursive_mutex> mutex_;
     InputType inputType_;
     edm::propagate_const<TClass*> wrapperBaseTClass_;
+    std::vector<BranchID> branchesToPrefetch_;
+    // One per index (i.e. per stream). Access is serialized by mutex_.
+    std::vector<PrefetchedProducts> prefetchedProducts_;
+    unsigned long long numberOfPrefetchedProducts_ = 0;
+    unsigned long long numberOfRequestedPrefetchedProducts_ = 0;
 
     signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadFromSourceSignal_ =
         nullptr;
@@ -216,6 +216,8 @@ namespace edm {
     RootTree const& eventTree() const { return eventTree_; }
     RootTree const& lumiTree() const { return lumiTree_; }
     RootTree const& runTree() const { return runTree_; }
+    void setBranchesToPrefetch(std::vector<BranchID> const& branchIDs) { eventTree_.setBranchesToPrefetch(branchIDs); }
+    void releasePrefetchedProducts(unsigned int index) { eventTree_.releasePrefetchedProducts(index); }
     FileFormatVersion fileFormatVersion() const { return fileFormatVersion_; }
     int whyNotFastClonable() const { return whyNotFastClonable_; }
     std::array<bool, NumBranchTypes> const& hasNewlyDroppedBranch() const { return hasNewlyDroppedBranch_; }
@@ -12,6 +12,7 @@
 #include "FWCore/Catalog/interface/InputFileCatalog.h"
 #include "FWCore/Catalog/interface/SiteLocalConfig.h"
 #include "FWCore/Framework/interface/FileBlock.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
@@ -91,6 +92,13 @@ namespace edm {
     // close the currently open file, if any, and delete the RootFile object.
     if (rootFile()) {
       auto sentry = std::make_unique<InputSource::FileCloseSentry>(input_, lfn(), usedFallback());
+      RootTree const& eventTree = rootFile()->eventTree();
+      if (eventTree.numberOfPrefetchedProducts() != 0) {
+        LogInfo("PrefetchConsumedProducts")
+            << "Input file " << fileName() << ": " << eventTree.numberOfPrefetchedProducts()
+            << " event products prefetched, " << eventTree.numberOfRequestedPrefetchedProducts()
+            << " of them requested\n";
+      }
       rootFile()->close();
       if (duplicateChecker_)
         duplicateChecker_->inputFileClosed();
@@ -109,35 +117,53 @@ namespace edm {
 
   RootPrimaryFileSequence::RootFileSharedPtr RootPrimaryFileSequence::makeRootFile(std::shared_ptr<InputFile> filePtr) {
     size_t currentIndexIntoFile = sequenceNumberOfFile();
-    return std::make_shared<RootFile>(fileName(),
-                                      input_.processConfiguration(),
-                                      logicalFileName(),
-                                      filePtr,
-                                      eventSkipperByID(),
-                                      initialNumberOfEventsToSkip_ != 0,
-                                      remainingEvents(),
-                                      remainingLuminosityBlocks(),
-                                      input_.nStreams(),
-                                      treeCacheSize_,
-                                      input_.treeMaxVirtualSize(),
-                                      input_.processingMode(),
-                                      input_.runHelper(),
-                                      noEventSort_,
-                                      input_.productSelectorRules(),
-                                      InputType::Primary,
-                                      input_.branchIDListHelper(),
-                                      input_.thinnedAssociationsHelper(),
-                                      nullptr,  // associationsFromSecondary
-                                      duplicateChecker(),
-                                      input_.dropDescendants(),
-                                      input_.processHistoryRegistryForUpdate(),
-                                      indexesIntoFiles(),
-                                      currentIndexIntoFile,
-                                      orderedProcessHistoryIDs_,
-                                      input_.bypassVersionCheck(),
-                                      input_.labelRawDataLikeMC(),
-                                      usingGoToEvent_,
-                                      enablePrefetching_);
+    auto file = std::make_shared<RootFile>(fileName(),
+                                           input_.processConfiguration(),
+                                           logicalFileName(),
+                                           filePtr,
+                                           eventSkipperByID(),
+                                           initialNumberOfEventsToSkip_ != 0,
+                                           remainingEvents(),
+                                           remainingLuminosityBlocks(),
+                                           input_.nStreams(),
+                                           treeCacheSize_,
+                                           input_.treeMaxVirtualSize(),
+                                           input_.processingMode(),
+                                           input_.runHelper(),
+                                           noEventSort_,
+                                           input_.productSelectorRules(),
+                                           InputType::Primary,
+                                           input_.branchIDListHelper(),
+                                           input_.thinnedAssociationsHelper(),
+                                           nullptr,  // associationsFromSecondary
+                                           duplicateChecker(),
+                                           input_.dropDescendants(),
+                                           input_.processHistoryRegistryForUpdate(),
+                                           indexesIntoFiles(),
+                                           currentIndexIntoFile,
+                                           orderedProcessHistoryIDs_,
+                                           input_.bypassVersionCheck(),
+                                           input_.labelRawDataLikeMC(),
+                                           usingGoToEvent_,
+                                           enablePrefetching_);
+    if (not branchesToPrefetch_.empty()) {
+      file->setBranchesToPrefetch(branchesToPrefetch_);
+    }
+    return file;
+  }
+
+  void RootPrimaryFileSequence::setBranchesToPrefetch(std::vector<BranchID> const& branchIDs) {
+    branchesToPrefetch_ = branchIDs;
+    // The first file is opened before the job begins.
+    if (rootFile()) {
+      rootFile()->setBranchesToPrefetch(branchesToPrefetch_);
+    }
+  }
+
+  void RootPrimaryFileSequence::releasePrefetchedProducts(unsigned int streamIndex) {
+    if (rootFile()) {
+      rootFile()->releasePrefetchedProducts(streamIndex);
+    }
   }
 
   bool RootPrimaryFileSequence::nextFile() {
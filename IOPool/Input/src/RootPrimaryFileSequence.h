@@ -46,6 +46,8 @@ namespace edm {
     bool skipEvents(int offset);
     bool goToEvent(EventID const& eventID);
     void rewind_();
+    void setBranchesToPrefetch(std::vector<BranchID> const& branchIDs);
+    void releasePrefetchedProducts(unsigned int streamIndex);
     static void fillDescription(ParameterSetDescription& desc);
     ProcessingController::ForwardState forwardState() const;
     ProcessingController::ReverseState reverseState() const;
@@ -77,6 +79,7 @@ namespace edm {
     edm::propagate_const<std::shared_ptr<DuplicateChecker>> duplicateChecker_;
     bool usingGoToEvent_;
     bool enablePrefetching_;
+    std::vector<BranchID> branchesToPrefetch_;
   };  // class RootPrimaryFileSequence
 }  // namespace edm
 #endif
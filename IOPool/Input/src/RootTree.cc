@@ -8,6 +8,7 @@
 #include "TTreeIndex.h"
 #include "TTreeCache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -485,6 +486,38 @@ namespace edm {
     }
   }
 
+  void RootTree::setBranchesToPrefetch(std::vector<BranchID> const& branchIDs) {
+    // Keep only the branches present in this file, in the order they appear in the TTree.
+    TObjArray* treeBranches = tree_->GetListOfBranches();
+    std::vector<std::pair<Int_t, BranchID>> ordered;
+    ordered.reserve(branchIDs.size());
+    for (auto const& id : branchIDs) {
+      auto info = branches_.find(id);
+      if (info != nullptr and info->productBranch_ != nullptr) {
+        ordered.emplace_back(treeBranches->IndexOf(info->productBranch_), id);
+      }
+    }
+    std::sort(ordered.begin(), ordered.end());
+    std::vector<BranchID> toPrefetch;
+    toPrefetch.reserve(ordered.size());
+    for (auto const& item : ordered) {
+      toPrefetch.push_back(item.second);
+    }
+    rootDelayedReader_->setBranchesToPrefetch(std::move(toPrefetch), entryNumberForIndex_->size());
+  }
+
+  void RootTree::releasePrefetchedProducts(unsigned int index) {
+    rootDelayedReader_->releasePrefetchedProducts(index);
+  }
+
+  unsigned long long RootTree::numberOfPrefetchedProducts() const {
+    return rootDelayedReader_->numberOfPrefetchedProducts();
+  }
+
+  unsigned long long RootTree::numberOfRequestedPrefetchedProducts() const {
+    return rootDelayedReader_->numberOfRequestedPrefetchedProducts();
+  }
+
   void RootTree::setSignals(
       signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadSource,
       signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadSource) {
@@ -190,6 +190,10 @@ namespace edm {
     inline TTreeCache* selectCache(TBranch* branch, EntryNumber entryNumber) const;
     void trainCache(char const* branchNames);
     void resetTraining() { trainNow_ = true; }
+    void setBranchesToPrefetch(std::vector<BranchID> const& branchIDs);
+    void releasePrefetchedProducts(unsigned int index);
+    unsigned long long numberOfPrefetchedProducts() const;
+    unsigned long long numberOfRequestedPrefetchedProducts() const;
 
     BranchType branchType() const { return branchType_; }
 
@@ -11,6 +11,9 @@ cp PoolInputTest.root PoolInputOther.root
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputTest_cfg.py || die 'Failure using PoolInputTest_cfg.py' $?
 cmsRun  ${LOCAL_TEST_DIR}/PoolInputTest_noDelay_cfg.py >& ${LOCAL_TMP_DIR}/PoolInputTest_noDelay_cfg.txt || die 'Failure using PoolInputTest_noDelay_cfg.py' $?
 grep 'event delayed read from source' ${LOCAL_TMP_DIR}/PoolInputTest_noDelay_cfg.txt && die 'Failure in PoolInputTest_noDelay_cfg.py, found delay reads from source' 1
+cmsRun ${LOCAL_TEST_DIR}/PoolInputTest_prefetch_cfg.py >& ${LOCAL_TMP_DIR}/PoolInputTest_prefetch_cfg.txt || die 'Failure using PoolInputTest_prefetch_cfg.py' $?
+# the Thing products of each of the 2 input files are prefetched, and all requested by OtherThing
+test `grep -c 'Input file .*: \([1-9][0-9]*\) event products prefetched, \1 of them requested' ${LOCAL_TMP_DIR}/PoolInputTest_prefetch_cfg.txt` = 2 || die 'Failure in PoolInputTest_prefetch_cfg.py, products not prefetched' 1
 
 cmsRun ${LOCAL_TEST_DIR}/PrePool2FileInputTest_cfg.py || die 'Failure using PrePool2FileInputTest_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/Pool2FileInputTest_cfg.py || die 'Failure using Pool2FileInputTest_cfg.py' $?
@@ -0,0 +1,127 @@
+#ifndef IOPool_Streamer_GlobalStreamerOutputModule_h
+#define IOPool_Streamer_GlobalStreamerOutputModule_h
+
+#include "DataFormats/Common/interface/TriggerResults.h"
+#include "FWCore/Framework/interface/EventForOutput.h"
+#include "FWCore/Framework/interface/global/OutputModule.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/propagate_const.h"
+#include "FWCore/Utilities/interface/thread_safety_macros.h"
+#include "IOPool/Streamer/interface/EventMsgBuilder.h"
+#include "IOPool/Streamer/interface/InitMsgBuilder.h"
+#include "IOPool/Streamer/interface/StreamerOutputModuleCommon.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace edm {
+  template <typename Consumer>
+  class GlobalStreamerOutputModule : public global::OutputModule<RunCache<bool>> {
+    /** Same Consumer interface as StreamerOutputModule.
+
+        Events of different streams are serialized and compressed concurrently, each stream
+        using its own SerializeDataBuffer. Only handing the finished event message to the
+        Consumer is serialized, so events are written in the order their serialization ends.
+        The INIT message is written once, at the beginning of the first run.
+  **/
+
+  public:
+    explicit GlobalStreamerOutputModule(ParameterSet const& ps);
+    ~GlobalStreamerOutputModule() override;
+    static void fillDescriptions(ConfigurationDescriptions& descriptions);
+
+  private:
+    void preallocStreams(unsigned int nStreams) override;
+    void endJob() override;
+    void write(EventForOutput const& e) override;
+    void writeLuminosityBlock(LuminosityBlockForOutput const&) override {}
+    void writeRun(RunForOutput const&) override {}
+
+    std::shared_ptr<bool> globalBeginRun(RunForOutput const&) const override;
+    void globalEndRun(RunForOutput const&) const override {}
+
+  private:
+    edm::EDGetTokenT<edm::TriggerResults> trToken_;
+    //serializeRegistry is only called while holding outputMutex_ and before any event is serialized
+    CMS_THREAD_SAFE mutable StreamerOutputModuleCommon common_;
+    std::vector<edm::propagate_const<std::unique_ptr<SerializeDataBuffer>>> streamBuffers_;
+
+    mutable std::mutex outputMutex_;
+    CMS_THREAD_GUARD(outputMutex_) mutable bool headerWritten_;
+    CMS_THREAD_GUARD(outputMutex_) mutable edm::propagate_const<std::unique_ptr<Consumer>> c_;
+  };  //end-of-class-def
+
+  template <typename Consumer>
+  GlobalStreamerOutputModule<Consumer>::GlobalStreamerOutputModule(ParameterSet const& ps)
+      : global::OutputModuleBase(ps),
+        global::OutputModule<RunCache<bool>>(ps),
+        trToken_(consumes<edm::TriggerResults>(edm::InputTag("TriggerResults"))),
+        common_(ps, &keptProducts()[InEvent]),
+        headerWritten_(false),
+        c_(new Consumer(ps)) {}
+
+  template <typename Consumer>
+  GlobalStreamerOutputModule<Consumer>::~GlobalStreamerOutputModule() {}
+
+  template <typename Consumer>
+  void GlobalStreamerOutputModule<Consumer>::preallocStreams(unsigned int nStreams) {
+    streamBuffers_.reserve(nStreams);
+    for (unsigned int i = 0; i < nStreams; ++i) {
+      streamBuffers_.emplace_back(std::make_unique<SerializeDataBuffer>());
+    }
+  }
+
+  template <typename Consumer>
+  void GlobalStreamerOutputModule<Consumer>::endJob() {
+    std::lock_guard<std::mutex> guard(outputMutex_);
+    c_->stop();
+  }
+
+  template <typename Consumer>
+  std::shared_ptr<bool> GlobalStreamerOutputModule<Consumer>::globalBeginRun(RunForOutput const&) const {
+    std::lock_guard<std::mutex> guard(outputMutex_);
+    if (not headerWritten_) {
+      c_->start();
+
+      SerializeDataBuffer headerBuffer;
+      std::unique_ptr<InitMsgBuilder> init_message =
+          common_.serializeRegistry(headerBuffer,
+                                    *branchIDLists(),
+                                    *thinnedAssociationsHelper(),
+                                    processName(),
+                                    description().moduleLabel(),
+                                    moduleDescription().mainParameterSetID());
+      c_->doOutputHeader(*init_message);
+      headerWritten_ = true;
+    }
+    return std::make_shared<bool>(headerWritten_);
+  }
+
+  //______________________________________________________________________________
+  template <typename Consumer>
+  void GlobalStreamerOutputModule<Consumer>::write(EventForOutput const& e) {
+    Handle<TriggerResults> triggerResults;
+    e.getByToken<TriggerResults>(trToken_, triggerResults);
+
+    //each stream only ever touches its own buffer so the expensive part runs concurrently
+    SerializeDataBuffer& sbuf = *streamBuffers_[e.streamID().value()];
+    std::unique_ptr<EventMsgBuilder> msg = common_.serializeEvent(sbuf, e, triggerResults, selectorConfig());
+
+    std::lock_guard<std::mutex> guard(outputMutex_);
+    c_->doOutputEvent(*msg);  // You can't use msg in GlobalStreamerOutputModule after this point
+  }
+
+  template <typename Consumer>
+  void GlobalStreamerOutputModule<Consumer>::fillDescriptions(ConfigurationDescriptions& descriptions) {
+    ParameterSetDescription desc;
+    StreamerOutputModuleCommon::fillDescription(desc);
+    global::OutputModuleBase::fillDescription(desc);
+    Consumer::fillDescription(desc);
+    descriptions.add("globalStreamerOutput", desc);
+  }
+}  // namespace edm
+
+#endif
@@ -17,13 +17,16 @@ namespace edm {
   class EventSkipperByID;
   class StreamerInputFile {
   public:
-    /**Reads a Streamer file */
+    /**Reads a Streamer file. If memoryMap is true and the file is local, the file is
+     memory mapped and the event records point directly into the mapping.*/
     explicit StreamerInputFile(std::string const& name,
-                               std::shared_ptr<EventSkipperByID> eventSkipperByID = std::shared_ptr<EventSkipperByID>());
+                               std::shared_ptr<EventSkipperByID> eventSkipperByID = std::shared_ptr<EventSkipperByID>(),
+                               bool memoryMap = false);
 
     /** Multiple Streamer files */
     explicit StreamerInputFile(std::vector<std::string> const& names,
-                               std::shared_ptr<EventSkipperByID> eventSkipperByID = std::shared_ptr<EventSkipperByID>());
+                               std::shared_ptr<EventSkipperByID> eventSkipperByID = std::shared_ptr<EventSkipperByID>(),
+                               bool memoryMap = false);
 
     ~StreamerInputFile();
 
@@ -33,7 +36,8 @@ namespace edm {
     /** Points to File Start Header/Message */
 
     EventMsgView const* currentRecord() const { return currentEvMsg_.get(); }
-    /** Points to current Record */
+    /** Points to current Record. If the file is memory mapped the record
+        is only valid until the next call to next() or closeStreamerFile() */
 
     bool newHeader() {
       bool tmp = newHeader_;
@@ -46,6 +50,9 @@ namespace edm {
 
   private:
     void openStreamerFile(std::string const& name);
+    bool mapStreamerFile(std::string const& name);
+    void unmapStreamerFile();
+    void adviseReadAhead();
     IOSize readBytes(char* buf, IOSize nBytes);
     IOOffset skipBytes(IOSize nBytes);
 
@@ -81,6 +88,12 @@ namespace edm {
     edm::propagate_const<std::unique_ptr<Storage>> storage_;
 
     bool endOfFile_;
+
+    bool memoryMap_;          /** Memory map local files instead of reading them through Storage */
+    char const* mapped_;      /** Start of the mapping of the current file, nullptr if not mapped */
+    IOSize mappedSize_;       /** Size of the mapping */
+    IOSize mappedPosition_;   /** Offset of the next byte to read in the mapping */
+    IOSize readAheadEnd_;     /** Offset up to which the kernel was asked to read ahead */
   };
 }  // namespace edm
 
@@ -33,7 +33,7 @@ namespace edm {
     std::unique_ptr<EventMsgBuilder> serializeEvent(SerializeDataBuffer& sbuf,
                                                     EventForOutput const& e,
                                                     Handle<TriggerResults> const& triggerResults,
-                                                    ParameterSetID const& selectorCfg);
+                                                    ParameterSetID const& selectorCfg) const;
 
     SerializeDataBuffer* getSerializerBuffer();
 
@@ -3,12 +3,14 @@
 
 //New module to write events from Streamer files
 #include "IOPool/Streamer/interface/StreamerOutputModule.h"
+#include "IOPool/Streamer/interface/GlobalStreamerOutputModule.h"
 #include "IOPool/Streamer/src/StreamerFileWriter.h"
 
 //new module to read events from Streamer files
 #include "IOPool/Streamer/src/StreamerFileReader.h"
 
 typedef edm::StreamerOutputModule<edm::StreamerFileWriter> EventStreamFileWriter;
+typedef edm::GlobalStreamerOutputModule<edm::StreamerFileWriter> GlobalEventStreamFileWriter;
 typedef edm::StreamerFileReader NewEventStreamFileReader;
 
 using edm::StreamerFileReader;
@@ -17,3 +19,4 @@ using edm::StreamerFileWriter;
 DEFINE_FWK_INPUT_SOURCE(NewEventStreamFileReader);
 
 DEFINE_FWK_MODULE(EventStreamFileWriter);
+DEFINE_FWK_MODULE(GlobalEventStreamFileWriter);
@@ -10,14 +10,39 @@
 #include "Utilities/StorageFactory/interface/IOFlags.h"
 #include "Utilities/StorageFactory/interface/StorageFactory.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace edm {
 
+  namespace {
+    // How far ahead of the current event the kernel is asked to page in a memory mapped file
+    constexpr IOSize kReadAheadSize = 64 * 1024 * 1024;
+
+    // Only plain local files can be memory mapped, returns an empty string otherwise
+    std::string localFileName(std::string const& name) {
+      std::string const filePrefix("file:");
+      if (name.compare(0, filePrefix.size(), filePrefix) == 0) {
+        return name.substr(filePrefix.size());
+      }
+      if (name.find(':') == std::string::npos) {
+        return name;
+      }
+      return std::string();
+    }
+  }  // namespace
+
   StreamerInputFile::~StreamerInputFile() { closeStreamerFile(); }
 
-  StreamerInputFile::StreamerInputFile(std::string const& name, std::shared_ptr<EventSkipperByID> eventSkipperByID)
+  StreamerInputFile::StreamerInputFile(std::string const& name,
+                                       std::shared_ptr<EventSkipperByID> eventSkipperByID,
+                                       bool memoryMap)
       : startMsg_(),
         currentEvMsg_(),
         headerBuf_(1000 * 1000),
@@ -32,13 +57,19 @@ namespace edm {
         currProto_(0),
         newHeader_(false),
         storage_(),
-        endOfFile_(false) {
+        endOfFile_(false),
+        memoryMap_(memoryMap),
+        mapped_(nullptr),
+        mappedSize_(0),
+        mappedPosition_(0),
+        readAheadEnd_(0) {
     openStreamerFile(name);
     readStartMessage();
   }
 
   StreamerInputFile::StreamerInputFile(std::vector<std::string> const& names,
-                                       std::shared_ptr<EventSkipperByID> eventSkipperByID)
+                                       std::shared_ptr<EventSkipperByID> eventSkipperByID,
+                                       bool memoryMap)
       : startMsg_(),
         currentEvMsg_(),
         headerBuf_(1000 * 1000),
@@ -52,7 +83,12 @@ namespace edm {
         currRun_(0),
         currProto_(0),
         newHeader_(false),
-        endOfFile_(false) {
+        endOfFile_(false),
+        memoryMap_(memoryMap),
+        mapped_(nullptr),
+        mappedSize_(0),
+        mappedPosition_(0),
+        readAheadEnd_(0) {
     openStreamerFile(names.at(0));
     ++currentFile_;
     readStartMessage();
@@ -66,6 +102,12 @@ namespace edm {
     currentFileName_ = name;
     logFileAction("  Initiating request to open file ");
 
+    if (memoryMap_ && mapStreamerFile(name)) {
+      currentFileOpen_ = true;
+      logFileAction("  Successfully memory mapped file ");
+      return;
+    }
+
     IOOffset size = -1;
     if (StorageFactory::get()->check(name, &size)) {
       try {
@@ -85,8 +127,68 @@ namespace edm {
     logFileAction("  Successfully opened file ");
   }
 
+  bool StreamerInputFile::mapStreamerFile(std::string const& name) {
+    std::string const fileName = localFileName(name);
+    if (fileName.empty()) {
+      LogInfo("StreamerInputFile") << "Cannot memory map non-local file " << name << ", it will be read normally";
+      return false;
+    }
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw Exception(errors::FileOpenError, "StreamerInputFile::mapStreamerFile")
+          << "Error Opening Streamer Input File: " << name << "\n";
+    }
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+      ::close(fd);
+      throw Exception(errors::FileOpenError, "StreamerInputFile::mapStreamerFile")
+          << "Error Opening Streamer Input File, unable to determine size or file is empty: " << name << "\n";
+    }
+    void* mapping = ::mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file descriptor is closed
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+      LogInfo("StreamerInputFile") << "Failed to memory map file " << name << ", it will be read normally";
+      return false;
+    }
+    ::madvise(mapping, fileStat.st_size, MADV_SEQUENTIAL);
+    mapped_ = static_cast<char const*>(mapping);
+    mappedSize_ = fileStat.st_size;
+    mappedPosition_ = 0;
+    readAheadEnd_ = 0;
+    adviseReadAhead();
+    return true;
+  }
+
+  void StreamerInputFile::unmapStreamerFile() {
+    if (mapped_) {
+      // Event records point into the mapping
+      currentEvMsg_ = nullptr;  // propagate_const<T> has no reset() function
+      ::munmap(const_cast<char*>(mapped_), mappedSize_);
+      mapped_ = nullptr;
+      mappedSize_ = 0;
+      mappedPosition_ = 0;
+      readAheadEnd_ = 0;
+    }
+  }
+
+  void StreamerInputFile::adviseReadAhead() {
+    // Only issue a new request once half of the previous read ahead window has been consumed
+    if (mappedPosition_ + kReadAheadSize / 2 < readAheadEnd_ || readAheadEnd_ >= mappedSize_) {
+      return;
+    }
+    static long const pageSize = ::sysconf(_SC_PAGESIZE);
+    IOSize const begin = mappedPosition_ - (mappedPosition_ % pageSize);
+    IOSize const end = std::min(mappedPosition_ + kReadAheadSize, mappedSize_);
+    ::madvise(const_cast<char*>(mapped_ + begin), end - begin, MADV_WILLNEED);
+    readAheadEnd_ = end;
+  }
+
   void StreamerInputFile::closeStreamerFile() {
-    if (currentFileOpen_ && storage_) {
+    if (currentFileOpen_ && mapped_) {
+      unmapStreamerFile();
+      logFileAction("  Closed file ");
+    } else if (currentFileOpen_ && storage_) {
       storage_->close();
       logFileAction("  Closed file ");
     }
@@ -94,6 +196,12 @@ namespace edm {
   }
 
   IOSize StreamerInputFile::readBytes(char* buf, IOSize nBytes) {
+    if (mapped_) {
+      IOSize n = std::min(nBytes, mappedSize_ - mappedPosition_);
+      std::copy(mapped_ + mappedPosition_, mapped_ + mappedPosition_ + n, buf);
+      mappedPosition_ += n;
+      return n;
+    }
     IOSize n = 0;
     try {
       n = storage_->read(buf, nBytes);
@@ -106,6 +214,11 @@ namespace edm {
   }
 
   IOOffset StreamerInputFile::skipBytes(IOSize nBytes) {
+    if (mapped_) {
+      IOSize n = std::min(nBytes, mappedSize_ - mappedPosition_);
+      mappedPosition_ += n;
+      return n;
+    }
     IOOffset n = 0;
     try {
       // We wish to return the number of bytes skipped, not the final offset.
@@ -211,7 +324,11 @@ namespace edm {
       return 0;
 
     bool eventRead = false;
+    char const* mappedEvent = nullptr;
     while (!eventRead) {
+      if (mapped_) {
+        mappedEvent = mapped_ + mappedPosition_;
+      }
       IOSize nWant = sizeof(EventHeader);
       IOSize nGot = readBytes(&eventBuf_[0], nWant);
       if (nGot == 0) {
@@ -246,7 +363,15 @@ namespace edm {
         }
       }
       nWant = eventSize - sizeof(EventHeader);
-      if (eventRead) {
+      if (eventRead && mapped_) {
+        // Leave the event in the mapping, the EventMsgView will point directly into it
+        nGot = skipBytes(nWant);
+        if (nGot != nWant) {
+          throw Exception(errors::FileReadError, "StreamerInputFile::readEventMessage")
+              << "Failed reading streamer file, second read in readEventMessage\n"
+              << "Requested " << nWant << " bytes, only " << nGot << " bytes left in file\n";
+        }
+      } else if (eventRead) {
         if (eventBuf_.size() < eventSize)
           eventBuf_.resize(eventSize);
         nGot = readBytes(&eventBuf_[sizeof(EventHeader)], nWant);
@@ -264,7 +389,14 @@ namespace edm {
         }
       }
     }
-    currentEvMsg_ = std::make_shared<EventMsgView>((void*)&eventBuf_[0]);  // propagate_const<T> has no reset() function
+    if (mapped_) {
+      currentEvMsg_ =
+          std::make_shared<EventMsgView>((void*)mappedEvent);  // propagate_const<T> has no reset() function
+      adviseReadAhead();
+    } else {
+      currentEvMsg_ =
+          std::make_shared<EventMsgView>((void*)&eventBuf_[0]);  // propagate_const<T> has no reset() function
+    }
     return 1;
   }
 
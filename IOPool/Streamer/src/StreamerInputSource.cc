@@ -224,20 +224,15 @@ namespace edm {
                                      eventView.eventLength(),
                                      dest_,
                                      origsize);
+      xbuf_.Reset();
+      xbuf_.SetBuffer(&dest_[0], dest_size, kFALSE);
     } else {  // not compressed
-      // we need to copy anyway the buffer as we are using dest in xbuf
+      // The message outlives this call and the event is completely read
+      // before returning, so deserialize directly from the message.
       dest_size = eventView.eventLength();
-      dest_.resize(dest_size);
-      unsigned char* pos = (unsigned char*)&dest_[0];
-      unsigned char const* from = (unsigned char const*)eventView.eventData();
-      std::copy(from, from + dest_size, pos);
+      xbuf_.Reset();
+      xbuf_.SetBuffer(const_cast<unsigned char*>(eventView.eventData()), dest_size, kFALSE);
     }
-    //TBuffer xbuf(TBuffer::kRead, dest_size,
-    //             (char const*) &dest[0],kFALSE);
-    //TBuffer xbuf(TBuffer::kRead, eventView.eventLength(),
-    //             (char const*) eventView.eventData(),kFALSE);
-    xbuf_.Reset();
-    xbuf_.SetBuffer(&dest_[0], dest_size, kFALSE);
     RootDebug tracer(10, 10);
 
     //We do not yet know which EventPrincipal we will use, therefore
@@ -195,7 +195,7 @@ namespace edm {
       SerializeDataBuffer& sbuf,
       EventForOutput const& e,
       Handle<TriggerResults> const& triggerResults,
-      ParameterSetID const& selectorCfg) {
+      ParameterSetID const& selectorCfg) const {
     constexpr unsigned int reserve_size = SerializeDataBuffer::reserve_size;
     //Lets Build the Event Message first
 
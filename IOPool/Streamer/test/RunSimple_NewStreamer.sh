@@ -31,6 +31,9 @@ cd ${OUTDIR}
 cmsRun NewStreamOut_cfg.py compAlgo=${TEST_COMPRESSION_ALGO} > out 2>&1 || die "cmsRun NewStreamOut_cfg.py compAlgo=${TEST_COMPRESSION_ALGO}" $?
 cmsRun --parameter-set NewStreamIn_cfg.py  > in  2>&1 || die "cmsRun NewStreamIn_cfg.py" $?
 cmsRun --parameter-set NewStreamIn2_cfg.py  > in2  2>&1 || die "cmsRun NewStreamIn2_cfg.py" $?
+cmsRun --parameter-set NewStreamInMmap_cfg.py  > inmmap  2>&1 || die "cmsRun NewStreamInMmap_cfg.py" $?
+cmsRun NewStreamOutGlobal_cfg.py compAlgo=${TEST_COMPRESSION_ALGO} > outglobal 2>&1 || die "cmsRun NewStreamOutGlobal_cfg.py compAlgo=${TEST_COMPRESSION_ALGO}" $?
+cmsRun --parameter-set NewStreamInGlobal_cfg.py  > inglobal  2>&1 || die "cmsRun NewStreamInGlobal_cfg.py" $?
 cmsRun --parameter-set NewStreamCopy_cfg.py  > copy  2>&1 || die "cmsRun NewStreamCopy_cfg.py" $?
 cmsRun --parameter-set NewStreamCopy2_cfg.py  > copy2  2>&1 || die "cmsRun NewStreamCopy2_cfg.py" $?
 
@@ -41,7 +44,10 @@ ANS_OUT_SIZE=`grep -c CHECKSUM out`
 ANS_OUT=`grep CHECKSUM out`
 ANS_IN=`grep CHECKSUM in`
 ANS_IN2=`grep CHECKSUM in2`
+ANS_INMMAP=`grep CHECKSUM inmmap`
 ANS_COPY=`grep CHECKSUM copy`
+ANS_OUTGLOBAL=`grep CHECKSUM outglobal`
+ANS_INGLOBAL=`grep CHECKSUM inglobal`
 
 if [ "${ANS_OUT_SIZE}" == "0" ]
 then
@@ -61,6 +67,24 @@ then
     RC=1
 fi
 
+if [ "${ANS_OUT}" != "${ANS_INMMAP}" ]
+then
+    echo "New Stream Test Failed (out!=inmmap)"
+    RC=1
+fi
+
+if [ "${ANS_OUT}" != "${ANS_OUTGLOBAL}" ]
+then
+    echo "New Stream Test Failed (out!=outglobal)"
+    RC=1
+fi
+
+if [ "${ANS_OUTGLOBAL}" != "${ANS_INGLOBAL}" ]
+then
+    echo "New Stream Test Failed (outglobal!=inglobal)"
+    RC=1
+fi
+
 if [ "${ANS_OUT}" != "${ANS_COPY}" ]
 then
     echo "New Stream Test Failed (copy!=out)"
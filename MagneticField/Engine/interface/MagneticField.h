@@ -45,6 +45,13 @@ public:
     return inTesla(gp);  // default dummy implementation
   }
 
+  /// Field values at the n points gp, in Tesla, stored in result.
+  /// Derived classes can implement it to serve many queries at once.
+  virtual void inTeslaBatch(const GlobalPoint* gp, GlobalVector* result, unsigned int n) const {
+    for (unsigned int i = 0; i < n; ++i)
+      result[i] = inTesla(gp[i]);  // default implementation
+  }
+
   /// The nominal field value for this map in kGauss
   int nominalValue() const {
     if (kSet == nominalValueCompiuted.load())
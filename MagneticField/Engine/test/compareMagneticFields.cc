@@ -0,0 +1,109 @@
+/** \file
+ *
+ *  Validation of a field engine against a reference one (e.g. a LookupTableMagneticField
+ *  against the full map it tabulates): the field of both is computed at random points
+ *  of a cylinder and the differences and the time per query are printed.
+ *
+ *  referenceLabel, testLabel: labels of the two maps in the IdealMagneticFieldRecord
+ *  numberOfPoints: number of random points
+ *  InnerRadius, OuterRadius, HalfLength: cylinder where the points are generated, in cm
+ */
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+class compareMagneticFields : public edm::one::EDAnalyzer<> {
+public:
+  compareMagneticFields(const edm::ParameterSet& pset)
+      : referenceToken_(esConsumes<MagneticField, IdealMagneticFieldRecord>(
+            edm::ESInputTag("", pset.getParameter<std::string>("referenceLabel")))),
+        testToken_(esConsumes<MagneticField, IdealMagneticFieldRecord>(
+            edm::ESInputTag("", pset.getParameter<std::string>("testLabel")))),
+        numberOfPoints_(pset.getUntrackedParameter<int>("numberOfPoints", 1000000)),
+        innerRadius_(pset.getUntrackedParameter<double>("InnerRadius", 0.)),
+        outerRadius_(pset.getUntrackedParameter<double>("OuterRadius", 115.)),
+        halfLength_(pset.getUntrackedParameter<double>("HalfLength", 280.)) {}
+
+  void analyze(const edm::Event& event, const edm::EventSetup& setup) override {
+    auto const& reference = setup.getData(referenceToken_);
+    auto const& test = setup.getData(testToken_);
+
+    // uniform in the volume of the cylinder
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<float> r2(innerRadius_ * innerRadius_, outerRadius_ * outerRadius_);
+    std::uniform_real_distribution<float> phi(-M_PI, M_PI);
+    std::uniform_real_distribution<float> z(-halfLength_, halfLength_);
+    std::vector<GlobalPoint> points;
+    points.reserve(numberOfPoints_);
+    for (int i = 0; i < numberOfPoints_; ++i) {
+      float r = std::sqrt(r2(gen));
+      float p = phi(gen);
+      points.emplace_back(r * std::cos(p), r * std::sin(p), z(gen));
+    }
+
+    std::vector<GlobalVector> referenceB(points.size()), testB(points.size()), batchB(points.size());
+    auto timeQueries = [&](MagneticField const& field, std::vector<GlobalVector>& result) {
+      auto start = std::chrono::steady_clock::now();
+      for (unsigned int i = 0; i < points.size(); ++i)
+        result[i] = field.inTesla(points[i]);
+      return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    };
+    double referenceTime = timeQueries(reference, referenceB);
+    double testTime = timeQueries(test, testB);
+    auto start = std::chrono::steady_clock::now();
+    test.inTeslaBatch(points.data(), batchB.data(), points.size());
+    double batchTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    double sum = 0, sum2 = 0, maxDiff = 0, maxRelDiff = 0;
+    unsigned int iMax = 0, nBatchDiffer = 0;
+    for (unsigned int i = 0; i < points.size(); ++i) {
+      double diff = (testB[i] - referenceB[i]).mag();
+      sum += diff;
+      sum2 += diff * diff;
+      if (diff > maxDiff) {
+        maxDiff = diff;
+        iMax = i;
+      }
+      if (referenceB[i].mag() > 0)
+        maxRelDiff = std::max(maxRelDiff, diff / referenceB[i].mag());
+      if ((batchB[i] - testB[i]).mag() > 1.e-6)
+        ++nBatchDiffer;
+    }
+
+    double n = std::max<double>(points.size(), 1);
+    std::cout << "compareMagneticFields: " << points.size() << " points with " << innerRadius_ << "<r<" << outerRadius_
+              << " |z|<" << halfLength_ << "\n"
+              << " |Btest-Bref| mean " << sum / n << " T, rms " << std::sqrt(sum2 / n) << " T, max " << maxDiff
+              << " T (relative " << maxRelDiff << ")";
+    if (!points.empty())
+      std::cout << " at " << points[iMax] << ": " << testB[iMax] << " vs " << referenceB[iMax];
+    std::cout << "\n"
+              << " time per query: reference " << referenceTime / n << " ns, test " << testTime / n
+              << " ns, test batch " << batchTime / n << " ns\n"
+              << " batch queries differing from single ones: " << nBatchDiffer << std::endl;
+  }
+
+private:
+  const edm::ESGetToken<MagneticField, IdealMagneticFieldRecord> referenceToken_;
+  const edm::ESGetToken<MagneticField, IdealMagneticFieldRecord> testToken_;
+  const int numberOfPoints_;
+  const double innerRadius_;
+  const double outerRadius_;
+  const double halfLength_;
+};
+
+DEFINE_FWK_MODULE(compareMagneticFields);
@@ -0,0 +1,30 @@
+#
+# Compare the field table over the tracker volume with the full map it is computed from,
+# and time the queries to both.
+#
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("MAGNETICFIELDTEST")
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1)
+)
+
+### Full field map
+process.load("Configuration.StandardSequences.MagneticField_38T_cff")
+
+### Table of the full map, with the label 'LookupTable'
+process.load("MagneticField.ParametrizedEngine.lookupTableMagneticField_cfi")
+
+process.compare = cms.EDAnalyzer("compareMagneticFields",
+    referenceLabel = cms.string(''),
+    testLabel = cms.string('LookupTable'),
+    numberOfPoints = cms.untracked.int32(1000000),
+    InnerRadius = cms.untracked.double(0.),
+    OuterRadius = cms.untracked.double(115.),
+    HalfLength = cms.untracked.double(280.)
+)
+
+process.p = cms.Path(process.compare)
@@ -0,0 +1,74 @@
+#ifndef ParametrizedEngine_LookupTableMagneticField_h
+#define ParametrizedEngine_LookupTableMagneticField_h
+
+/** \class LookupTableMagneticField
+ *
+ *  Field engine interpolating a table of the values of another field map,
+ *  computed once on a regular (r, phi, z) grid covering the tracker volume.
+ *
+ *  The table stores the cylindrical components (Br, Bphi, Bz) of each node as
+ *  one Vec4<float>, the nodes adjacent in r being contiguous, so that the
+ *  trilinear interpolation works on the three components at once.
+ *  Outside of the table the field of the source map is returned.
+ *
+ *  The source map must outlive this engine.
+ */
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "DataFormats/Math/interface/ExtVec.h"
+
+#include <cmath>
+#include <vector>
+
+class LookupTableMagneticField final : public MagneticField {
+public:
+  /// Tabulate source for r<rMax, |z|<zMax with nR, nPhi and nZ nodes in r, phi and z
+  LookupTableMagneticField(
+      const MagneticField& source, float rMax, float zMax, unsigned int nR, unsigned int nPhi, unsigned int nZ);
+
+  ~LookupTableMagneticField() override;
+
+  GlobalVector inTesla(const GlobalPoint& gp) const override;
+
+  GlobalVector inTeslaUnchecked(const GlobalPoint& gp) const override;
+
+  void inTeslaBatch(const GlobalPoint* gp, GlobalVector* result, unsigned int n) const override;
+
+  bool isDefined(const GlobalPoint& gp) const override { return theSource.isDefined(gp); }
+
+  /// True if the point is covered by the table
+  bool inTable(const GlobalPoint& gp) const {
+    return gp.perp2() <= theRMax * theRMax && std::abs(gp.z()) <= theZMax;
+  }
+
+  /// Number of bytes used by the table
+  std::size_t tableSize() const { return theTable.size() * sizeof(Vec4<float>); }
+
+private:
+  /// Position in units of the grid spacing (fr, fphi, fz) and cos, sin of phi
+  void coordinates(float x, float y, float z, float& fr, float& fphi, float& fz, float& c, float& s) const;
+
+  GlobalVector interpolate(float fr, float fphi, float fz, float c, float s) const;
+
+  GlobalVector interpolate(const GlobalPoint& gp) const;
+
+  unsigned int index(unsigned int ir, unsigned int iphi, unsigned int iz) const {
+    return (iz * theNPhi + iphi) * theNR + ir;
+  }
+
+  const MagneticField& theSource;
+
+  const float theRMax;
+  const float theZMax;
+  const unsigned int theNR;
+  const unsigned int theNPhi;
+  const unsigned int theNZ;
+  const float theInvDR;
+  const float theInvDPhi;
+  const float theInvDZ;
+
+  // (Br, Bphi, Bz, 0) at each node
+  std::vector<Vec4<float>> theTable;
+};
+
+#endif
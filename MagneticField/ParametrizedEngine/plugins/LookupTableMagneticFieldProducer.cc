@@ -0,0 +1,74 @@
+/** \class LookupTableMagneticFieldProducer
+ *
+ *   Description: Producer for the LookupTableMagneticField, a table of the values of another
+ *   field map of the IdealMagneticFieldRecord over the tracker volume.
+ *
+ */
+
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/Framework/interface/ModuleFactory.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "MagneticField/ParametrizedEngine/interface/LookupTableMagneticField.h"
+#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
+
+#include <string>
+
+namespace magneticfield {
+  class LookupTableMagneticFieldProducer : public edm::ESProducer {
+  public:
+    LookupTableMagneticFieldProducer(const edm::ParameterSet&);
+
+    std::unique_ptr<MagneticField> produce(const IdealMagneticFieldRecord&);
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    const double rMax_;
+    const double zMax_;
+    const unsigned int nR_;
+    const unsigned int nPhi_;
+    const unsigned int nZ_;
+    edm::ESGetToken<MagneticField, IdealMagneticFieldRecord> sourceToken_;
+  };
+}  // namespace magneticfield
+
+using namespace magneticfield;
+
+LookupTableMagneticFieldProducer::LookupTableMagneticFieldProducer(const edm::ParameterSet& iConfig)
+    : rMax_{iConfig.getParameter<double>("rMax")},
+      zMax_{iConfig.getParameter<double>("zMax")},
+      nR_{iConfig.getParameter<unsigned int>("nR")},
+      nPhi_{iConfig.getParameter<unsigned int>("nPhi")},
+      nZ_{iConfig.getParameter<unsigned int>("nZ")} {
+  auto cc = setWhatProduced(this, iConfig.getUntrackedParameter<std::string>("label"));
+  cc.setConsumes(sourceToken_, edm::ESInputTag{"", iConfig.getParameter<std::string>("sourceLabel")});
+}
+
+std::unique_ptr<MagneticField> LookupTableMagneticFieldProducer::produce(const IdealMagneticFieldRecord& iRecord) {
+  auto field = std::make_unique<LookupTableMagneticField>(iRecord.get(sourceToken_), rMax_, zMax_, nR_, nPhi_, nZ_);
+
+  edm::LogInfo("MagneticField|LookupTableMagneticField")
+      << "Field table for r<" << rMax_ << " |z|<" << zMax_ << " with " << nR_ << "x" << nPhi_ << "x" << nZ_
+      << " nodes, " << field->tableSize() << " bytes";
+
+  return field;
+}
+
+void LookupTableMagneticFieldProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.addUntracked<std::string>("label", "LookupTable");
+  desc.add<std::string>("sourceLabel", "")->setComment("label of the field map which is tabulated");
+  desc.add<double>("rMax", 115.)->setComment("radius covered by the table, in cm");
+  desc.add<double>("zMax", 280.)->setComment("half length covered by the table, in cm");
+  desc.add<unsigned int>("nR", 47)->setComment("number of nodes in r, 2.5 cm spacing by default");
+  desc.add<unsigned int>("nPhi", 12)->setComment("number of nodes in phi");
+  desc.add<unsigned int>("nZ", 225)->setComment("number of nodes in z, 2.5 cm spacing by default");
+  descriptions.add("lookupTableMagneticField", desc);
+}
+
+DEFINE_FWK_EVENTSETUP_MODULE(LookupTableMagneticFieldProducer);
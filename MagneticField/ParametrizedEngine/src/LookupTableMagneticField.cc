@@ -0,0 +1,121 @@
+/** \file
+ *
+ */
+
+#include "MagneticField/ParametrizedEngine/interface/LookupTableMagneticField.h"
+#include "DataFormats/Math/interface/approx_atan2.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+
+LookupTableMagneticField::LookupTableMagneticField(
+    const MagneticField& source, float rMax, float zMax, unsigned int nR, unsigned int nPhi, unsigned int nZ)
+    : theSource(source),
+      theRMax(rMax),
+      theZMax(zMax),
+      theNR(nR),
+      theNPhi(nPhi),
+      theNZ(nZ),
+      theInvDR((nR - 1) / rMax),
+      theInvDPhi(nPhi / (2.f * float(M_PI))),
+      theInvDZ((nZ - 1) / (2.f * zMax)) {
+  if (rMax <= 0.f || zMax <= 0.f || nR < 2 || nPhi < 1 || nZ < 2) {
+    throw cms::Exception("InvalidParameter")
+        << "LookupTableMagneticField: invalid table rMax=" << rMax << " zMax=" << zMax << " nR=" << nR
+        << " nPhi=" << nPhi << " nZ=" << nZ;
+  }
+
+  theTable.resize(nR * nPhi * nZ);
+  for (unsigned int iz = 0; iz < nZ; ++iz) {
+    float z = -zMax + iz / theInvDZ;
+    for (unsigned int iphi = 0; iphi < nPhi; ++iphi) {
+      float phi = -float(M_PI) + iphi / theInvDPhi;
+      float c = std::cos(phi);
+      float s = std::sin(phi);
+      for (unsigned int ir = 0; ir < nR; ++ir) {
+        float r = ir / theInvDR;
+        GlobalVector b = theSource.inTesla(GlobalPoint(r * c, r * s, z));
+        theTable[index(ir, iphi, iz)] = Vec4<float>{b.x() * c + b.y() * s, -b.x() * s + b.y() * c, b.z(), 0.f};
+      }
+    }
+  }
+}
+
+LookupTableMagneticField::~LookupTableMagneticField() {}
+
+void LookupTableMagneticField::coordinates(
+    float x, float y, float z, float& fr, float& fphi, float& fz, float& c, float& s) const {
+  float r = std::sqrt(x * x + y * y);
+  // the direction at r=0 does not matter as Br=Bphi=0 there
+  float r0 = r == 0.f ? 1.f : 0.f;
+  float invr = 1.f / (r + r0);
+  fr = r * theInvDR;
+  fz = (z + theZMax) * theInvDZ;
+  // phi in [-pi, pi], only used to find the phi bin
+  fphi = (unsafe_atan2f<5>(y, x + r0) + float(M_PI)) * theInvDPhi;
+  c = x * invr + r0;
+  s = y * invr;
+}
+
+GlobalVector LookupTableMagneticField::interpolate(float fr, float fphi, float fz, float c, float s) const {
+  unsigned int ir = std::min(int(fr), int(theNR) - 2);
+  float wr = fr - ir;
+  unsigned int iz = std::min(std::max(int(fz), 0), int(theNZ) - 2);
+  float wz = fz - iz;
+  // the phi bins are periodic
+  unsigned int iphi = std::min(std::max(int(fphi), 0), int(theNPhi) - 1);
+  float wphi = fphi - iphi;
+  unsigned int iphi1 = iphi + 1 == theNPhi ? 0 : iphi + 1;
+
+  auto const* t = theTable.data();
+  auto b00 = t[index(ir, iphi, iz)] + wr * (t[index(ir + 1, iphi, iz)] - t[index(ir, iphi, iz)]);
+  auto b10 = t[index(ir, iphi1, iz)] + wr * (t[index(ir + 1, iphi1, iz)] - t[index(ir, iphi1, iz)]);
+  auto b01 = t[index(ir, iphi, iz + 1)] + wr * (t[index(ir + 1, iphi, iz + 1)] - t[index(ir, iphi, iz + 1)]);
+  auto b11 = t[index(ir, iphi1, iz + 1)] + wr * (t[index(ir + 1, iphi1, iz + 1)] - t[index(ir, iphi1, iz + 1)]);
+  auto b0 = b00 + wphi * (b10 - b00);
+  auto b1 = b01 + wphi * (b11 - b01);
+  auto b = b0 + wz * (b1 - b0);
+
+  // back to cartesian components
+  return GlobalVector(b[0] * c - b[1] * s, b[0] * s + b[1] * c, b[2]);
+}
+
+GlobalVector LookupTableMagneticField::interpolate(const GlobalPoint& gp) const {
+  float fr, fphi, fz, c, s;
+  coordinates(gp.x(), gp.y(), gp.z(), fr, fphi, fz, c, s);
+  return interpolate(fr, fphi, fz, c, s);
+}
+
+GlobalVector LookupTableMagneticField::inTesla(const GlobalPoint& gp) const {
+  return inTable(gp) ? interpolate(gp) : theSource.inTesla(gp);
+}
+
+GlobalVector LookupTableMagneticField::inTeslaUnchecked(const GlobalPoint& gp) const {
+  return inTable(gp) ? interpolate(gp) : theSource.inTeslaUnchecked(gp);
+}
+
+void LookupTableMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* result, unsigned int n) const {
+  // the table coordinates of a block of points are computed in one loop, which the compiler vectorises,
+  // then the table is read point by point
+  constexpr unsigned int blockSize = 16;
+  alignas(64) float x[blockSize], y[blockSize], z[blockSize];
+  alignas(64) float fr[blockSize], fphi[blockSize], fz[blockSize], c[blockSize], s[blockSize];
+  for (unsigned int first = 0; first < n; first += blockSize) {
+    unsigned int size = std::min(blockSize, n - first);
+    for (unsigned int i = 0; i < size; ++i) {
+      x[i] = gp[first + i].x();
+      y[i] = gp[first + i].y();
+      z[i] = gp[first + i].z();
+    }
+    for (unsigned int i = size; i < blockSize; ++i) {
+      x[i] = y[i] = z[i] = 0.f;
+    }
+    for (unsigned int i = 0; i < blockSize; ++i) {
+      coordinates(x[i], y[i], z[i], fr[i], fphi[i], fz[i], c[i], s[i]);
+    }
+    for (unsigned int i = 0; i < size; ++i) {
+      auto const& p = gp[first + i];
+      result[first + i] = inTable(p) ? interpolate(fr[i], fphi[i], fz[i], c[i], s[i]) : theSource.inTesla(p);
+    }
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ * Service evaluating TensorFlow graphs for the modules of all the streams, batching their requests.
+ *
+ * Each graph (pb file with its input and output names) is loaded once and evaluated by a single
+ * session. Modules register the graph in their constructor and call runAsync from the acquire
+ * method of an ExternalWork module, with inputs whose first dimension is the batch one. The requests
+ * are queued per graph: a request arriving when the graph is idle is run by the calling thread,
+ * which then also runs the requests queued by the other streams meanwhile, concatenated into one
+ * batch of at most maxBatchSize rows, until the queue is empty. The outputs are split back per
+ * request, and the produce methods run when their outputs are ready.
+ */
+
+#ifndef PHYSICSTOOLS_TENSORFLOW_TFBATCHSERVICE_H
+#define PHYSICSTOOLS_TENSORFLOW_TFBATCHSERVICE_H
+
+#include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace edm {
+  class ActivityRegistry;
+  class ConfigurationDescriptions;
+  class ParameterSet;
+}  // namespace edm
+
+namespace tensorflow {
+
+  class TFBatchService {
+  public:
+    class Graph;
+
+    TFBatchService(const edm::ParameterSet& pset, edm::ActivityRegistry& registry);
+    ~TFBatchService();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+    // returns the graph of pbFile evaluated for inputNames and outputNames, it is loaded and its
+    // session created at the first call
+    // constantInputs (e.g. learning phase flags) are added to every run, those of the first call
+    // are used
+    Graph* graph(const std::string& pbFile,
+                 const std::vector<std::string>& inputNames,
+                 const std::vector<std::string>& outputNames,
+                 const NamedTensorList& constantInputs = NamedTensorList());
+
+    // evaluates the graph for inputs, in the order of the input names, whose first dimension is
+    // the batch one, outputs are filled with the rows of these inputs before holder is done
+    // waiting, or holder gets the exception of the run
+    void runAsync(Graph* graph,
+                  std::vector<Tensor> inputs,
+                  std::vector<Tensor>* outputs,
+                  edm::WaitingTaskWithArenaHolder holder);
+
+  private:
+    void postEndJob();
+
+    const int nThreads_;
+    const std::string singleThreadPool_;
+    const unsigned int maxBatchSize_;
+
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Graph>> graphs_;
+  };
+
+}  // namespace tensorflow
+
+#endif  // PHYSICSTOOLS_TENSORFLOW_TFBATCHSERVICE_H
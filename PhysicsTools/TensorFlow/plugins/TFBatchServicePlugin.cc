@@ -0,0 +1,4 @@
+#include "FWCore/ServiceRegistry/interface/ServiceMaker.h"
+#include "PhysicsTools/TensorFlow/interface/TFBatchService.h"
+using tensorflow::TFBatchService;
+DEFINE_FWK_SERVICE(TFBatchService);
@@ -0,0 +1,217 @@
+/*
+ * Service evaluating TensorFlow graphs for the modules of all the streams, batching their requests.
+ */
+
+#include "PhysicsTools/TensorFlow/interface/TFBatchService.h"
+
+#include "tensorflow/core/framework/tensor_util.h"
+
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+namespace tensorflow {
+
+  class TFBatchService::Graph {
+  public:
+    struct Request {
+      std::vector<Tensor> inputs;
+      std::vector<Tensor>* outputs;
+      edm::WaitingTaskWithArenaHolder holder;
+      int64 rows;
+    };
+
+    Graph(const std::string& pbFile,
+          const std::vector<std::string>& inputs,
+          const std::vector<std::string>& outputs,
+          const NamedTensorList& constants,
+          SessionOptions& sessionOptions)
+        : graphDef(loadGraphDef(pbFile)),
+          session(createSession(graphDef.get(), sessionOptions)),
+          inputNames(inputs),
+          outputNames(outputs),
+          constantInputs(constants) {}
+
+    ~Graph() { closeSession(session); }
+
+    // runs the requests of batch as one batch, and each request alone if that fails
+    void run(std::vector<Request>& batch);
+
+    std::unique_ptr<GraphDef> graphDef;
+    Session* session;
+    const std::vector<std::string> inputNames;
+    const std::vector<std::string> outputNames;
+    const NamedTensorList constantInputs;
+
+    std::mutex mutex;
+    std::vector<Request> pending;
+    bool running = false;
+  };
+
+  void TFBatchService::Graph::run(std::vector<Request>& batch) {
+    try {
+      NamedTensorList inputs;
+      inputs.reserve(inputNames.size() + constantInputs.size());
+      for (size_t i = 0; i < inputNames.size(); i++) {
+        if (batch.size() == 1) {
+          inputs.push_back(NamedTensor(inputNames[i], batch[0].inputs[i]));
+          continue;
+        }
+        std::vector<Tensor> parts;
+        parts.reserve(batch.size());
+        for (auto const& request : batch) {
+          parts.push_back(request.inputs[i]);
+        }
+        Tensor input;
+        Status status = tensor::Concat(parts, &input);
+        if (!status.ok()) {
+          throw cms::Exception("InvalidInput") << "error while batching input " << inputNames[i] << ": "
+                                               << status.ToString();
+        }
+        inputs.push_back(NamedTensor(inputNames[i], input));
+      }
+      inputs.insert(inputs.end(), constantInputs.begin(), constantInputs.end());
+
+      std::vector<Tensor> outputs;
+      tensorflow::run(session, inputs, outputNames, &outputs);
+
+      if (batch.size() == 1) {
+        *batch[0].outputs = std::move(outputs);
+      } else {
+        std::vector<int64> rows;
+        rows.reserve(batch.size());
+        for (auto const& request : batch) {
+          rows.push_back(request.rows);
+          request.outputs->resize(outputs.size());
+        }
+        for (size_t i = 0; i < outputs.size(); i++) {
+          std::vector<Tensor> parts;
+          Status status = tensor::Split(outputs[i], rows, &parts);
+          if (!status.ok()) {
+            throw cms::Exception("InvalidOutput") << "error while splitting output " << outputNames[i] << ": "
+                                                  << status.ToString();
+          }
+          for (size_t j = 0; j < batch.size(); j++) {
+            (*batch[j].outputs)[i] = std::move(parts[j]);
+          }
+        }
+      }
+    } catch (...) {
+      if (batch.size() == 1) {
+        batch[0].holder.doneWaiting(std::current_exception());
+        return;
+      }
+      // run the requests one by one, so that only those which fail get the exception
+      for (auto& request : batch) {
+        std::vector<Request> single;
+        single.push_back(std::move(request));
+        run(single);
+      }
+      return;
+    }
+    for (auto& request : batch) {
+      request.holder.doneWaiting(std::exception_ptr());
+    }
+  }
+
+  TFBatchService::TFBatchService(const edm::ParameterSet& pset, edm::ActivityRegistry& registry)
+      : nThreads_(pset.getUntrackedParameter<unsigned int>("nThreads")),
+        singleThreadPool_(pset.getUntrackedParameter<std::string>("singleThreadPool")),
+        maxBatchSize_(pset.getUntrackedParameter<unsigned int>("maxBatchSize")) {
+    registry.watchPostEndJob(this, &TFBatchService::postEndJob);
+  }
+
+  TFBatchService::~TFBatchService() {}
+
+  void TFBatchService::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+    edm::ParameterSetDescription desc;
+    desc.addUntracked<unsigned int>("nThreads", 1)->setComment("number of threads of the sessions");
+    desc.addUntracked<std::string>("singleThreadPool", "tbb")
+        ->setComment("thread pool of the sessions with one thread, 'no_threads' or 'tbb'");
+    desc.addUntracked<unsigned int>("maxBatchSize", 1024)
+        ->setComment("maximum number of rows of a batch, a single request can be larger");
+    descriptions.add("TFBatchService", desc);
+  }
+
+  TFBatchService::Graph* TFBatchService::graph(const std::string& pbFile,
+                                               const std::vector<std::string>& inputNames,
+                                               const std::vector<std::string>& outputNames,
+                                               const NamedTensorList& constantInputs) {
+    std::string key = pbFile;
+    for (auto const& name : inputNames) {
+      key += " " + name;
+    }
+    key += " ->";
+    for (auto const& name : outputNames) {
+      key += " " + name;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& graph = graphs_[key];
+    if (!graph) {
+      setLogging("3");
+      SessionOptions sessionOptions;
+      setThreading(sessionOptions, nThreads_, singleThreadPool_);
+      graph = std::make_unique<Graph>(pbFile, inputNames, outputNames, constantInputs, sessionOptions);
+    }
+    return graph.get();
+  }
+
+  void TFBatchService::runAsync(Graph* graph,
+                                std::vector<Tensor> inputs,
+                                std::vector<Tensor>* outputs,
+                                edm::WaitingTaskWithArenaHolder holder) {
+    if (inputs.size() != graph->inputNames.size()) {
+      throw cms::Exception("InvalidInput") << "numbers of input names and tensors not equal";
+    }
+    int64 rows = inputs.empty() ? 0 : inputs[0].dim_size(0);
+    if (rows == 0) {
+      outputs->clear();
+      holder.doneWaiting(std::exception_ptr());
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(graph->mutex);
+      graph->pending.push_back(Graph::Request{std::move(inputs), outputs, std::move(holder), rows});
+      if (graph->running) {
+        return;
+      }
+      graph->running = true;
+    }
+
+    // this thread runs the queued requests, those arriving during a run make the next batch
+    std::vector<Graph::Request> batch;
+    while (true) {
+      batch.clear();
+      {
+        std::lock_guard<std::mutex> guard(graph->mutex);
+        if (graph->pending.empty()) {
+          graph->running = false;
+          return;
+        }
+        int64 batchRows = 0;
+        auto last = graph->pending.begin();
+        while (last != graph->pending.end() &&
+               (last == graph->pending.begin() || batchRows + last->rows <= maxBatchSize_)) {
+          batchRows += last->rows;
+          ++last;
+        }
+        std::move(graph->pending.begin(), last, std::back_inserter(batch));
+        graph->pending.erase(graph->pending.begin(), last);
+      }
+      graph->run(batch);
+    }
+  }
+
+  void TFBatchService::postEndJob() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    graphs_.clear();
+  }
+
+}  // namespace tensorflow
@@ -0,0 +1,198 @@
+/*
+ * Tests for the evaluation of a graph by TFBatchService from several threads, with requests
+ * concatenated into batches whose outputs are split back per request.
+ * The graph test_graph_tfadd.pb adds its int32 inputs x_const and y_const into x_y_sum.
+ */
+
+#include <boost/filesystem.hpp>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "PhysicsTools/TensorFlow/interface/TFBatchService.h"
+
+std::string cmsswPath(std::string path) {
+  if (path.size() > 0 && path.substr(0, 1) != "/") {
+    path = "/" + path;
+  }
+
+  std::string base = std::string(std::getenv("CMSSW_BASE"));
+  std::string releaseBase = std::string(std::getenv("CMSSW_RELEASE_BASE"));
+
+  return (boost::filesystem::exists(base.c_str()) ? base : releaseBase) + path;
+}
+
+class testTFBatchService : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testTFBatchService);
+  CPPUNIT_TEST(checkSingle);
+  CPPUNIT_TEST(checkBadInput);
+  CPPUNIT_TEST(checkThreads);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  std::string pbFile;
+  std::unique_ptr<edm::ActivityRegistry> registry;
+  std::unique_ptr<tensorflow::TFBatchService> service;
+  tensorflow::TFBatchService::Graph* graph;
+
+  void setUp();
+  void tearDown();
+  void checkSingle();
+  void checkBadInput();
+  void checkThreads();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testTFBatchService);
+
+namespace {
+  tensorflow::Tensor makeInput(const std::vector<int>& values) {
+    tensorflow::Tensor input(tensorflow::DT_INT32, {static_cast<tensorflow::int64>(values.size())});
+    for (size_t i = 0; i < values.size(); i++) {
+      input.flat<int>()(i) = values[i];
+    }
+    return input;
+  }
+
+  // calls runAsync and waits until the holder is done waiting, returns the exception it got or
+  // the one thrown by runAsync
+  std::exception_ptr evaluate(tensorflow::TFBatchService& service,
+                              tensorflow::TFBatchService::Graph* graph,
+                              std::vector<tensorflow::Tensor> inputs,
+                              std::vector<tensorflow::Tensor>& outputs) {
+    std::exception_ptr exception;
+    auto waitTask = edm::make_empty_waiting_task();
+    waitTask->set_ref_count(2);
+    auto task = edm::make_waiting_task(waitTask->allocate_child(), [&exception](std::exception_ptr const* iPtr) {
+      if (iPtr) {
+        exception = *iPtr;
+      }
+    });
+    std::exception_ptr thrown;
+    try {
+      service.runAsync(graph, std::move(inputs), &outputs, edm::WaitingTaskWithArenaHolder(task));
+    } catch (...) {
+      thrown = std::current_exception();
+    }
+    waitTask->wait_for_all();
+    return thrown ? thrown : exception;
+  }
+
+  // checks that outputs is the sum of x and y
+  bool isSum(const std::vector<tensorflow::Tensor>& outputs, const std::vector<int>& x, const std::vector<int>& y) {
+    if (outputs.size() != 1 || outputs[0].dims() != 1 || outputs[0].dim_size(0) != static_cast<int>(x.size())) {
+      return false;
+    }
+    for (size_t i = 0; i < x.size(); i++) {
+      if (outputs[0].flat<int>()(i) != x[i] + y[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+}  // namespace
+
+void testTFBatchService::setUp() {
+  pbFile = cmsswPath("/src/PhysicsTools/TensorFlow/test/test_graph_tfadd.pb");
+
+  edm::ParameterSet pset;
+  pset.addUntrackedParameter<unsigned int>("nThreads", 1);
+  pset.addUntrackedParameter<std::string>("singleThreadPool", "no_threads");
+  pset.addUntrackedParameter<unsigned int>("maxBatchSize", 16);
+  registry = std::make_unique<edm::ActivityRegistry>();
+  service = std::make_unique<tensorflow::TFBatchService>(pset, *registry);
+  graph = service->graph(pbFile, {"x_const", "y_const"}, {"x_y_sum"});
+  CPPUNIT_ASSERT(graph != nullptr);
+}
+
+void testTFBatchService::tearDown() {
+  service.reset();
+  registry.reset();
+}
+
+void testTFBatchService::checkSingle() {
+  // the graph is loaded once
+  CPPUNIT_ASSERT(service->graph(pbFile, {"x_const", "y_const"}, {"x_y_sum"}) == graph);
+
+  std::vector<tensorflow::Tensor> outputs;
+  std::exception_ptr exception = evaluate(*service, graph, {makeInput({1, 2, 3}), makeInput({10, 20, 30})}, outputs);
+  CPPUNIT_ASSERT(!exception);
+  CPPUNIT_ASSERT(isSum(outputs, {1, 2, 3}, {10, 20, 30}));
+
+  // a request without rows is done without running the graph
+  exception = evaluate(*service, graph, {makeInput({}), makeInput({})}, outputs);
+  CPPUNIT_ASSERT(!exception);
+  CPPUNIT_ASSERT(outputs.empty());
+
+  // the numbers of input names and tensors must be equal
+  exception = evaluate(*service, graph, {makeInput({1})}, outputs);
+  CPPUNIT_ASSERT(exception);
+  CPPUNIT_ASSERT_THROW(std::rethrow_exception(exception), cms::Exception);
+}
+
+void testTFBatchService::checkBadInput() {
+  // x and y with different numbers of rows cannot be added
+  std::vector<tensorflow::Tensor> outputs;
+  std::exception_ptr exception = evaluate(*service, graph, {makeInput({1, 2}), makeInput({1, 2, 3})}, outputs);
+  CPPUNIT_ASSERT(exception);
+
+  // the graph can still be evaluated
+  exception = evaluate(*service, graph, {makeInput({4}), makeInput({5})}, outputs);
+  CPPUNIT_ASSERT(!exception);
+  CPPUNIT_ASSERT(isSum(outputs, {4}, {5}));
+}
+
+void testTFBatchService::checkThreads() {
+  // the requests of the threads are batched together, the bad ones (a float x, which can neither
+  // be concatenated with the others nor added to an int32 y) fail alone
+  const int nThreads = 8;
+  const int nRequests = 200;
+  std::atomic<int> nWrong{0};
+  std::atomic<int> nFailed{0};
+  std::atomic<int> nBad{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int r = 0; r < nRequests; r++) {
+        std::vector<int> x, y;
+        for (int i = 0; i < 1 + (t + r) % 5; i++) {
+          x.push_back(1000000 * t + 100 * r + i);
+          y.push_back(i);
+        }
+        bool bad = t == 3 && r % 10 == 0;
+        tensorflow::Tensor xInput = makeInput(x);
+        if (bad) {
+          nBad++;
+          xInput = tensorflow::Tensor(tensorflow::DT_FLOAT, {static_cast<tensorflow::int64>(x.size())});
+          for (size_t i = 0; i < x.size(); i++) {
+            xInput.flat<float>()(i) = x[i];
+          }
+        }
+
+        std::vector<tensorflow::Tensor> outputs;
+        std::exception_ptr exception = evaluate(*service, graph, {xInput, makeInput(y)}, outputs);
+        if (exception) {
+          nFailed++;
+          if (!bad) {
+            nWrong++;
+          }
+        } else if (bad || !isSum(outputs, x, y)) {
+          nWrong++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  CPPUNIT_ASSERT_EQUAL(0, nWrong.load());
+  CPPUNIT_ASSERT_EQUAL(nBad.load(), nFailed.load());
+}
@@ -8,6 +8,7 @@
 #include "FWCore/Framework/interface/makeRefToBaseProdFrom.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/StreamID.h"
 
 #include "DataFormats/BTauReco/interface/JetTag.h"
@@ -15,6 +16,7 @@
 #include "DataFormats/BTauReco/interface/DeepFlavourTagInfo.h"
 
 #include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+#include "PhysicsTools/TensorFlow/interface/TFBatchService.h"
 
 #include "RecoBTag/TensorFlow/interface/tensor_fillers.h"
 
@@ -32,7 +34,8 @@ struct DeepFlavourTFCache {
   std::atomic<tensorflow::GraphDef*> graphDef;
 };
 
-class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>> {
+class DeepFlavourTFJetTagsProducer
+    : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>, edm::ExternalWork> {
 public:
   explicit DeepFlavourTFJetTagsProducer(const edm::ParameterSet&, const DeepFlavourTFCache*);
   ~DeepFlavourTFJetTagsProducer() override;
@@ -54,9 +57,21 @@ private:
   typedef reco::JetTagCollection JetTagCollection;
 
   void beginStream(edm::StreamID) override {}
+  void acquire(const edm::Event&, const edm::EventSetup&, edm::WaitingTaskWithArenaHolder) override;
   void produce(edm::Event&, const edm::EventSetup&) override;
   void endStream() override {}
 
+  static std::vector<tensorflow::TensorShape> input_sizes(int64_t n_batch_jets);
+  // zero the input tensors and fill them with the jets first_jet, first_jet + 1, ...
+  void fill_inputs(const TagInfoCollection& tag_infos,
+                   std::size_t first_jet,
+                   std::vector<tensorflow::Tensor>& inputs) const;
+  // set the tags of the jets first_jet, first_jet + 1, ... from the flavour probabilities
+  void set_outputs(const TagInfoCollection& tag_infos,
+                   std::size_t first_jet,
+                   const tensorflow::Tensor& flavour,
+                   std::vector<std::unique_ptr<JetTagCollection>>& output_tags) const;
+
   const edm::EDGetTokenT<TagInfoCollection> src_;
   std::vector<std::pair<std::string, std::vector<unsigned int>>> flav_pairs_;
   std::vector<std::string> input_names_;
@@ -69,6 +84,10 @@ private:
   std::vector<tensorflow::Tensor> lp_tensors_;
   // flag to evaluate model batch or jet by jet
   bool batch_eval_;
+  // evaluate the jets of all the streams together in the TFBatchService
+  bool use_batch_service_;
+  tensorflow::TFBatchService::Graph* service_graph_;
+  std::vector<tensorflow::Tensor> service_outputs_;
 };
 
 DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterSet& iConfig,
@@ -78,15 +97,19 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
       output_names_(iConfig.getParameter<std::vector<std::string>>("output_names")),
       lp_names_(iConfig.getParameter<std::vector<std::string>>("lp_names")),
       session_(nullptr),
-      batch_eval_(iConfig.getParameter<bool>("batch_eval")) {
-  // get threading config and build session options
-  size_t nThreads = iConfig.getParameter<unsigned int>("nThreads");
-  std::string singleThreadPool = iConfig.getParameter<std::string>("singleThreadPool");
-  tensorflow::SessionOptions sessionOptions;
-  tensorflow::setThreading(sessionOptions, nThreads, singleThreadPool);
-
-  // create the session using the meta graph from the cache
-  session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+      batch_eval_(iConfig.getParameter<bool>("batch_eval")),
+      use_batch_service_(iConfig.getParameter<bool>("use_batch_service")),
+      service_graph_(nullptr) {
+  if (!use_batch_service_) {
+    // get threading config and build session options
+    size_t nThreads = iConfig.getParameter<unsigned int>("nThreads");
+    std::string singleThreadPool = iConfig.getParameter<std::string>("singleThreadPool");
+    tensorflow::SessionOptions sessionOptions;
+    tensorflow::setThreading(sessionOptions, nThreads, singleThreadPool);
+
+    // create the session using the meta graph from the cache
+    session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  }
 
   // get output names from flav_table
   const auto& flav_pset = iConfig.getParameter<edm::ParameterSet>("flav_table");
@@ -107,6 +130,16 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
     t.scalar<bool>()() = false;
     lp_tensors_.push_back(t);
   }
+
+  // the graph is shared by the modules of all the streams
+  if (use_batch_service_) {
+    tensorflow::NamedTensorList lp_inputs;
+    for (size_t i = 0; i < lp_names_.size(); i++) {
+      lp_inputs.emplace_back(lp_names_[i], lp_tensors_[i]);
+    }
+    service_graph_ = edm::Service<tensorflow::TFBatchService>()->graph(
+        iConfig.getParameter<edm::FileInPath>("graph_path").fullPath(), input_names_, output_names_, lp_inputs);
+  }
 }
 
 DeepFlavourTFJetTagsProducer::~DeepFlavourTFJetTagsProducer() {
@@ -137,6 +170,8 @@ void DeepFlavourTFJetTagsProducer::fillDescriptions(edm::ConfigurationDescriptio
   }
 
   desc.add<bool>("batch_eval", false);
+  desc.add<bool>("use_batch_service", false)
+      ->setComment("evaluate the jets of all the streams in batches in the TFBatchService, which must be configured");
 
   desc.add<unsigned int>("nThreads", 1);
   desc.add<std::string>("singleThreadPool", "no_threads");
@@ -165,6 +200,105 @@ void DeepFlavourTFJetTagsProducer::globalEndJob(const DeepFlavourTFCache* cache)
   }
 }
 
+std::vector<tensorflow::TensorShape> DeepFlavourTFJetTagsProducer::input_sizes(int64_t n_batch_jets) {
+  return {
+      {n_batch_jets, 15},      // input_1 - global jet features
+      {n_batch_jets, 25, 16},  // input_2 - charged pf
+      {n_batch_jets, 25, 6},   // input_3 - neutral pf
+      {n_batch_jets, 4, 12},   // input_4 - vertices
+      {n_batch_jets, 1}        // input_5 - jet pt for reg
+  };
+}
+
+void DeepFlavourTFJetTagsProducer::fill_inputs(const TagInfoCollection& tag_infos,
+                                               std::size_t first_jet,
+                                               std::vector<tensorflow::Tensor>& inputs) const {
+  // tensors have to be zeroed before filling per batch
+  for (auto& input : inputs) {
+    input.flat<float>().setZero();
+  }
+
+  const std::size_t n_batch_jets = inputs.at(kGlobal).dim_size(0);
+  for (std::size_t jet_bn = 0; jet_bn < n_batch_jets; jet_bn++) {
+    // global jet index (jet_bn is the jet batch index)
+    std::size_t jet_n = first_jet + jet_bn;
+
+    // jet and other global features
+    const auto& features = tag_infos.at(jet_n).features();
+    jet_tensor_filler(inputs.at(kGlobal), jet_bn, features);
+
+    // c_pf candidates
+    auto max_c_pf_n = std::min(features.c_pf_features.size(), (std::size_t)inputs.at(kChargedCandidates).dim_size(1));
+    for (std::size_t c_pf_n = 0; c_pf_n < max_c_pf_n; c_pf_n++) {
+      const auto& c_pf_features = features.c_pf_features.at(c_pf_n);
+      c_pf_tensor_filler(inputs.at(kChargedCandidates), jet_bn, c_pf_n, c_pf_features);
+    }
+
+    // n_pf candidates
+    auto max_n_pf_n = std::min(features.n_pf_features.size(), (std::size_t)inputs.at(kNeutralCandidates).dim_size(1));
+    for (std::size_t n_pf_n = 0; n_pf_n < max_n_pf_n; n_pf_n++) {
+      const auto& n_pf_features = features.n_pf_features.at(n_pf_n);
+      n_pf_tensor_filler(inputs.at(kNeutralCandidates), jet_bn, n_pf_n, n_pf_features);
+    }
+
+    // sv candidates
+    auto max_sv_n = std::min(features.sv_features.size(), (std::size_t)inputs.at(kVertices).dim_size(1));
+    for (std::size_t sv_n = 0; sv_n < max_sv_n; sv_n++) {
+      const auto& sv_features = features.sv_features.at(sv_n);
+      sv_tensor_filler(inputs.at(kVertices), jet_bn, sv_n, sv_features);
+    }
+
+    // last input: jet pt
+    inputs.at(kJetPt).matrix<float>()(jet_bn, 0) = features.jet_features.pt;
+  }
+}
+
+void DeepFlavourTFJetTagsProducer::set_outputs(const TagInfoCollection& tag_infos,
+                                               std::size_t first_jet,
+                                               const tensorflow::Tensor& flavour,
+                                               std::vector<std::unique_ptr<JetTagCollection>>& output_tags) const {
+  // set output values for flavour probs
+  for (std::size_t jet_bn = 0; jet_bn < (std::size_t)flavour.dim_size(0); jet_bn++) {
+    // global jet index (jet_bn is the jet batch index)
+    std::size_t jet_n = first_jet + jet_bn;
+
+    const auto& jet_ref = tag_infos.at(jet_n).jet();
+    for (std::size_t flav_n = 0; flav_n < flav_pairs_.size(); flav_n++) {
+      const auto& flav_pair = flav_pairs_.at(flav_n);
+      float o_sum = 0.;
+      for (const unsigned int& ind : flav_pair.second) {
+        o_sum += flavour.matrix<float>()(jet_bn, ind);
+      }
+      (*(output_tags.at(flav_n)))[jet_ref] = o_sum;
+    }
+  }
+}
+
+void DeepFlavourTFJetTagsProducer::acquire(const edm::Event& iEvent,
+                                           const edm::EventSetup& iSetup,
+                                           edm::WaitingTaskWithArenaHolder waitingTaskHolder) {
+  // without the service everything is done in produce
+  service_outputs_.clear();
+  if (!use_batch_service_) {
+    return;
+  }
+
+  edm::Handle<TagInfoCollection> tag_infos;
+  iEvent.getByToken(src_, tag_infos);
+  if (tag_infos->empty()) {
+    return;
+  }
+
+  // all the jets of the event are one request, the service batches them with those of other events
+  std::vector<tensorflow::Tensor> inputs;
+  for (const auto& size : input_sizes(tag_infos->size())) {
+    inputs.emplace_back(tensorflow::DT_FLOAT, size);
+  }
+  fill_inputs(*tag_infos, 0, inputs);
+  edm::Service<tensorflow::TFBatchService>()->runAsync(
+      service_graph_, std::move(inputs), &service_outputs_, std::move(waitingTaskHolder));
+}
+
 void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
   edm::Handle<TagInfoCollection> tag_infos;
   iEvent.getByToken(src_, tag_infos);
@@ -180,96 +314,47 @@ void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventS
     }
   }
 
-  const int64_t n_jets = tag_infos->size();
-  // either all jets or one per batch for the time being
-  const int64_t n_batch_jets = batch_eval_ ? n_jets : 1;
-
-  std::vector<tensorflow::TensorShape> input_sizes{
-      {n_batch_jets, 15},      // input_1 - global jet features
-      {n_batch_jets, 25, 16},  // input_2 - charged pf
-      {n_batch_jets, 25, 6},   // input_3 - neutral pf
-      {n_batch_jets, 4, 12},   // input_4 - vertices
-      {n_batch_jets, 1}        // input_5 - jet pt for reg
-  };
-
-  // create a list of named tensors, i.e. a vector of (string, Tensor) pairs, with proper size to
-  // prevent element copying that would occur via push_back's
-  // the default Tensor constructor creates a scalar so this should be fine w.r.t. to memory
-  tensorflow::NamedTensorList input_tensors;
-  input_tensors.resize(input_sizes.size() + lp_tensors_.size());
-
-  // add actual input tensors that hold physics information
-  for (std::size_t i = 0; i < input_sizes.size(); i++) {
-    input_tensors[i] =
-        tensorflow::NamedTensor(input_names_[i], tensorflow::Tensor(tensorflow::DT_FLOAT, input_sizes.at(i)));
-  }
+  if (use_batch_service_) {
+    // the outputs were computed by the service during acquire
+    if (!tag_infos->empty()) {
+      set_outputs(*tag_infos, 0, service_outputs_.at(kJetFlavour), output_tags);
+    }
+  } else {
+    const int64_t n_jets = tag_infos->size();
+    // either all jets or one per batch for the time being
+    const int64_t n_batch_jets = batch_eval_ ? n_jets : 1;
+
+    std::vector<tensorflow::Tensor> inputs;
+    for (const auto& size : input_sizes(n_batch_jets)) {
+      inputs.emplace_back(tensorflow::DT_FLOAT, size);
+    }
 
-  // add learning-phase tensors behind them
-  for (std::size_t i = 0; i < lp_tensors_.size(); i++) {
-    input_tensors[input_sizes.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
-  }
+    // create a list of named tensors, i.e. a vector of (string, Tensor) pairs, with proper size to
+    // prevent element copying that would occur via push_back's
+    // the named tensors share the buffers of the inputs
+    tensorflow::NamedTensorList input_tensors;
+    input_tensors.resize(inputs.size() + lp_tensors_.size());
 
-  std::size_t n_batches = n_jets / n_batch_jets;  // either 1 or n_jets
-  for (std::size_t batch_n = 0; batch_n < n_batches; batch_n++) {
-    // tensors have to be zeroed before filling per batch
-    for (std::size_t i = 0; i < input_sizes.size(); i++) {
-      input_tensors[i].second.flat<float>().setZero();
+    // add actual input tensors that hold physics information
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+      input_tensors[i] = tensorflow::NamedTensor(input_names_[i], inputs[i]);
     }
 
-    // fill values of the input tensors
-    for (std::size_t jet_bn = 0; jet_bn < (std::size_t)n_batch_jets; jet_bn++) {
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n * n_batch_jets + jet_bn;
-
-      // jet and other global features
-      const auto& features = tag_infos->at(jet_n).features();
-      jet_tensor_filler(input_tensors.at(kGlobal).second, jet_bn, features);
-
-      // c_pf candidates
-      auto max_c_pf_n =
-          std::min(features.c_pf_features.size(), (std::size_t)input_sizes.at(kChargedCandidates).dim_size(1));
-      for (std::size_t c_pf_n = 0; c_pf_n < max_c_pf_n; c_pf_n++) {
-        const auto& c_pf_features = features.c_pf_features.at(c_pf_n);
-        c_pf_tensor_filler(input_tensors.at(kChargedCandidates).second, jet_bn, c_pf_n, c_pf_features);
-      }
+    // add learning-phase tensors behind them
+    for (std::size_t i = 0; i < lp_tensors_.size(); i++) {
+      input_tensors[inputs.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
+    }
 
-      // n_pf candidates
-      auto max_n_pf_n =
-          std::min(features.n_pf_features.size(), (std::size_t)input_sizes.at(kNeutralCandidates).dim_size(1));
-      for (std::size_t n_pf_n = 0; n_pf_n < max_n_pf_n; n_pf_n++) {
-        const auto& n_pf_features = features.n_pf_features.at(n_pf_n);
-        n_pf_tensor_filler(input_tensors.at(kNeutralCandidates).second, jet_bn, n_pf_n, n_pf_features);
-      }
+    std::size_t n_batches = n_jets / n_batch_jets;  // either 1 or n_jets
+    for (std::size_t batch_n = 0; batch_n < n_batches; batch_n++) {
+      // fill values of the input tensors
+      fill_inputs(*tag_infos, batch_n * n_batch_jets, inputs);
 
-      // sv candidates
-      auto max_sv_n = std::min(features.sv_features.size(), (std::size_t)input_sizes.at(kVertices).dim_size(1));
-      for (std::size_t sv_n = 0; sv_n < max_sv_n; sv_n++) {
-        const auto& sv_features = features.sv_features.at(sv_n);
-        sv_tensor_filler(input_tensors.at(kVertices).second, jet_bn, sv_n, sv_features);
-      }
+      // run the session
+      std::vector<tensorflow::Tensor> outputs;
+      tensorflow::run(session_, input_tensors, output_names_, &outputs);
 
-      // last input: jet pt
-      input_tensors.at(kJetPt).second.matrix<float>()(jet_bn, 0) = features.jet_features.pt;
-    }
-
-    // run the session
-    std::vector<tensorflow::Tensor> outputs;
-    tensorflow::run(session_, input_tensors, output_names_, &outputs);
-
-    // set output values for flavour probs
-    for (std::size_t jet_bn = 0; jet_bn < (std::size_t)n_batch_jets; jet_bn++) {
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n * n_batch_jets + jet_bn;
-
-      const auto& jet_ref = tag_infos->at(jet_n).jet();
-      for (std::size_t flav_n = 0; flav_n < flav_pairs_.size(); flav_n++) {
-        const auto& flav_pair = flav_pairs_.at(flav_n);
-        float o_sum = 0.;
-        for (const unsigned int& ind : flav_pair.second) {
-          o_sum += outputs.at(kJetFlavour).matrix<float>()(jet_bn, ind);
-        }
-        (*(output_tags.at(flav_n)))[jet_ref] = o_sum;
-      }
+      set_outputs(*tag_infos, batch_n * n_batch_jets, outputs.at(kJetFlavour), output_tags);
     }
   }
 
@@ -0,0 +1,80 @@
+/*
+ * Compares pairs of JetTagCollections jet by jet, and throws if their jets or discriminators differ.
+ * Used to check that DeepFlavour gives the same discriminators with its own sessions and with the
+ * TFBatchService.
+ */
+
+#include "DataFormats/BTauReco/interface/JetTag.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <cmath>
+#include <vector>
+
+class JetTagComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit JetTagComparator(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions&);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  const std::vector<edm::InputTag> referenceTags_;
+  const std::vector<edm::InputTag> testTags_;
+  const double tolerance_;
+  std::vector<edm::EDGetTokenT<reco::JetTagCollection>> referenceTokens_;
+  std::vector<edm::EDGetTokenT<reco::JetTagCollection>> testTokens_;
+};
+
+JetTagComparator::JetTagComparator(const edm::ParameterSet& iConfig)
+    : referenceTags_(iConfig.getParameter<std::vector<edm::InputTag>>("reference")),
+      testTags_(iConfig.getParameter<std::vector<edm::InputTag>>("test")),
+      tolerance_(iConfig.getParameter<double>("tolerance")) {
+  if (referenceTags_.size() != testTags_.size()) {
+    throw cms::Exception("Configuration") << "JetTagComparator: " << referenceTags_.size() << " reference and "
+                                          << testTags_.size() << " test collections";
+  }
+  for (std::size_t i = 0; i < referenceTags_.size(); i++) {
+    referenceTokens_.push_back(consumes<reco::JetTagCollection>(referenceTags_[i]));
+    testTokens_.push_back(consumes<reco::JetTagCollection>(testTags_[i]));
+  }
+}
+
+void JetTagComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<std::vector<edm::InputTag>>("reference", {});
+  desc.add<std::vector<edm::InputTag>>("test", {})->setComment("compared with the reference of the same index");
+  desc.add<double>("tolerance", 1.e-5)->setComment("largest allowed difference of the discriminators");
+  descriptions.add("jetTagComparator", desc);
+}
+
+void JetTagComparator::analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup&) const {
+  for (std::size_t i = 0; i < referenceTokens_.size(); i++) {
+    const auto& reference = iEvent.get(referenceTokens_[i]);
+    const auto& test = iEvent.get(testTokens_[i]);
+    if (reference.size() != test.size()) {
+      throw cms::Exception("JetTagMismatch") << testTags_[i].encode() << " has " << test.size() << " jets, "
+                                             << referenceTags_[i].encode() << " " << reference.size() << " in event "
+                                             << iEvent.id();
+    }
+    for (std::size_t j = 0; j < reference.size(); j++) {
+      if (reference[j].first.key() != test[j].first.key() ||
+          !(std::abs(reference[j].second - test[j].second) <= tolerance_)) {
+        throw cms::Exception("JetTagMismatch")
+            << "jet " << j << " of " << testTags_[i].encode() << " (key " << test[j].first.key() << ") has "
+            << test[j].second << ", " << referenceTags_[i].encode() << " (key " << reference[j].first.key() << ") "
+            << reference[j].second << " in event " << iEvent.id();
+      }
+    }
+  }
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(JetTagComparator);
@@ -0,0 +1,82 @@
+import FWCore.ParameterSet.Config as cms
+from PhysicsTools.PatAlgos.tools.helpers import getPatAlgosToolsTask
+
+# Runs DeepFlavour with its own sessions, jet by jet, and with the TFBatchService, which evaluates
+# the jets of the events of 4 streams together, and checks that the discriminators are the same
+process = cms.Process("PATtest")
+
+## MessageLogger
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+
+## Options and Output Report
+process.options = cms.untracked.PSet(
+    wantSummary = cms.untracked.bool(True),
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(4)
+)
+
+## Source
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring('/store/mc/PhaseIFall16MiniAOD/TT_TuneCUETP8M2T4_13TeV-powheg-pythia8/MINIAODSIM/PhaseIFall16PUFlat20to50_PhaseIFall16_81X_upgrade2017_realistic_v26-v1/50000/08358A47-61E3-E611-8B77-001E677928AE.root')
+)
+## Maximal Number of Events
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(100) )
+
+## Geometry and Detector Conditions (needed for a few patTuple production steps)
+process.load("Configuration.Geometry.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc')
+process.load("Configuration.StandardSequences.MagneticField_cff")
+
+patAlgosToolsTask = getPatAlgosToolsTask(process)
+
+from PhysicsTools.PatAlgos.tools.jetTools import updateJetCollection
+
+updateJetCollection(
+   process,
+   jetSource = cms.InputTag('slimmedJets'),
+   pvSource = cms.InputTag('offlineSlimmedPrimaryVertices'),
+   svSource = cms.InputTag('slimmedSecondaryVertices'),
+   jetCorrections = ('AK4PFchs', cms.vstring(['L1FastJet', 'L2Relative', 'L3Absolute']), 'None'),
+   btagDiscriminators = [
+      'pfDeepFlavourJetTags:probb',
+      'pfDeepFlavourJetTags:probbb',
+      'pfDeepFlavourJetTags:problepb',
+      'pfDeepFlavourJetTags:probc',
+      'pfDeepFlavourJetTags:probuds',
+      'pfDeepFlavourJetTags:probg',
+      'pfNegativeDeepFlavourJetTags:probb',
+      'pfNegativeDeepFlavourJetTags:probbb',
+      'pfNegativeDeepFlavourJetTags:problepb',
+      'pfNegativeDeepFlavourJetTags:probc',
+      'pfNegativeDeepFlavourJetTags:probuds',
+      'pfNegativeDeepFlavourJetTags:probg',
+      ]
+   )
+
+process.TFBatchService = cms.Service("TFBatchService",
+    maxBatchSize = cms.untracked.uint32(64)
+)
+
+# a copy of each DeepFlavour producer evaluates its jets in the service
+reference = []
+test = []
+for label, module in list(process.producers_().items()):
+    if module.type_() == 'DeepFlavourTFJetTagsProducer':
+        setattr(process, label + 'BatchService', module.clone(use_batch_service = True))
+        patAlgosToolsTask.add(getattr(process, label + 'BatchService'))
+        for flavour in module.flav_table.parameterNames_():
+            reference.append(cms.InputTag(label, flavour))
+            test.append(cms.InputTag(label + 'BatchService', flavour))
+
+if not reference:
+    raise RuntimeError('no DeepFlavourTFJetTagsProducer to compare')
+
+process.compareDeepFlavour = cms.EDAnalyzer("JetTagComparator",
+    reference = cms.VInputTag(reference),
+    test = cms.VInputTag(test),
+    tolerance = cms.double(1e-5)
+)
+
+process.p = cms.Path(process.compareDeepFlavour, patAlgosToolsTask)
@@ -2,7 +2,7 @@
 #define RecoEgamma_EgammaElectronProducers_LowPtGsfElectronIDHeavyObjectCache_h
 
 #include "DataFormats/EgammaCandidates/interface/GsfElectronFwd.h"
-#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include <vector>
 
@@ -57,9 +57,15 @@ namespace lowptgsfeleid {
 
     double eval(const std::string& name, const reco::GsfElectronRef&, double rho) const;
 
+    // evaluates the model name for all the electrons at once, output[i] for electrons[i]
+    void eval(const std::string& name,
+              const std::vector<reco::GsfElectronRef>& electrons,
+              double rho,
+              std::vector<float>& output) const;
+
   private:
     std::vector<std::string> names_;
-    std::vector<std::unique_ptr<const GBRForest> > models_;
+    std::vector<std::unique_ptr<const FlatGBRForest> > models_;
     std::vector<double> thresholds_;
   };
 }  // namespace lowptgsfeleid
@@ -1,7 +1,7 @@
 #ifndef RecoEgamma_EgammaElectronProducers_LowPtGsfElectronSeedHeavyObjectCache_h
 #define RecoEgamma_EgammaElectronProducers_LowPtGsfElectronSeedHeavyObjectCache_h
 
-#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "RecoEcal/EgammaCoreTools/interface/EcalClusterLazyTools.h"
 #include <vector>
@@ -64,7 +64,7 @@ namespace lowptgsfeleseed {
 
   private:
     std::vector<std::string> names_;
-    std::vector<std::unique_ptr<const GBRForest> > models_;
+    std::vector<std::unique_ptr<const FlatGBRForest> > models_;
     std::vector<double> thresholds_;
   };
 }  // namespace lowptgsfeleseed
@@ -42,17 +42,15 @@ void LowPtGsfElectronIDProducer::produce(edm::Event& event, const edm::EventSetu
     edm::LogError("Problem with gsfElectrons handle");
   }
 
-  // Iterate through Electrons, evaluate BDT, and store result
-  std::vector<std::vector<float> > output;
-  for (unsigned int iname = 0; iname < names_.size(); ++iname) {
-    output.push_back(std::vector<float>(gsfElectrons->size(), -999.));
-  }
+  // Evaluate each BDT for all the Electrons at once, and store result
+  std::vector<reco::GsfElectronRef> electrons;
+  electrons.reserve(gsfElectrons->size());
   for (unsigned int iele = 0; iele < gsfElectrons->size(); iele++) {
-    reco::GsfElectronRef ele(gsfElectrons, iele);
-    //if ( !passThrough_ && ( ele->pt() < minPtThreshold_ ) ) { continue; }
-    for (unsigned int iname = 0; iname < names_.size(); ++iname) {
-      output[iname][iele] = globalCache()->eval(names_[iname], ele, *rho);
-    }
+    electrons.emplace_back(gsfElectrons, iele);
+  }
+  std::vector<std::vector<float> > output(names_.size());
+  for (unsigned int iname = 0; iname < names_.size(); ++iname) {
+    globalCache()->eval(names_[iname], electrons, *rho, output[iname]);
   }
 
   // Create and put ValueMap in Event
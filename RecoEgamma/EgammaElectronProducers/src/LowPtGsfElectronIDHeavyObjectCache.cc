@@ -108,7 +108,7 @@ namespace lowptgsfeleid {
       names_.push_back(name);
     }
     for (auto& weights : conf.getParameter<std::vector<std::string> >("ModelWeights")) {
-      models_.push_back(createGBRForest(edm::FileInPath(weights)));
+      models_.push_back(createFlatGBRForest(edm::FileInPath(weights)));
     }
     for (auto& thresh : conf.getParameter<std::vector<double> >("ModelThresholds")) {
       thresholds_.push_back(thresh);
@@ -141,4 +141,31 @@ namespace lowptgsfeleid {
     return 0.;
   }
 
+  ////////////////////////////////////////////////////////////////////////////////
+  //
+  void HeavyObjectCache::eval(const std::string& name,
+                              const std::vector<reco::GsfElectronRef>& electrons,
+                              double rho,
+                              std::vector<float>& output) const {
+    std::vector<std::string>::const_iterator iter = std::find(names_.begin(), names_.end(), name);
+    if (iter == names_.end()) {
+      throw cms::Exception("Unknown model name")
+          << "'Name given: '" << name << "'. Check against configuration file.\n";
+    }
+    int index = std::distance(names_.begin(), iter);
+    // features of all the electrons, one row per electron
+    std::vector<float> inputs;
+    unsigned int nFeatures = 0;
+    for (const auto& ele : electrons) {
+      Features features;
+      features.set(ele, rho);
+      std::vector<float> row = features.get();
+      nFeatures = row.size();
+      inputs.insert(inputs.end(), row.begin(), row.end());
+    }
+    std::vector<double> responses(electrons.size());
+    models_.at(index)->GetResponses(inputs.data(), electrons.size(), nFeatures, responses.data());
+    output.assign(responses.begin(), responses.end());
+  }
+
 }  // namespace lowptgsfeleid
@@ -112,7 +112,7 @@ namespace lowptgsfeleseed {
       names_.push_back(name);
     }
     for (auto& weights : conf.getParameter<std::vector<std::string> >("ModelWeights")) {
-      models_.push_back(createGBRForest(edm::FileInPath(weights)));
+      models_.push_back(createFlatGBRForest(edm::FileInPath(weights)));
     }
     for (auto& thresh : conf.getParameter<std::vector<double> >("ModelThresholds")) {
       thresholds_.push_back(thresh);
@@ -12,11 +12,15 @@
 
 #include "CondFormats/EcalObjects/interface/EcalPedestals.h"
 #include "CondFormats/EcalObjects/interface/EcalGainRatios.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseShapes.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseCovariances.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
 
 #include "TMatrixDSym.h"
 #include "TVectorD.h"
 
+#include <vector>
+
 class EcalUncalibRecHitMultiFitAlgo {
 public:
   EcalUncalibRecHitMultiFitAlgo();
@@ -28,6 +32,23 @@ public:
                                     const FullSampleVector &fullpulse,
                                     const FullSampleMatrix &fullpulsecov,
                                     const BXVector &activeBX);
+  /// Same as makeRecHit for each of dataFrames[i], with the pedestals, gain ratios, pulse shape and
+  /// pulse covariance of its crystal in peds[i], gains[i], pulses[i] and pulsecovs[i].
+  /// With the pre-fit, the one-pulse fits of the crystals without gain switch are done for
+  /// batchSize crystals at once; the other fits are done crystal by crystal.
+  void makeRecHits(const std::vector<EcalDataFrame> &dataFrames,
+                   const std::vector<const EcalPedestals::Item *> &peds,
+                   const std::vector<const EcalMGPAGainRatio *> &gains,
+                   const SampleMatrixGainArray &noisecors,
+                   const std::vector<const EcalPulseShapes::Item *> &pulses,
+                   const std::vector<const EcalPulseCovariances::Item *> &pulsecovs,
+                   const BXVector &activeBX,
+                   std::vector<EcalUncalibratedRecHit> &rechits);
+  /// Pulse template and covariance of a crystal as used by makeRecHit
+  static void fillPulse(const EcalPulseShapes::Item &pulse,
+                        const EcalPulseCovariances::Item &pulsecov,
+                        FullSampleVector &fullpulse,
+                        FullSampleMatrix &fullpulsecov);
   void disableErrorCalculation() { _computeErrors = false; }
   void setDoPrefit(bool b) { _doPrefit = b; }
   void setPrefitMaxChiSq(double x) { _prefitMaxChiSq = x; }
@@ -38,7 +59,22 @@ public:
   void setSimplifiedNoiseModelForGainSwitch(bool b) { _simplifiedNoiseModelForGainSwitch = b; }
   void setGainSwitchUseMaxSample(bool b) { _gainSwitchUseMaxSample = b; }
 
+  static constexpr unsigned int batchSize = 8;
+
 private:
+  /// One-pulse pre-fit of the crystals index[0] ... index[n-1] (n <= batchSize), which
+  /// have no gain switch. The crystals with a chi2 above _prefitMaxChiSq are refitted by makeRecHit.
+  void makePrefitRecHits(const std::vector<EcalDataFrame> &dataFrames,
+                         const std::vector<const EcalPedestals::Item *> &peds,
+                         const std::vector<const EcalMGPAGainRatio *> &gains,
+                         const SampleMatrixGainArray &noisecors,
+                         const std::vector<const EcalPulseShapes::Item *> &pulses,
+                         const std::vector<const EcalPulseCovariances::Item *> &pulsecovs,
+                         const BXVector &activeBX,
+                         const unsigned int *index,
+                         unsigned int n,
+                         std::vector<EcalUncalibratedRecHit> &rechits);
+
   PulseChiSqSNNLS _pulsefunc;
   PulseChiSqSNNLS _pulsefuncSingle;
   bool _computeErrors;
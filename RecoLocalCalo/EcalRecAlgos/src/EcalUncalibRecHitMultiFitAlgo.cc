@@ -5,6 +5,9 @@
 #include "CondFormats/EcalObjects/interface/EcalPedestals.h"
 #include "CondFormats/EcalObjects/interface/EcalGainRatios.h"
 
+#include <algorithm>
+#include <cmath>
+
 EcalUncalibRecHitMultiFitAlgo::EcalUncalibRecHitMultiFitAlgo()
     : _computeErrors(true),
       _doPrefit(false),
@@ -223,3 +226,156 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
 
   return rh;
 }
+
+void EcalUncalibRecHitMultiFitAlgo::fillPulse(const EcalPulseShapes::Item &pulse,
+                                              const EcalPulseCovariances::Item &pulsecov,
+                                              FullSampleVector &fullpulse,
+                                              FullSampleMatrix &fullpulsecov) {
+  for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; ++i)
+    fullpulse(i + 7) = pulse.pdfval[i];
+
+  for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; i++)
+    for (int j = 0; j < EcalPulseShape::TEMPLATESAMPLES; j++)
+      fullpulsecov(i + 7, j + 7) = pulsecov.covval[i][j];
+}
+
+void EcalUncalibRecHitMultiFitAlgo::makeRecHits(const std::vector<EcalDataFrame> &dataFrames,
+                                                const std::vector<const EcalPedestals::Item *> &peds,
+                                                const std::vector<const EcalMGPAGainRatio *> &gains,
+                                                const SampleMatrixGainArray &noisecors,
+                                                const std::vector<const EcalPulseShapes::Item *> &pulses,
+                                                const std::vector<const EcalPulseCovariances::Item *> &pulsecovs,
+                                                const BXVector &activeBX,
+                                                std::vector<EcalUncalibratedRecHit> &rechits) {
+  rechits.resize(dataFrames.size());
+
+  // crystals whose pre-fit is done in batches: only gain 12 samples, so that the fit
+  // has a single pulse and the noise covariance is the gain 12 one
+  std::vector<unsigned int> batch;
+  FullSampleVector fullpulse(FullSampleVector::Zero());
+  FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
+  for (unsigned int i = 0; i < dataFrames.size(); ++i) {
+    const EcalDataFrame &dataFrame = dataFrames[i];
+    bool gain12 = true;
+    for (unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; ++iSample)
+      gain12 &= dataFrame.sample(iSample).gainId() == EcalMgpaBitwiseGain12;
+    if (_doPrefit && !_dynamicPedestals && gain12) {
+      batch.push_back(i);
+    } else {
+      fillPulse(*pulses[i], *pulsecovs[i], fullpulse, fullpulsecov);
+      rechits[i] = makeRecHit(dataFrame, peds[i], gains[i], noisecors, fullpulse, fullpulsecov, activeBX);
+    }
+  }
+
+  for (unsigned int first = 0; first < batch.size(); first += batchSize) {
+    unsigned int n = std::min<unsigned int>(batchSize, batch.size() - first);
+    makePrefitRecHits(
+        dataFrames, peds, gains, noisecors, pulses, pulsecovs, activeBX, &batch[first], n, rechits);
+  }
+}
+
+void EcalUncalibRecHitMultiFitAlgo::makePrefitRecHits(const std::vector<EcalDataFrame> &dataFrames,
+                                                      const std::vector<const EcalPedestals::Item *> &peds,
+                                                      const std::vector<const EcalMGPAGainRatio *> &gains,
+                                                      const SampleMatrixGainArray &noisecors,
+                                                      const std::vector<const EcalPulseShapes::Item *> &pulses,
+                                                      const std::vector<const EcalPulseCovariances::Item *> &pulsecovs,
+                                                      const BXVector &activeBX,
+                                                      const unsigned int *index,
+                                                      unsigned int n,
+                                                      std::vector<EcalUncalibratedRecHit> &rechits) {
+  // Same computation as the single iteration of _pulsefuncSingle.DoFit, the value of lane l
+  // for a sample i being at [i][l]. The unused lanes repeat the first crystal.
+  constexpr unsigned int N = batchSize;
+  constexpr unsigned int nsample = SampleVector::RowsAtCompileTime;
+  constexpr unsigned int firstsample = 3;  // first sample of the in-time pulse template
+  const SampleMatrix &noisecor = noisecors[0];
+  const double pedunc2 = _addPedestalUncertainty > 0. ? _addPedestalUncertainty * _addPedestalUncertainty : 0.;
+
+  constexpr unsigned int npulsesample = nsample - firstsample;
+
+  double amplitudes[nsample][N], pulse[nsample][N], rms2[N], amp[N];
+  double pulsecov[npulsesample][npulsesample][N], invcov[nsample][nsample][N];
+  for (unsigned int l = 0; l < N; ++l) {
+    const unsigned int i = index[l < n ? l : 0];
+    const EcalPedestals::Item *aped = peds[i];
+    for (unsigned int iSample = 0; iSample < nsample; ++iSample) {
+      amplitudes[iSample][l] = (double)(dataFrames[i].sample(iSample).adc()) - aped->mean_x12;
+      pulse[iSample][l] = iSample < firstsample ? 0. : pulses[i]->pdfval[iSample - firstsample];
+    }
+    for (unsigned int iSample = 0; iSample < npulsesample; ++iSample)
+      for (unsigned int jSample = 0; jSample < npulsesample; ++jSample)
+        pulsecov[iSample][jSample][l] = pulsecovs[i]->covval[iSample][jSample];
+    rms2[l] = aped->rms_x12 * aped->rms_x12;
+    // the fit starts from the amplitude of the maximum sample
+    amp[l] = amplitudes[5][l];
+  }
+
+  // noise covariance plus the pulse shape one for the starting amplitude (updateCov)
+  for (unsigned int i = 0; i < nsample; ++i)
+    for (unsigned int j = 0; j <= i; ++j)
+      for (unsigned int l = 0; l < N; ++l) {
+        invcov[i][j][l] = rms2[l] * noisecor(i, j) + pedunc2;
+        if (j >= firstsample)
+          invcov[i][j][l] += amp[l] * amp[l] * pulsecov[i - firstsample][j - firstsample][l];
+      }
+
+  // Cholesky decomposition in place
+  bool failed[N] = {};
+  for (unsigned int j = 0; j < nsample; ++j) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double d = invcov[j][j][l];
+      for (unsigned int k = 0; k < j; ++k)
+        d -= invcov[j][k][l] * invcov[j][k][l];
+      if (!(d > 0.)) {
+        failed[l] = true;
+        d = 1.;
+      }
+      invcov[j][j][l] = std::sqrt(d);
+    }
+    for (unsigned int i = j + 1; i < nsample; ++i)
+      for (unsigned int l = 0; l < N; ++l) {
+        double s = invcov[i][j][l];
+        for (unsigned int k = 0; k < j; ++k)
+          s -= invcov[i][k][l] * invcov[j][k][l];
+        invcov[i][j][l] = s / invcov[j][j][l];
+      }
+  }
+
+  // OnePulseMinimize and ComputeChiSq
+  double invcovp[nsample][N], invcovs[nsample][N];
+  double aTa[N] = {}, aTb[N] = {}, chisq[N] = {};
+  for (unsigned int i = 0; i < nsample; ++i)
+    for (unsigned int l = 0; l < N; ++l) {
+      double p = pulse[i][l], s = amplitudes[i][l];
+      for (unsigned int k = 0; k < i; ++k) {
+        p -= invcov[i][k][l] * invcovp[k][l];
+        s -= invcov[i][k][l] * invcovs[k][l];
+      }
+      invcovp[i][l] = p / invcov[i][i][l];
+      invcovs[i][l] = s / invcov[i][i][l];
+      aTa[l] += invcovp[i][l] * invcovp[i][l];
+      aTb[l] += invcovp[i][l] * invcovs[i][l];
+    }
+  for (unsigned int l = 0; l < N; ++l)
+    amp[l] = std::max(0., aTb[l] / aTa[l]);
+  for (unsigned int i = 0; i < nsample; ++i)
+    for (unsigned int l = 0; l < N; ++l) {
+      double r = amp[l] * invcovp[i][l] - invcovs[i][l];
+      chisq[l] += r * r;
+    }
+
+  FullSampleVector fullpulse(FullSampleVector::Zero());
+  FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
+  for (unsigned int l = 0; l < n; ++l) {
+    const unsigned int i = index[l];
+    if (failed[l] || !(chisq[l] < _prefitMaxChiSq)) {
+      // covariance not positive definite or bad pre-fit: the full fit of the crystal
+      fillPulse(*pulses[i], *pulsecovs[i], fullpulse, fullpulsecov);
+      rechits[i] = makeRecHit(dataFrames[i], peds[i], gains[i], noisecors, fullpulse, fullpulsecov, activeBX);
+      continue;
+    }
+    rechits[i] = EcalUncalibratedRecHit(dataFrames[i].id(), amp[l], peds[i]->mean_x12, 0., chisq[l], 0);
+    rechits[i].setAmplitudeError(0.);
+  }
+}
@@ -0,0 +1,206 @@
+/* Unit test for EcalUncalibRecHitMultiFitAlgo: the multifit of all the digis of an event
+   (makeRecHits) gives the same uncalibrated rechits as makeRecHit crystal by crystal
+
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitMultiFitAlgo.h"
+#include "DataFormats/EcalDetId/interface/EBDetId.h"
+#include "DataFormats/EcalDigi/interface/EcalDataFrame.h"
+#include "DataFormats/EcalRecHit/interface/EcalUncalibratedRecHit.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+class testEcalUncalibRecHitMultiFitAlgo : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testEcalUncalibRecHitMultiFitAlgo);
+  CPPUNIT_TEST(testWithPrefit);
+  CPPUNIT_TEST(testWithoutPrefit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown() {}
+
+  void testWithPrefit() { compare(true); }
+  void testWithoutPrefit() { compare(false); }
+
+private:
+  void addCrystal(double inTime, int bxPileup, double pileup, bool gainSwitch);
+  void compare(bool prefit);
+
+  static constexpr unsigned int nCrystals = 103;
+  static constexpr double prefitMaxChiSq = 25.;
+
+  std::mt19937 engine_;
+  SampleMatrixGainArray noisecors_;
+  BXVector activeBX_;
+  std::vector<EcalPedestals::Item> peds_;
+  std::vector<EcalMGPAGainRatio> gains_;
+  std::vector<EcalPulseShapes::Item> pulses_;
+  std::vector<EcalPulseCovariances::Item> pulsecovs_;
+  std::vector<std::array<uint16_t, EcalDataFrame::MAXSAMPLES>> samples_;
+  std::vector<EcalDataFrame> dataFrames_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testEcalUncalibRecHitMultiFitAlgo);
+
+namespace {
+  // barrel pulse shape, the maximum is in sample 2 of the template (sample 5 of the digi)
+  const double pulseShape[EcalPulseShape::TEMPLATESAMPLES] = {1.13979e-02,
+                                                               7.58151e-01,
+                                                               1.00000e+00,
+                                                               8.87744e-01,
+                                                               6.73548e-01,
+                                                               4.74332e-01,
+                                                               3.19561e-01,
+                                                               2.15144e-01,
+                                                               1.47464e-01,
+                                                               1.01087e-01,
+                                                               6.93181e-02,
+                                                               4.75044e-02};
+  const double noiseCorrelation[EcalDataFrame::MAXSAMPLES] = {
+      1.00000, 0.71073, 0.55721, 0.46089, 0.40449, 0.35931, 0.33924, 0.32439, 0.31581, 0.30481};
+}  // namespace
+
+void testEcalUncalibRecHitMultiFitAlgo::setUp() {
+  engine_.seed(7);
+  for (auto& noisecor : noisecors_)
+    for (int i = 0; i < noisecor.rows(); ++i)
+      for (int j = 0; j < noisecor.cols(); ++j)
+        noisecor(i, j) = noiseCorrelation[std::abs(i - j)];
+  activeBX_.resize(10);
+  activeBX_ << -5, -4, -3, -2, -1, 0, 1, 2, 3, 4;
+
+  peds_.reserve(nCrystals);
+  gains_.reserve(nCrystals);
+  pulses_.reserve(nCrystals);
+  pulsecovs_.reserve(nCrystals);
+  samples_.reserve(nCrystals);
+
+  // no signal, an in-time pulse, an in-time pulse with a large pileup pulse (whose one-pulse
+  // pre-fit chi2 is above prefitMaxChiSq) and a pulse switching to gain 6
+  addCrystal(0., 0, 0., false);
+  addCrystal(50., 0, 0., false);
+  addCrystal(50., -2, 400., false);
+  addCrystal(6000., 0, 0., true);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::exponential_distribution<double> amplitude(1. / 30.);
+  while (samples_.size() < nCrystals) {
+    double inTime = uniform(engine_) < 0.4 ? 0. : amplitude(engine_);
+    bool withPileup = uniform(engine_) < 0.3;
+    addCrystal(inTime,
+               withPileup ? int(uniform(engine_) * 8) - 4 : 0,
+               withPileup ? amplitude(engine_) : 0.,
+               uniform(engine_) < 0.05);
+  }
+  dataFrames_.clear();
+  for (unsigned int c = 0; c < nCrystals; ++c)
+    dataFrames_.emplace_back(
+        edm::DataFrame(EBDetId(1 + c / 360, 1 + c % 360).rawId(), samples_[c].data(), EcalDataFrame::MAXSAMPLES));
+}
+
+void testEcalUncalibRecHitMultiFitAlgo::addCrystal(double inTime, int bxPileup, double pileup, bool gainSwitch) {
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> gauss(0., 1.);
+
+  EcalPedestals::Item ped;
+  ped.mean_x12 = 200. + 10. * uniform(engine_);
+  ped.rms_x12 = 1. + 0.3 * uniform(engine_);
+  ped.mean_x6 = 200.;
+  ped.rms_x6 = 0.8;
+  ped.mean_x1 = 200.;
+  ped.rms_x1 = 0.6;
+  peds_.push_back(ped);
+
+  EcalMGPAGainRatio gain;
+  gain.setGain12Over6(2.);
+  gain.setGain6Over1(6.);
+  gains_.push_back(gain);
+
+  EcalPulseShapes::Item pulse;
+  EcalPulseCovariances::Item pulsecov;
+  double fluctuation[EcalPulseShape::TEMPLATESAMPLES];
+  for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; ++i) {
+    pulse.pdfval[i] = pulseShape[i] * (1. + 0.02 * gauss(engine_));
+    fluctuation[i] = 3.e-3 * gauss(engine_) * pulseShape[i];
+  }
+  for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; ++i)
+    for (int j = 0; j < EcalPulseShape::TEMPLATESAMPLES; ++j)
+      pulsecov.covval[i][j] = fluctuation[i] * fluctuation[j] + (i == j ? 1.e-6 : 0.);
+  pulses_.push_back(pulse);
+  pulsecovs_.push_back(pulsecov);
+
+  std::array<uint16_t, EcalDataFrame::MAXSAMPLES> samples;
+  for (int i = 0; i < EcalDataFrame::MAXSAMPLES; ++i) {
+    double signal = 0.;
+    if (i >= 3)
+      signal += inTime * pulse.pdfval[i - 3];
+    int k = i - 3 - bxPileup;
+    if (k >= 0 && k < EcalPulseShape::TEMPLATESAMPLES)
+      signal += pileup * pulseShape[k];
+    // the samples around the maximum switch to gain 6 when they would be above the gain 12 range
+    if (gainSwitch && signal + ped.mean_x12 > 4000.) {
+      int adc = ped.mean_x6 + signal / gain.gain12Over6() + ped.rms_x6 * gauss(engine_);
+      samples[i] = EcalMGPASample(adc, EcalMgpaBitwiseGain6).raw();
+    } else {
+      int adc = ped.mean_x12 + signal + ped.rms_x12 * gauss(engine_);
+      samples[i] = EcalMGPASample(std::min(4095, std::max(0, adc)), EcalMgpaBitwiseGain12).raw();
+    }
+  }
+  samples_.push_back(samples);
+}
+
+void testEcalUncalibRecHitMultiFitAlgo::compare(bool prefit) {
+  EcalUncalibRecHitMultiFitAlgo single, batch;
+  for (auto algo : {&single, &batch}) {
+    algo->setDoPrefit(prefit);
+    algo->setPrefitMaxChiSq(prefitMaxChiSq);
+  }
+
+  std::vector<const EcalPedestals::Item*> peds;
+  std::vector<const EcalMGPAGainRatio*> gains;
+  std::vector<const EcalPulseShapes::Item*> pulses;
+  std::vector<const EcalPulseCovariances::Item*> pulsecovs;
+  for (unsigned int c = 0; c < nCrystals; ++c) {
+    peds.push_back(&peds_[c]);
+    gains.push_back(&gains_[c]);
+    pulses.push_back(&pulses_[c]);
+    pulsecovs.push_back(&pulsecovs_[c]);
+  }
+  std::vector<EcalUncalibratedRecHit> rechits;
+  batch.makeRecHits(dataFrames_, peds, gains, noisecors_, pulses, pulsecovs, activeBX_, rechits);
+  CPPUNIT_ASSERT_EQUAL(dataFrames_.size(), rechits.size());
+
+  unsigned int nGainSwitch = 0;
+  FullSampleVector fullpulse(FullSampleVector::Zero());
+  FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
+  for (unsigned int c = 0; c < nCrystals; ++c) {
+    EcalUncalibRecHitMultiFitAlgo::fillPulse(pulses_[c], pulsecovs_[c], fullpulse, fullpulsecov);
+    EcalUncalibratedRecHit ref =
+        single.makeRecHit(dataFrames_[c], peds[c], gains[c], noisecors_, fullpulse, fullpulsecov, activeBX_);
+    const EcalUncalibratedRecHit& rechit = rechits[c];
+    nGainSwitch += dataFrames_[c].hasSwitchToGain6();
+
+    CPPUNIT_ASSERT_EQUAL(ref.id().rawId(), rechit.id().rawId());
+    CPPUNIT_ASSERT_EQUAL(ref.flags(), rechit.flags());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ref.amplitude(), rechit.amplitude(), 1.e-4 * std::max(1.f, std::abs(ref.amplitude())));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(
+        ref.amplitudeError(), rechit.amplitudeError(), 1.e-4 * std::max(1.f, ref.amplitudeError()));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ref.pedestal(), rechit.pedestal(), 1.e-4 * std::max(1.f, std::abs(ref.pedestal())));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ref.jitter(), rechit.jitter(), 1.e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ref.chi2(), rechit.chi2(), 1.e-4 * std::max(1.f, ref.chi2()));
+    for (int bx = 0; bx < EcalDataFrame::MAXSAMPLES; ++bx)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(ref.outOfTimeAmplitude(bx),
+                                   rechit.outOfTimeAmplitude(bx),
+                                   1.e-4 * std::max(1.f, std::abs(ref.outOfTimeAmplitude(bx))));
+  }
+  CPPUNIT_ASSERT(nGainSwitch > 0);
+
+  // the crystal with the pileup pulse in bx -2 goes to the multi-pulse fit also with the pre-fit
+  CPPUNIT_ASSERT(rechits[2].outOfTimeAmplitude(3) > 100.);
+}
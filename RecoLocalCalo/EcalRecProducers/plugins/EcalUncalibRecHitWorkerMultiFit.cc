@@ -132,6 +132,10 @@ void EcalUncalibRecHitWorkerMultiFit::set(const edm::EventSetup& es) {
   // for the time correction methods
   es.get<EcalTimeBiasCorrectionsRcd>().get(timeCorrBias_);
 
+  // the noise correlation matrices are only rebuilt when the conditions change
+  if (!noiseCorrelationWatcher_.check(es))
+    return;
+
   int nnoise = SampleVector::RowsAtCompileTime;
   SampleMatrix& noisecorEBg12 = noisecors_[1][0];
   SampleMatrix& noisecorEBg6 = noisecors_[1][1];
@@ -264,6 +268,32 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
   FullSampleVector fullpulse(FullSampleVector::Zero());
   FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
 
+  // the multifit of all the digis without saturated sample is done first, at once
+  fitFrames_.clear();
+  fitPeds_.clear();
+  fitGains_.clear();
+  fitPulses_.clear();
+  fitPulseCovs_.clear();
+  for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg) {
+    const EcalDataFrame frame(*itdg);
+    bool saturated = false;
+    for (unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++)
+      saturated |= frame.sample(iSample).gainId() == 0;
+    if (saturated)
+      continue;
+    DetId detid(itdg->id());
+    unsigned int hashedIndex = barrel ? EBDetId(detid).hashedIndex() : EEDetId(detid).hashedIndex();
+    fitFrames_.push_back(frame);
+    fitPeds_.push_back(barrel ? &peds->barrel(hashedIndex) : &peds->endcap(hashedIndex));
+    fitGains_.push_back(barrel ? &gains->barrel(hashedIndex) : &gains->endcap(hashedIndex));
+    fitPulses_.push_back(barrel ? &pulseshapes->barrel(hashedIndex) : &pulseshapes->endcap(hashedIndex));
+    fitPulseCovs_.push_back(barrel ? &pulsecovariances->barrel(hashedIndex)
+                                   : &pulsecovariances->endcap(hashedIndex));
+  }
+  multiFitMethod_.makeRecHits(
+      fitFrames_, fitPeds_, fitGains_, noisecor(barrel), fitPulses_, fitPulseCovs_, activeBX, fitRecHits_);
+  auto fitRecHit = fitRecHits_.begin();
+
   result.reserve(result.size() + digis.size());
   for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg) {
     DetId detid(itdg->id());
@@ -301,12 +331,7 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
     double pedRMSVec[3] = {aped->rms_x12, aped->rms_x6, aped->rms_x1};
     double gainRatios[3] = {1., aGain->gain12Over6(), aGain->gain6Over1() * aGain->gain12Over6()};
 
-    for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; ++i)
-      fullpulse(i + 7) = aPulse->pdfval[i];
-
-    for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; i++)
-      for (int j = 0; j < EcalPulseShape::TEMPLATESAMPLES; j++)
-        fullpulsecov(i + 7, j + 7) = aPulseCov->covval[i][j];
+    EcalUncalibRecHitMultiFitAlgo::fillPulse(*aPulse, *aPulseCov, fullpulse, fullpulsecov);
 
     // compute the right bin of the pulse shape using time calibration constants
     EcalTimeCalibConstantMap::const_iterator it = itime->find(detid);
@@ -348,10 +373,8 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
       // do not propagate the default chi2 = -1 value to the calib rechit (mapped to 64), set it to 0 when saturation
       uncalibRecHit.setChi2(0);
     } else {
-      // multifit
-      const SampleMatrixGainArray& noisecors = noisecor(barrel);
-
-      result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+      // multifit, already done
+      result.push_back(*fitRecHit++);
       auto& uncalibRecHit = result.back();
 
       // === time computation ===
@@ -15,6 +15,7 @@
 #include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitRecChi2Algo.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitRatioMethodAlgo.h"
 #include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "CondFormats/EcalObjects/interface/EcalTimeCalibConstants.h"
 #include "CondFormats/EcalObjects/interface/EcalTimeOffsetConstant.h"
@@ -27,8 +28,11 @@
 #include "CondFormats/EcalObjects/interface/EcalSamplesCorrelation.h"
 #include "CondFormats/EcalObjects/interface/EcalPulseShapes.h"
 #include "CondFormats/EcalObjects/interface/EcalPulseCovariances.h"
+#include "CondFormats/DataRecord/interface/EcalSamplesCorrelationRcd.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
 
+#include <vector>
+
 namespace edm {
   class Event;
   class EventSetup;
@@ -68,6 +72,15 @@ private:
   bool ampErrorCalculation_;
   bool useLumiInfoRunHeader_;
   EcalUncalibRecHitMultiFitAlgo multiFitMethod_;
+  edm::ESWatcher<EcalSamplesCorrelationRcd> noiseCorrelationWatcher_;
+
+  // inputs and results of the multifit of the digis of an event
+  std::vector<EcalDataFrame> fitFrames_;
+  std::vector<const EcalPedestals::Item*> fitPeds_;
+  std::vector<const EcalMGPAGainRatio*> fitGains_;
+  std::vector<const EcalPulseShapes::Item*> fitPulses_;
+  std::vector<const EcalPulseCovariances::Item*> fitPulseCovs_;
+  std::vector<EcalUncalibratedRecHit> fitRecHits_;
 
   int bunchSpacingManual_;
   edm::EDGetTokenT<unsigned int> bunchSpacing_;
@@ -1,6 +1,8 @@
 #ifndef RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
 #define RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
 
+#include <vector>
+
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "DataFormats/HcalRecHit/interface/HBHERecHit.h"
 #include "DataFormats/HcalRecHit/interface/HBHEChannelInfo.h"
@@ -50,6 +52,21 @@ public:
                                  const HcalRecoParam* params,
                                  const HcalCalibrations& calibs,
                                  bool isRealData) = 0;
+
+  // Reconstruction of all the channels of an event at once, rechits[i]
+  // being the rechit of infos[i] (with the same conventions as above).
+  // Algorithms which can share work between channels override this;
+  // by default, "reconstruct" is called for each channel.
+  inline virtual void reconstructBatch(const std::vector<HBHEChannelInfo>& infos,
+                                       const std::vector<const HcalRecoParam*>& params,
+                                       const std::vector<const HcalCalibrations*>& calibs,
+                                       const bool isRealData,
+                                       std::vector<HBHERecHit>& rechits) {
+    rechits.clear();
+    rechits.reserve(infos.size());
+    for (unsigned i = 0; i < infos.size(); ++i)
+      rechits.push_back(reconstruct(infos[i], params[i], *calibs[i], isRealData));
+  }
 };
 
 #endif  // RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
@@ -14,6 +14,10 @@
 
 #include <Math/Functor.h>
 
+#include <map>
+#include <memory>
+#include <vector>
+
 struct MahiNnlsWorkspace {
   unsigned int nPulseTot;
   unsigned int tsSize;
@@ -91,6 +95,14 @@ struct MahiDebugInfo {
   float nPulse[MaxSVSize];
 };
 
+// Result of the fit of one channel by MahiFit::phase1ApplyBatch
+struct MahiFitResult {
+  float energy;
+  float time;
+  float chi2;
+  bool useTriple;
+};
+
 class MahiFit {
 public:
   MahiFit();
@@ -117,6 +129,15 @@ public:
                    bool& useTriple,
                    float& chi2) const;
 
+  // Fit of channels[0] ... channels[n-1] using the pulse shapes shapes[i], results[i] is
+  // what phase1Apply gives for channels[i] (within the numerical precision). The 1-pulse
+  // pre-fits are done for groups of channels with the same shape and number of samples
+  // at once, the multi-pulse fits are done channel by channel.
+  void phase1ApplyBatch(const std::vector<const HBHEChannelInfo*>& channels,
+                        const std::vector<const HcalPulseShapes::Shape*>& shapes,
+                        const HcalTimeSlew* hcalTimeSlewDelay,
+                        std::vector<MahiFitResult>& results);
+
   void phase1Debug(const HBHEChannelInfo& channelData, MahiDebugInfo& mdi) const;
 
   void doFit(std::array<float, 3>& correctedOutput, const int nbx) const;
@@ -129,6 +150,21 @@ public:
   const HcalTimeSlew* hcalTimeSlewDelay_ = nullptr;
 
 private:
+  // Fills the workspace with the samples and noise terms of the channel, returns
+  // false if the channel is below the threshold and should not be fitted
+  bool prepareChannel(const HBHEChannelInfo& channelData) const;
+
+  // Fit of the channel prepared in the workspace, returns true if the multi-pulse fit was used
+  bool fitChannel(std::array<float, 3>& reconstructedVals) const;
+
+  // 1-pulse pre-fit of the channels[index[0]] ... channels[index[n-1]], all with nSamples()
+  // equal to NS, with the current pulse shape; n <= batchSize_
+  template <unsigned int NS>
+  void onePulseFitBatch(const std::vector<const HBHEChannelInfo*>& channels,
+                        const unsigned int* index,
+                        unsigned int n,
+                        std::vector<MahiFitResult>& results) const;
+
   double minimize() const;
   void onePulseMinimize() const;
   void updateCov() const;
@@ -155,6 +191,9 @@ private:
 
   static constexpr int pedestalBX_ = 100;
 
+  // number of channels pre-fitted together by phase1ApplyBatch
+  static constexpr unsigned int batchSize_ = 8;
+
   // used to restrict returned time value to a 25 ns window centered
   // on the nominal arrival time
   static constexpr float timeLimit_ = 12.5;
@@ -186,7 +225,10 @@ private:
 
   //for pulse shapes
   int cntsetPulseShape_;
-  std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
+  FitterFuncs::PulseShapeFunctor* psfPtr_ = nullptr;
   std::unique_ptr<ROOT::Math::Functor> pfunctor_;
+
+  // pulse shape templates, built once for each shape
+  std::map<const HcalPulseShapes::Shape*, std::unique_ptr<FitterFuncs::PulseShapeFunctor>> pulseShapeCache_;
 };
 #endif
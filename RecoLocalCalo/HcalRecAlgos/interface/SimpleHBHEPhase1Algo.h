@@ -61,6 +61,14 @@ public:
                          const HcalRecoParam* params,
                          const HcalCalibrations& calibs,
                          bool isRealData) override;
+
+  // Mahi fits of all the channels are done together (see MahiFit::phase1ApplyBatch)
+  void reconstructBatch(const std::vector<HBHEChannelInfo>& infos,
+                        const std::vector<const HcalRecoParam*>& params,
+                        const std::vector<const HcalCalibrations*>& calibs,
+                        bool isRealData,
+                        std::vector<HBHERecHit>& rechits) override;
+
   // Basic accessors
   inline int getFirstSampleShift() const { return firstSampleShift_; }
   inline int getSamplesToAdd() const { return samplesToAdd_; }
@@ -91,6 +99,14 @@ protected:
                int nSamplesToExamine) const;
 
 private:
+  // The rechit of one channel. If not null, mahiResult is the result of
+  // the Mahi fit of this channel which is then not repeated.
+  HBHERecHit reconstructChannel(const HBHEChannelInfo& info,
+                                const HcalRecoParam* params,
+                                const HcalCalibrations& calibs,
+                                bool isRealData,
+                                const MahiFitResult* mahiResult);
+
   HcalPulseContainmentManager pulseCorr_;
 
   int firstSampleShift_;
@@ -110,6 +126,11 @@ private:
   // Mahi algorithm
   std::unique_ptr<MahiFit> mahiOOTpuCorr_;
 
+  // Work space for reconstructBatch
+  std::vector<const HBHEChannelInfo*> mahiChannels_;
+  std::vector<const HcalPulseShapes::Shape*> mahiShapes_;
+  std::vector<MahiFitResult> mahiResults_;
+
   HcalPulseShapes theHcalPulseShapes_;
 };
 
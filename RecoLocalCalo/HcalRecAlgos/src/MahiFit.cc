@@ -1,6 +1,8 @@
 #include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <algorithm>
+
 MahiFit::MahiFit() : fullTSSize_(19), fullTSofInterest_(8) {}
 
 void MahiFit::setParameters(bool iDynamicPed,
@@ -49,6 +51,23 @@ void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
                           float& chi2) const {
   assert(channelData.nSamples() == 8 || channelData.nSamples() == 10);
 
+  std::array<float, 3> reconstructedVals{{0.0, -9999, -9999}};
+
+  useTriple = false;
+  if (prepareChannel(channelData)) {
+    useTriple = fitChannel(reconstructedVals);
+  } else {
+    reconstructedVals.at(0) = 0.;      //energy
+    reconstructedVals.at(1) = -9999.;  //time
+    reconstructedVals.at(2) = -9999.;  //chi2
+  }
+
+  reconstructedEnergy = reconstructedVals[0] * channelData.tsGain(0);
+  reconstructedTime = reconstructedVals[1];
+  chi2 = reconstructedVals[2];
+}
+
+bool MahiFit::prepareChannel(const HBHEChannelInfo& channelData) const {
   resetWorkspace();
 
   nnlsWork_.tsSize = channelData.nSamples();
@@ -71,8 +90,6 @@ void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
   nnlsWork_.amplitudes.resize(nnlsWork_.tsSize);
   nnlsWork_.noiseTerms.resize(nnlsWork_.tsSize);
 
-  std::array<float, 3> reconstructedVals{{0.0, -9999, -9999}};
-
   double tsTOT = 0, tstrig = 0;  // in GeV
   for (unsigned int iTS = 0; iTS < nnlsWork_.tsSize; ++iTS) {
     double charge = channelData.tsRawCharge(iTS);
@@ -101,28 +118,216 @@ void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
     }
   }
 
-  useTriple = false;
-  if (tstrig >= ts4Thresh_ && tsTOT > 0) {
-    // only do pre-fit with 1 pulse if chiSq threshold is positive
-    if (chiSqSwitch_ > 0) {
-      doFit(reconstructedVals, 1);
-      if (reconstructedVals[2] > chiSqSwitch_) {
-        doFit(reconstructedVals, 0);  //nbx=0 means use configured BXs
-        useTriple = true;
+  return tstrig >= ts4Thresh_ && tsTOT > 0;
+}
+
+bool MahiFit::fitChannel(std::array<float, 3>& reconstructedVals) const {
+  // only do pre-fit with 1 pulse if chiSq threshold is positive
+  if (chiSqSwitch_ > 0) {
+    doFit(reconstructedVals, 1);
+    if (reconstructedVals[2] > chiSqSwitch_) {
+      doFit(reconstructedVals, 0);  //nbx=0 means use configured BXs
+      return true;
+    }
+    return false;
+  }
+  doFit(reconstructedVals, 0);
+  return true;
+}
+
+template <unsigned int NS>
+void MahiFit::onePulseFitBatch(const std::vector<const HBHEChannelInfo*>& channels,
+                               const unsigned int* index,
+                               unsigned int n,
+                               std::vector<MahiFitResult>& results) const {
+  // Same iterations as minimize() with one pulse, the value of lane l of a sample i being
+  // at [i][l]. The unused lanes repeat the first channel and are not looked at.
+  constexpr unsigned int N = batchSize_;
+  double amplitudes[NS][N], noiseTerms[NS][N], pedConstraint[N];
+  double pulse[NS][N], pulseDeriv[NS][N], pulseCov[NS][NS][N];
+
+  FullSampleVector pulseShapeArray, pulseDerivArray;
+  for (unsigned int l = 0; l < N; ++l) {
+    prepareChannel(*channels[index[l < n ? l : 0]]);
+    pulseShapeArray.setZero(NS);
+    pulseDerivArray.setZero(NS);
+    nnlsWork_.pulseCovArray[0].setZero(NS, NS);
+    updatePulseShape(nnlsWork_.amplitudes.coeff(nnlsWork_.tsOffset),
+                     pulseShapeArray,
+                     pulseDerivArray,
+                     nnlsWork_.pulseCovArray[0]);
+    pedConstraint[l] = nnlsWork_.pedConstraint.coeff(0, 0);
+    for (unsigned int i = 0; i < NS; ++i) {
+      amplitudes[i][l] = nnlsWork_.amplitudes.coeff(i);
+      noiseTerms[i][l] = nnlsWork_.noiseTerms.coeff(i);
+      pulse[i][l] = pulseShapeArray.coeff(i);
+      pulseDeriv[i][l] = pulseDerivArray.coeff(i);
+      for (unsigned int j = 0; j < NS; ++j)
+        pulseCov[i][j][l] = nnlsWork_.pulseCovArray[0].coeff(i, j);
+    }
+  }
+
+  double amp[N] = {}, chiSq[N], oldChiSq[N];
+  bool active[N], failed[N] = {};
+  unsigned int nActive = n;
+  for (unsigned int l = 0; l < N; ++l) {
+    chiSq[l] = oldChiSq[l] = 9999;
+    active[l] = l < n;
+  }
+
+  double covL[NS][NS][N], invcovp[NS][N], invcova[NS][N];
+  for (int iter = 1; iter < nMaxItersMin_ && nActive > 0; ++iter) {
+    // Cholesky decomposition of the covariance (updateCov), in the lower triangle of covL
+    for (unsigned int i = 0; i < NS; ++i)
+      for (unsigned int j = 0; j <= i; ++j)
+        for (unsigned int l = 0; l < N; ++l)
+          covL[i][j][l] = (i == j ? noiseTerms[i][l] : 0.) + pedConstraint[l] + amp[l] * amp[l] * pulseCov[i][j][l];
+    for (unsigned int j = 0; j < NS; ++j) {
+      for (unsigned int l = 0; l < N; ++l) {
+        double d = covL[j][j][l];
+        for (unsigned int k = 0; k < j; ++k)
+          d -= covL[j][k][l] * covL[j][k][l];
+        // not positive definite, this lane is left to the scalar fit
+        if (!(d > 0.)) {
+          failed[l] = failed[l] || active[l];
+          d = 1.;
+        }
+        covL[j][j][l] = std::sqrt(d);
       }
-    } else {
+      for (unsigned int i = j + 1; i < NS; ++i)
+        for (unsigned int l = 0; l < N; ++l) {
+          double s = covL[i][j][l];
+          for (unsigned int k = 0; k < j; ++k)
+            s -= covL[i][k][l] * covL[j][k][l];
+          covL[i][j][l] = s / covL[j][j][l];
+        }
+    }
+
+    // onePulseMinimize and calculateChiSq
+    double aTa[N] = {}, aTb[N] = {}, newChiSq[N] = {}, newAmp[N];
+    for (unsigned int i = 0; i < NS; ++i)
+      for (unsigned int l = 0; l < N; ++l) {
+        double p = pulse[i][l], a = amplitudes[i][l];
+        for (unsigned int k = 0; k < i; ++k) {
+          p -= covL[i][k][l] * invcovp[k][l];
+          a -= covL[i][k][l] * invcova[k][l];
+        }
+        invcovp[i][l] = p / covL[i][i][l];
+        invcova[i][l] = a / covL[i][i][l];
+        aTa[l] += invcovp[i][l] * invcovp[i][l];
+        aTb[l] += invcovp[i][l] * invcova[i][l];
+      }
+    for (unsigned int l = 0; l < N; ++l)
+      newAmp[l] = std::max(0., aTb[l] / aTa[l]);
+    for (unsigned int i = 0; i < NS; ++i)
+      for (unsigned int l = 0; l < N; ++l) {
+        double r = newAmp[l] * invcovp[i][l] - invcova[i][l];
+        newChiSq[l] += r * r;
+      }
+
+    // convergence of minimize(), lane by lane
+    for (unsigned int l = 0; l < N; ++l) {
+      if (!active[l])
+        continue;
+      if (failed[l]) {
+        active[l] = false;
+        --nActive;
+        continue;
+      }
+      amp[l] = newAmp[l];
+      double deltaChiSq = newChiSq[l] - chiSq[l];
+      if (newChiSq[l] == oldChiSq[l] && newChiSq[l] < chiSq[l]) {
+        active[l] = false;
+        --nActive;
+        continue;
+      }
+      oldChiSq[l] = chiSq[l];
+      chiSq[l] = newChiSq[l];
+      if (std::abs(deltaChiSq) < deltaChiSqThresh_) {
+        active[l] = false;
+        --nActive;
+      }
+    }
+  }
+
+  for (unsigned int l = 0; l < n; ++l) {
+    const HBHEChannelInfo& channelData = *channels[index[l]];
+    MahiFitResult& result = results[index[l]];
+    std::array<float, 3> reconstructedVals{{float(amp[l]), -9999, float(chiSq[l])}};
+    if (failed[l]) {
+      prepareChannel(channelData);
+      result.useTriple = fitChannel(reconstructedVals);
+    } else if (reconstructedVals[2] > chiSqSwitch_) {
+      prepareChannel(channelData);
       doFit(reconstructedVals, 0);
-      useTriple = true;
+      result.useTriple = true;
+    } else if (reconstructedVals[0] != 0) {
+      // calculateArrivalTime: least squares solution of the derivative times t = the residuals
+      float t = 0.;
+      if (calculateArrivalTime_) {
+        double dTd = 0, dTr = 0;
+        for (unsigned int i = 0; i < NS; ++i) {
+          double d = pulseDeriv[i][l] * amp[l];
+          dTd += d * d;
+          dTr += d * (pulse[i][l] * amp[l] - amplitudes[i][l]);
+        }
+        t = dTd > 0 ? dTr / dTd : 0.;
+        t = (t > timeLimit_) ? timeLimit_ : ((t < -timeLimit_) ? -timeLimit_ : t);
+      }
+      reconstructedVals[1] = t;
     }
-  } else {
-    reconstructedVals.at(0) = 0.;      //energy
-    reconstructedVals.at(1) = -9999.;  //time
-    reconstructedVals.at(2) = -9999.;  //chi2
+    result.energy = reconstructedVals[0] * channelData.tsGain(0);
+    result.time = reconstructedVals[1];
+    result.chi2 = reconstructedVals[2];
   }
+}
 
-  reconstructedEnergy = reconstructedVals[0] * channelData.tsGain(0);
-  reconstructedTime = reconstructedVals[1];
-  chi2 = reconstructedVals[2];
+void MahiFit::phase1ApplyBatch(const std::vector<const HBHEChannelInfo*>& channels,
+                               const std::vector<const HcalPulseShapes::Shape*>& shapes,
+                               const HcalTimeSlew* hcalTimeSlewDelay,
+                               std::vector<MahiFitResult>& results) {
+  const unsigned int n = channels.size();
+  assert(shapes.size() == n);
+  results.assign(n, MahiFitResult{0.f, -9999.f, -9999.f, false});
+
+  // without 1-pulse pre-fit (or with a pedestal pulse) every fit is a multi-pulse one
+  const bool batchPreFit = chiSqSwitch_ > 0 && !dynamicPed_;
+
+  // channels to fit, grouped by pulse shape and number of samples
+  std::vector<unsigned int> toFit;
+  toFit.reserve(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    assert(channels[i]->nSamples() == 8 || channels[i]->nSamples() == 10);
+    if (prepareChannel(*channels[i]))
+      toFit.push_back(i);
+  }
+  std::stable_sort(toFit.begin(), toFit.end(), [&](unsigned int i, unsigned int j) {
+    return std::make_pair(shapes[i], channels[i]->nSamples()) < std::make_pair(shapes[j], channels[j]->nSamples());
+  });
+
+  for (auto first = toFit.begin(); first != toFit.end();) {
+    const auto shape = shapes[*first];
+    const unsigned int nSamples = channels[*first]->nSamples();
+    auto last = std::find_if(
+        first, toFit.end(), [&](unsigned int i) { return shapes[i] != shape || channels[i]->nSamples() != nSamples; });
+    setPulseShapeTemplate(*shape, hcalTimeSlewDelay);
+
+    if (batchPreFit) {
+      for (auto block = first; block != last; block += std::min<long>(batchSize_, last - block)) {
+        const unsigned int nBlock = std::min<long>(batchSize_, last - block);
+        if (nSamples == 8)
+          onePulseFitBatch<8>(channels, &*block, nBlock, results);
+        else
+          onePulseFitBatch<10>(channels, &*block, nBlock, results);
+      }
+    } else {
+      for (auto it = first; it != last; ++it) {
+        auto& result = results[*it];
+        phase1Apply(*channels[*it], result.energy, result.time, result.useTriple, result.chi2);
+      }
+    }
+    first = last;
+  }
 }
 
 void MahiFit::doFit(std::array<float, 3>& correctedOutput, int nbx) const {
@@ -460,21 +665,27 @@ double MahiFit::calculateChiSq() const {
 }
 
 void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps, const HcalTimeSlew* hcalTimeSlewDelay) {
-  if (!(&ps == currentPulseShape_)) {
+  if (hcalTimeSlewDelay != hcalTimeSlewDelay_) {
     hcalTimeSlewDelay_ = hcalTimeSlewDelay;
     tsDelay1GeV_ = hcalTimeSlewDelay->delay(1.0, slewFlavor_);
-
+  }
+  if (!(&ps == currentPulseShape_)) {
     resetPulseShapeTemplate(ps);
     currentPulseShape_ = &ps;
   }
 }
 
 void MahiFit::resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps) {
-  ++cntsetPulseShape_;
-
-  // only the pulse shape itself from PulseShapeFunctor is used for Mahi
-  // the uncertainty terms calculated inside PulseShapeFunctor are used for Method 2 only
-  psfPtr_.reset(new FitterFuncs::PulseShapeFunctor(ps, false, false, false, 1, 0, 0, 10));
+  // the templates do not depend on the conditions, they are built the first time a shape is used
+  auto& psf = pulseShapeCache_[&ps];
+  if (!psf) {
+    ++cntsetPulseShape_;
+
+    // only the pulse shape itself from PulseShapeFunctor is used for Mahi
+    // the uncertainty terms calculated inside PulseShapeFunctor are used for Method 2 only
+    psf = std::make_unique<FitterFuncs::PulseShapeFunctor>(ps, false, false, false, 1, 0, 0, 10);
+  }
+  psfPtr_ = psf.get();
 }
 
 void MahiFit::nnlsUnconstrainParameter(Index idxp) const {
@@ -55,6 +55,38 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
                                              const HcalRecoParam* params,
                                              const HcalCalibrations& calibs,
                                              const bool isData) {
+  return reconstructChannel(info, params, calibs, isData, nullptr);
+}
+
+void SimpleHBHEPhase1Algo::reconstructBatch(const std::vector<HBHEChannelInfo>& infos,
+                                            const std::vector<const HcalRecoParam*>& params,
+                                            const std::vector<const HcalCalibrations*>& calibs,
+                                            const bool isData,
+                                            std::vector<HBHERecHit>& rechits) {
+  if (!mahiOOTpuCorr_) {
+    AbsHBHEPhase1Algo::reconstructBatch(infos, params, calibs, isData, rechits);
+    return;
+  }
+
+  mahiChannels_.clear();
+  mahiShapes_.clear();
+  for (auto const& info : infos) {
+    mahiChannels_.push_back(&info);
+    mahiShapes_.push_back(&theHcalPulseShapes_.getShape(info.recoShape()));
+  }
+  mahiOOTpuCorr_->phase1ApplyBatch(mahiChannels_, mahiShapes_, hcalTimeSlew_delay_, mahiResults_);
+
+  rechits.clear();
+  rechits.reserve(infos.size());
+  for (unsigned i = 0; i < infos.size(); ++i)
+    rechits.push_back(reconstructChannel(infos[i], params[i], *calibs[i], isData, &mahiResults_[i]));
+}
+
+HBHERecHit SimpleHBHEPhase1Algo::reconstructChannel(const HBHEChannelInfo& info,
+                                                    const HcalRecoParam* params,
+                                                    const HcalCalibrations& calibs,
+                                                    const bool isData,
+                                                    const MahiFitResult* mahiResult) {
   HBHERecHit rh;
 
   const HcalDetId channelId(info.id());
@@ -104,8 +136,15 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
   const MahiFit* mahi = mahiOOTpuCorr_.get();
 
   if (mahi) {
-    mahiOOTpuCorr_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()), hcalTimeSlew_delay_);
-    mahi->phase1Apply(info, m4E, m4T, m4UseTriple, m4chi2);
+    if (mahiResult) {
+      m4E = mahiResult->energy;
+      m4T = mahiResult->time;
+      m4UseTriple = mahiResult->useTriple;
+      m4chi2 = mahiResult->chi2;
+    } else {
+      mahiOOTpuCorr_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()), hcalTimeSlew_delay_);
+      mahi->phase1Apply(info, m4E, m4T, m4UseTriple, m4chi2);
+    }
     m4E *= hbminusCorrectionFactor(channelId, m4E, isData);
   }
 
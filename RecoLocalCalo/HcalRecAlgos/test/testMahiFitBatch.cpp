@@ -0,0 +1,153 @@
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShape.h"
+#include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
+#include "DataFormats/HcalRecHit/interface/HBHEChannelInfo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Fits toy HBHE channels (8 and 10 samples, two pulse shapes, in-time pulses with and without
+// out-of-time pileup) with MahiFit::phase1ApplyBatch and with MahiFit::phase1Apply channel by
+// channel, and checks that energy, time, chi2 and useTriple are the same.
+
+namespace {
+  HcalPulseShape makeShape(double tau) {
+    const unsigned int nBins = 250;
+    std::vector<double> bins(nBins);
+    double sum = 0;
+    for (unsigned int i = 0; i < nBins; ++i) {
+      double t = i + 0.5;
+      bins[i] = t * t * std::exp(-t / tau);
+      sum += bins[i];
+    }
+    for (auto& bin : bins)
+      bin /= sum;
+    return HcalPulseShape(bins, nBins);
+  }
+
+  void setup(MahiFit& mahi) {
+    mahi.setParameters(false,
+                       0.,
+                       15.,
+                       true,
+                       HcalTimeSlew::Medium,
+                       true,
+                       0.,
+                       5.,
+                       2.5,
+                       {-3, -2, -1, 0, 1, 2, 3, 4},
+                       500,
+                       500,
+                       1.e-3,
+                       1.e-11);
+  }
+
+  bool differ(float ref, float val, float tolerance) {
+    return std::abs(ref - val) > tolerance * std::max(1.f, std::abs(ref));
+  }
+}  // namespace
+
+int main() {
+  const HcalPulseShape shapes[2] = {makeShape(5.), makeShape(8.)};
+  HcalTimeSlew slew;
+  slew.addM2ParameterSet(23.960177, -3.178648, 16.00);
+  slew.addM2ParameterSet(11.977461, -1.5610227, 10.00);
+  slew.addM2ParameterSet(9.109694, -1.075824, 6.25);
+
+  std::mt19937 engine(42);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::exponential_distribution<double> amplitude(1. / 40.);
+  std::normal_distribution<double> gauss(0., 1.);
+
+  // 101 channels per shape and number of samples, so that the last batch of each group is partial;
+  // the first ones have no signal, an in-time pulse only, and large pileup pulses (whose 1-pulse
+  // pre-fit chi2 is above chiSqSwitch)
+  const unsigned int nPerGroup = 101;
+  std::vector<HBHEChannelInfo> infos;
+  std::vector<const HcalPulseShape*> channelShapes;
+  for (unsigned int nSamples : {8u, 10u}) {
+    const bool sipm = nSamples == 8;
+    const unsigned int soi = sipm ? 3 : 4;
+    for (int s = 0; s < 2; ++s) {
+      for (unsigned int c = 0; c < nPerGroup; ++c) {
+        double charges[HBHEChannelInfo::MAXSAMPLES] = {};
+        auto addPulse = [&](int bx, double charge) {
+          for (unsigned int i = 0; i < nSamples; ++i) {
+            double t = 25. * (int(i) - int(soi) - bx) + 92.5;
+            if (t >= 0)
+              charges[i] += charge * shapes[s].integrate(t, t + 25.);
+          }
+        };
+        if (c == 1)
+          addPulse(0, 100.);
+        else if (c == 2) {
+          addPulse(0, 100.);
+          addPulse(-1, 500.);
+          addPulse(1, 300.);
+        } else if (c > 2) {
+          addPulse(0, uniform(engine) < 0.3 ? 0. : amplitude(engine));
+          for (int bx = -3; bx <= 4; ++bx)
+            if (bx != 0 && uniform(engine) < 0.15)
+              addPulse(bx, amplitude(engine));
+        }
+
+        HBHEChannelInfo info(sipm, false);
+        for (unsigned int i = 0; i < nSamples; ++i) {
+          double noise = c > 2 ? gauss(engine) + std::sqrt(0.3 * charges[i]) * gauss(engine) : 0.;
+          info.setSample(i, 0, 3.f, charges[i] + 3. + noise, 3., 1., 0.1, 0., 0.f);
+        }
+        info.setChannelInfo(HcalDetId(), s, nSamples, soi, 0, 0., 0.3, 0., false, false, false);
+        infos.push_back(info);
+        channelShapes.push_back(&shapes[s]);
+      }
+    }
+  }
+
+  // shuffled, as the channels of an event come in any order of shape and number of samples
+  std::vector<unsigned int> order(infos.size());
+  for (unsigned int i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::shuffle(order.begin(), order.end(), engine);
+  std::vector<const HBHEChannelInfo*> channels;
+  std::vector<const HcalPulseShapes::Shape*> batchShapes;
+  for (unsigned int i : order) {
+    channels.push_back(&infos[i]);
+    batchShapes.push_back(channelShapes[i]);
+  }
+
+  MahiFit batch;
+  setup(batch);
+  std::vector<MahiFitResult> results;
+  batch.phase1ApplyBatch(channels, batchShapes, &slew, results);
+
+  MahiFit single;
+  setup(single);
+  unsigned int nTriple = 0, nDiffer = 0;
+  for (unsigned int i = 0; i < channels.size(); ++i) {
+    MahiFitResult ref{0.f, -9999.f, -9999.f, false};
+    single.setPulseShapeTemplate(*batchShapes[i], &slew);
+    single.phase1Apply(*channels[i], ref.energy, ref.time, ref.useTriple, ref.chi2);
+    nTriple += ref.useTriple;
+
+    auto const& res = results[i];
+    if (ref.useTriple != res.useTriple || differ(ref.energy, res.energy, 1.e-4f) ||
+        std::abs(ref.time - res.time) > 1.e-3f || differ(ref.chi2, res.chi2, 1.e-4f)) {
+      ++nDiffer;
+      std::cout << "channel " << i << " (" << channels[i]->nSamples() << " samples): phase1Apply energy "
+                << ref.energy << " time " << ref.time << " chi2 " << ref.chi2 << " useTriple " << ref.useTriple
+                << ", phase1ApplyBatch energy " << res.energy << " time " << res.time << " chi2 " << res.chi2
+                << " useTriple " << res.useTriple << std::endl;
+    }
+  }
+
+  std::cout << channels.size() << " channels, " << nTriple << " with a multi-pulse fit, " << nDiffer
+            << " with different results" << std::endl;
+  if (nTriple == 0) {
+    std::cout << "no channel has a pre-fit chi2 above chiSqSwitch" << std::endl;
+    return 1;
+  }
+  return nDiffer == 0 ? 0 : 1;
+}
@@ -20,6 +20,7 @@
 #include <cmath>
 #include <utility>
 #include <algorithm>
+#include <vector>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -409,6 +410,19 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
   // not going to be constructed from such channels.
   const bool skipDroppedChannels = !(infos && saveDroppedInfos_);
 
+  // The rechits are reconstructed together once all the channels
+  // are known, these are the inputs of each of them
+  std::vector<HBHEChannelInfo> recoInfos;
+  std::vector<const HcalRecoParam*> recoParams;
+  std::vector<const HcalCalibrations*> recoCalibs;
+  std::vector<typename Collection::const_iterator> recoFrames;
+  if (rechits) {
+    recoInfos.reserve(coll.size());
+    recoParams.reserve(coll.size());
+    recoCalibs.reserve(coll.size());
+    recoFrames.reserve(coll.size());
+  }
+
   // Iterate over the input collection
   for (typename Collection::const_iterator it = coll.begin(); it != coll.end(); ++it) {
     const DFrame& frame(*it);
@@ -509,15 +523,31 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
     if (infos && (saveDroppedInfos_ || makeThisRechit))
       infos->push_back(*channelInfo);
 
-    // Reconstruct the rechit
+    // Keep the channel for the rechit reconstruction
     if (rechits && makeThisRechit) {
       const HcalRecoParam* pptr = nullptr;
       if (recoParamsFromDB_)
         pptr = param_ts;
-      HBHERecHit rh = reco_->reconstruct(*channelInfo, pptr, calib, isRealData);
+      recoInfos.push_back(*channelInfo);
+      recoParams.push_back(pptr);
+      recoCalibs.push_back(&calib);
+      recoFrames.push_back(it);
+    }
+  }
+
+  // Reconstruct the rechits
+  if (rechits && !recoInfos.empty()) {
+    std::vector<HBHERecHit> recoHits;
+    reco_->reconstructBatch(recoInfos, recoParams, recoCalibs, isRealData, recoHits);
+    for (unsigned i = 0; i < recoHits.size(); ++i) {
+      HBHERecHit& rh = recoHits[i];
       if (rh.id().rawId()) {
-        setAsicSpecificBits(frame, coder, *channelInfo, calib, &rh);
-        setCommonStatusBits(*channelInfo, calib, &rh);
+        const DFrame& frame(*recoFrames[i]);
+        const HcalQIECoder* channelCoder = cond.getHcalCoder(recoInfos[i].id());
+        const HcalQIEShape* shape = cond.getHcalShape(channelCoder);
+        const HcalCoderDb coder(*channelCoder, *shape);
+        setAsicSpecificBits(frame, coder, recoInfos[i], *recoCalibs[i], &rh);
+        setCommonStatusBits(recoInfos[i], *recoCalibs[i], &rh);
         rechits->push_back(rh);
       }
     }
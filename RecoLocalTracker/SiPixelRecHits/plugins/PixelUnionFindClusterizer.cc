@@ -0,0 +1,151 @@
+#include "PixelUnionFindClusterizer.h"
+
+#include <algorithm>
+
+void PixelUnionFindClusterizer::clusterize(const PixelDigi* digi,
+                                           const int* electron,
+                                           unsigned int n,
+                                           int nrows,
+                                           int ncols,
+                                           int clusterThreshold,
+                                           SiPixelClustersSoA& output) {
+  // the buffer only grows, its entries are reset before returning
+  if (theBuffer.size() < static_cast<unsigned int>(nrows * ncols))
+    theBuffer.assign(nrows * ncols, -1);
+  theParent.resize(n);
+  theADC.resize(n);
+
+  for (unsigned int i = 0; i < n; ++i) {
+    theADC[i] = std::max(electron[i], 100);  // as in PixelThresholdClusterizer::copy_to_buffer
+    theParent[i] = -1;
+    if (theADC[i] < thePixelThreshold)
+      continue;
+    int& pixel = theBuffer[digi[i].row() * ncols + digi[i].column()];
+    if (pixel >= 0)
+      theParent[pixel] = -1;  // a pixel read twice, the last value is kept
+    pixel = i;
+    theParent[i] = i;
+  }
+
+  // every pair of neighbours is seen once from its first pixel in (row, column) order
+  for (unsigned int i = 0; i < n; ++i) {
+    if (theParent[i] < 0)
+      continue;
+    int row = digi[i].row();
+    int col = digi[i].column();
+    if (col + 1 < ncols && theBuffer[row * ncols + col + 1] >= 0)
+      unite(i, theBuffer[row * ncols + col + 1]);
+    if (row + 1 < nrows) {
+      for (int c = std::max(col - 1, 0); c < std::min(col + 2, ncols); ++c)
+        if (theBuffer[(row + 1) * ncols + c] >= 0)
+          unite(i, theBuffer[(row + 1) * ncols + c]);
+    }
+  }
+
+  // the root of a component is its first digi
+  theCharge.assign(n, 0);
+  theMinRow.assign(n, 0xffff);
+  theSeed.assign(n, false);
+  theOffset.assign(n, 0);
+  for (unsigned int i = 0; i < n; ++i) {
+    if (theParent[i] < 0)
+      continue;
+    int root = find(i);
+    theCharge[root] += uint16_t(theADC[i]);  // the charge of the SiPixelCluster
+    theMinRow[root] = std::min<uint16_t>(theMinRow[root], digi[i].row());
+    theSeed[root] = theSeed[root] || theADC[i] >= theSeedThreshold;
+    ++theOffset[root];
+  }
+
+  // group the digis by cluster, in the order of the roots; the components above maxClusterSize
+  // are split afterwards
+  theClusters.clear();
+  theSplit.assign(n, false);
+  bool hasSplit = false;
+  unsigned int nPixels = 0;
+  for (unsigned int i = 0; i < n; ++i) {
+    if (theParent[i] != int(i))
+      continue;
+    unsigned int size = theOffset[i];
+    theOffset[i] = noCluster;
+    if (size > maxClusterSize) {
+      theSplit[i] = true;
+      hasSplit = true;
+    } else if (theSeed[i] && theCharge[i] >= clusterThreshold) {
+      theClusters.push_back({theMinRow[i], nPixels, nPixels + size});
+      theOffset[i] = nPixels;
+      nPixels += size;
+    }
+  }
+  thePixels.resize(nPixels);
+  for (unsigned int i = 0; i < n; ++i) {
+    if (theParent[i] < 0)
+      continue;
+    int root = find(i);
+    if (theOffset[root] != noCluster)
+      thePixels[theOffset[root]++] = i;
+  }
+  if (hasSplit)
+    split(digi, n, nrows, ncols, clusterThreshold);
+
+  std::stable_sort(theClusters.begin(), theClusters.end(), [](Cluster const& a, Cluster const& b) {
+    return a.minRow < b.minRow;
+  });
+  for (auto const& cluster : theClusters) {
+    for (unsigned int k = cluster.begin; k < cluster.end; ++k) {
+      auto const& pixel = digi[thePixels[k]];
+      output.addPixel(pixel.row(), pixel.column(), uint16_t(theADC[thePixels[k]]));
+    }
+    output.endCluster();
+  }
+
+  for (unsigned int i = 0; i < n; ++i)
+    theBuffer[digi[i].row() * ncols + digi[i].column()] = -1;
+}
+
+void PixelUnionFindClusterizer::split(
+    const PixelDigi* digi, unsigned int n, int nrows, int ncols, int clusterThreshold) {
+  theTaken.assign(n, false);
+  for (unsigned int i = 0; i < n; ++i) {
+    // the seeds of PixelThresholdClusterizer::copy_to_buffer, valid if their pixel is not taken
+    if (theADC[i] < thePixelThreshold || theADC[i] < theSeedThreshold)
+      continue;
+    int seed = theBuffer[digi[i].row() * ncols + digi[i].column()];
+    if (theTaken[seed] || theADC[seed] < theSeedThreshold || !theSplit[find(seed)])
+      continue;
+
+    // the pixels are visited in the order in which they are added, their neighbours column by
+    // column; the accretion stops at the first pixel which does not fit
+    const unsigned int begin = thePixels.size();
+    thePixels.push_back(seed);
+    theTaken[seed] = true;
+    uint16_t minRow = digi[seed].row();
+    int charge = uint16_t(theADC[seed]);
+    bool full = false;
+    for (unsigned int k = begin; k < thePixels.size() && !full; ++k) {
+      const int row = digi[thePixels[k]].row();
+      const int col = digi[thePixels[k]].column();
+      for (int c = std::max(col - 1, 0); c < std::min(col + 2, ncols) && !full; ++c) {
+        for (int r = std::max(row - 1, 0); r < std::min(row + 2, nrows); ++r) {
+          int pixel = theBuffer[r * ncols + c];
+          if (pixel < 0 || theTaken[pixel])
+            continue;
+          if (thePixels.size() - begin == maxClusterSize) {
+            full = true;
+            break;
+          }
+          thePixels.push_back(pixel);
+          theTaken[pixel] = true;
+          minRow = std::min<uint16_t>(minRow, r);
+          charge += uint16_t(theADC[pixel]);
+        }
+      }
+    }
+
+    // the pixels of a cluster below threshold stay taken
+    if (charge >= clusterThreshold)
+      theClusters.push_back({minRow, begin, static_cast<unsigned int>(thePixels.size())});
+    else
+      thePixels.resize(begin);
+  }
+}
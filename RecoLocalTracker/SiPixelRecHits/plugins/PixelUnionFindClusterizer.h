@@ -0,0 +1,84 @@
+#ifndef RecoLocalTracker_SiPixelRecHits_PixelUnionFindClusterizer_h
+#define RecoLocalTracker_SiPixelRecHits_PixelUnionFindClusterizer_h
+
+/** \class PixelUnionFindClusterizer
+ *
+ *  Clusterizer of the digis of one module, with the thresholds of the PixelThresholdClusterizer:
+ *  the pixels above the channel threshold are put in a dense (row, column) buffer of digi indices
+ *  and joined with their 8 neighbours by a union-find, a connected component being a cluster if
+ *  it contains a seed and its charge is above the cluster threshold.
+ *  The components of more than maxClusterSize pixels, which the PixelThresholdClusterizer cuts,
+ *  are accreted from their seeds as in PixelThresholdClusterizer::make_cluster, so that the
+ *  clusters are the same as those of the PixelThresholdClusterizer. They are ordered by minimum
+ *  row, in any order for equal minimum rows as in the PixelThresholdClusterizer.
+ */
+
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelClustersSoA.h"
+
+#include <cstdint>
+#include <vector>
+
+class PixelUnionFindClusterizer {
+public:
+  PixelUnionFindClusterizer(int pixelThreshold, int seedThreshold)
+      : thePixelThreshold(pixelThreshold), theSeedThreshold(seedThreshold) {}
+
+  /// Append the clusters of the n digis of a nrows x ncols module to output, electron[i] being the
+  /// calibrated charge of digi[i]; output.beginModule() must have been called for the module.
+  void clusterize(const PixelDigi* digi,
+                  const int* electron,
+                  unsigned int n,
+                  int nrows,
+                  int ncols,
+                  int clusterThreshold,
+                  SiPixelClustersSoA& output);
+
+private:
+  // size at which make_cluster stops the accretion, PixelClusterizerBase::AccretionCluster::MAXSIZE
+  static constexpr unsigned int maxClusterSize = 256;
+  // no cluster, the value of theOffset for the components which are not clusters
+  static constexpr unsigned int noCluster = ~0u;
+
+  struct Cluster {
+    uint16_t minRow;
+    unsigned int begin;  // range of the cluster in thePixels
+    unsigned int end;
+  };
+
+  // cluster the pixels of the components flagged in theSplit, from their seeds in digi order
+  void split(const PixelDigi* digi, unsigned int n, int nrows, int ncols, int clusterThreshold);
+
+  int find(int i) {
+    while (theParent[i] != i) {
+      theParent[i] = theParent[theParent[i]];
+      i = theParent[i];
+    }
+    return i;
+  }
+  void unite(int i, int j) {
+    i = find(i);
+    j = find(j);
+    if (i < j)
+      theParent[j] = i;
+    else
+      theParent[i] = j;
+  }
+
+  const int thePixelThreshold;
+  const int theSeedThreshold;
+
+  std::vector<int> theBuffer;  // digi index of each pixel of the module, or -1
+  std::vector<int> theParent;  // -1 for the digis below threshold
+  std::vector<int> theADC;
+  std::vector<int> theCharge;
+  std::vector<uint16_t> theMinRow;
+  std::vector<bool> theSeed;
+  std::vector<bool> theSplit;            // per root, component above maxClusterSize
+  std::vector<bool> theTaken;            // digis already in a cluster of a split component
+  std::vector<Cluster> theClusters;
+  std::vector<unsigned int> theOffset;  // per root, position of the next pixel of the cluster
+  std::vector<unsigned int> thePixels;  // digis, grouped by cluster
+};
+
+#endif
@@ -0,0 +1,279 @@
+/** \class SiPixelRawToRecHitsSoA
+ *
+ *  Pixel local reconstruction in one module: the raw data of all the FEDs are unpacked into one
+ *  flat list of digis, grouped by module, and each module is calibrated, clusterized with the
+ *  PixelUnionFindClusterizer and its clusters given to the CPE. The clusters and hits are produced
+ *  as SiPixelClustersSoA and SiPixelRecHitsSoA; SiPixelRecHitsFromSoA converts them to the
+ *  legacy collections when these are needed.
+ *
+ *  The unpacking is the one of SiPixelRawToDigi, the calibration and thresholds the ones of the
+ *  PixelThresholdClusterizer for phase 0 and phase 1 data, and the clusters are the same as those
+ *  of the PixelThresholdClusterizer. Two features of SiPixelRawToDigi are not provided:
+ *  - the error collections (the SiPixelRawDataError, the DetIdCollection of the modules with
+ *    errors used by the MeasurementTracker for the inactive modules, the user error modules and
+ *    the PixelFEDChannel), the errors of the raw data are dropped. When these are needed,
+ *    SiPixelRawToDigi with IncludeErrors has to be run in addition.
+ *  - the regional unpacking, all the FEDs of the cabling map are unpacked. The regional HLT
+ *    sequences have to keep the SiPixelRawToDigi, SiPixelClusterProducer and
+ *    SiPixelRecHitConverter chain.
+ */
+
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "CondFormats/DataRecord/interface/SiPixelFedCablingMapRcd.h"
+#include "CondFormats/DataRecord/interface/SiPixelQualityRcd.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingMap.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTree.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelQuality.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationService.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationOfflineService.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationForHLTService.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelClustersSoA.h"
+#include "DataFormats/SiPixelDetId/interface/PixelSubdetector.h"
+#include "DataFormats/TrackerCommon/interface/TrackerTopology.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHitsSoA.h"
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDataFormatter.h"
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "Geometry/Records/interface/TrackerTopologyRcd.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "RecoLocalTracker/ClusterParameterEstimator/interface/PixelClusterParameterEstimator.h"
+#include "RecoLocalTracker/Records/interface/TkPixelCPERecord.h"
+
+#include "PixelUnionFindClusterizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+class SiPixelRawToRecHitsSoA : public edm::stream::EDProducer<> {
+public:
+  explicit SiPixelRawToRecHitsSoA(const edm::ParameterSet& conf);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void produce(edm::Event& ev, const edm::EventSetup& es) override;
+
+private:
+  const edm::EDGetTokenT<FEDRawDataCollection> tFEDRawDataCollection;
+  const edm::EDPutTokenT<SiPixelClustersSoA> tPutClusters;
+  const edm::EDPutTokenT<SiPixelRecHitsSoA> tPutRecHits;
+
+  const std::string cablingMapLabel_;
+  const std::string cpeName_;
+  const bool usePhase1_;
+  const bool usePilotBlade_;
+  const bool useQuality_;
+  const int maxTotalClusters_;
+
+  // calibration and cluster threshold, as in the PixelThresholdClusterizer
+  const int clusterThreshold_;
+  const int clusterThreshold_L1_;
+  const int conversionFactor_;
+  const int conversionFactor_L1_;
+  const int offset_;
+  const int offset_L1_;
+  const float electronPerADCGain_;
+  const bool doMissCalibrate_;
+
+  edm::ESWatcher<SiPixelFedCablingMapRcd> recordWatcher_;
+  edm::ESWatcher<SiPixelQualityRcd> qualityWatcher_;
+  std::unique_ptr<SiPixelFedCablingTree> cabling_;
+  std::vector<unsigned int> fedIds_;
+  const SiPixelQuality* badPixelInfo_;
+  std::unique_ptr<SiPixelGainCalibrationServiceBase> gainCalibration_;
+
+  PixelUnionFindClusterizer clusterizer_;
+
+  // buffers of the event, kept to avoid reallocations
+  PixelDataFormatter::FlatDigis unpacked_;
+  std::vector<uint64_t> order_;
+  std::vector<PixelDigi> digis_;
+  std::vector<int> electron_;
+};
+
+SiPixelRawToRecHitsSoA::SiPixelRawToRecHitsSoA(const edm::ParameterSet& conf)
+    : tFEDRawDataCollection(consumes<FEDRawDataCollection>(conf.getParameter<edm::InputTag>("InputLabel"))),
+      tPutClusters(produces<SiPixelClustersSoA>()),
+      tPutRecHits(produces<SiPixelRecHitsSoA>()),
+      cablingMapLabel_(conf.getParameter<std::string>("CablingMapLabel")),
+      cpeName_(conf.getParameter<std::string>("CPE")),
+      usePhase1_(conf.getParameter<bool>("UsePhase1")),
+      usePilotBlade_(conf.getParameter<bool>("UsePilotBlade")),
+      useQuality_(conf.getParameter<bool>("UseQualityInfo")),
+      maxTotalClusters_(conf.getParameter<int32_t>("maxNumberOfClusters")),
+      clusterThreshold_(conf.getParameter<int>("ClusterThreshold")),
+      clusterThreshold_L1_(conf.getParameter<int>("ClusterThreshold_L1")),
+      conversionFactor_(conf.getParameter<int>("VCaltoElectronGain")),
+      conversionFactor_L1_(conf.getParameter<int>("VCaltoElectronGain_L1")),
+      offset_(conf.getParameter<int>("VCaltoElectronOffset")),
+      offset_L1_(conf.getParameter<int>("VCaltoElectronOffset_L1")),
+      electronPerADCGain_(conf.getParameter<double>("ElectronPerADCGain")),
+      doMissCalibrate_(conf.getParameter<bool>("MissCalibrate")),
+      badPixelInfo_(nullptr),
+      clusterizer_(conf.getParameter<int>("ChannelThreshold"), conf.getParameter<int>("SeedThreshold")) {
+  const auto& payloadType = conf.getParameter<std::string>("payloadType");
+  if (payloadType == "HLT")
+    gainCalibration_ = std::make_unique<SiPixelGainCalibrationForHLTService>(conf);
+  else if (payloadType == "Offline")
+    gainCalibration_ = std::make_unique<SiPixelGainCalibrationOfflineService>(conf);
+  else if (payloadType == "Full")
+    gainCalibration_ = std::make_unique<SiPixelGainCalibrationService>(conf);
+  else
+    throw cms::Exception("Configuration") << "[SiPixelRawToRecHitsSoA]: payloadType " << payloadType
+                                          << " is invalid, possible choices are HLT, Offline and Full";
+}
+
+void SiPixelRawToRecHitsSoA::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  // unpacking, all the FEDs without the error collections
+  desc.add<edm::InputTag>("InputLabel", edm::InputTag("siPixelRawData"));
+  desc.add<bool>("UseQualityInfo", false);
+  desc.add<bool>("UsePilotBlade", false)->setComment("##  Use pilot blades");
+  desc.add<bool>("UsePhase1", false)->setComment("##  Use phase1");
+  desc.add<std::string>("CablingMapLabel", "")->setComment("CablingMap label");
+  // clusterizer
+  desc.add<int>("maxNumberOfClusters", -1)->setComment("-1 means no limit");
+  desc.add<std::string>("payloadType", "Offline")
+      ->setComment("Options: HLT - column granularity, Offline - gain:col/ped:pix");
+  desc.add<int>("ChannelThreshold", 1000);
+  desc.add<int>("SeedThreshold", 1000);
+  desc.add<int>("ClusterThreshold", 4000);
+  desc.add<int>("ClusterThreshold_L1", 4000);
+  desc.add<bool>("MissCalibrate", true);
+  desc.add<int>("VCaltoElectronGain", 65);
+  desc.add<int>("VCaltoElectronGain_L1", 65);
+  desc.add<int>("VCaltoElectronOffset", -414);
+  desc.add<int>("VCaltoElectronOffset_L1", -414);
+  desc.add<double>("ElectronPerADCGain", 135.);
+  // hits
+  desc.add<std::string>("CPE", "PixelCPEGeneric");
+  descriptions.add("siPixelRawToRecHitsSoA", desc);
+}
+
+void SiPixelRawToRecHitsSoA::produce(edm::Event& ev, const edm::EventSetup& es) {
+  if (recordWatcher_.check(es)) {
+    edm::ESTransientHandle<SiPixelFedCablingMap> cablingMap;
+    es.get<SiPixelFedCablingMapRcd>().get(cablingMapLabel_, cablingMap);
+    fedIds_ = cablingMap->fedIds();
+    cabling_ = cablingMap->cablingTree();
+  }
+  if (useQuality_ && qualityWatcher_.check(es)) {
+    edm::ESHandle<SiPixelQuality> qualityInfo;
+    es.get<SiPixelQualityRcd>().get(qualityInfo);
+    badPixelInfo_ = qualityInfo.product();
+  }
+  gainCalibration_->setESObjects(es);
+
+  edm::ESHandle<TrackerGeometry> geom;
+  es.get<TrackerDigiGeometryRecord>().get(geom);
+  edm::ESHandle<TrackerTopology> trackerTopologyHandle;
+  es.get<TrackerTopologyRcd>().get(trackerTopologyHandle);
+  const TrackerTopology* tTopo = trackerTopologyHandle.product();
+  edm::ESHandle<PixelClusterParameterEstimator> hCPE;
+  es.get<TkPixelCPERecord>().get(cpeName_, hCPE);
+  const PixelClusterParameterEstimator& cpe = *hCPE;
+
+  edm::Handle<FEDRawDataCollection> buffers;
+  ev.getByToken(tFEDRawDataCollection, buffers);
+
+  // unpack all the FEDs in one list
+  unpacked_.rawIds.clear();
+  unpacked_.digis.clear();
+  PixelDataFormatter formatter(cabling_.get(), usePhase1_);
+  if (useQuality_)
+    formatter.setQualityStatus(useQuality_, badPixelInfo_);
+  bool errorsInEvent = false;
+  for (auto fedId : fedIds_) {
+    if (!usePilotBlade_ && (fedId == 40))
+      continue;  // skip pilot blade data
+    PixelDataFormatter::Errors errors;  // only the error collections of SiPixelRawToDigi have them
+    formatter.interpretRawData(errorsInEvent, fedId, buffers->FEDData(fedId), unpacked_, errors);
+  }
+
+  // group the digis by module, the modules in increasing detId order and the digis of a module
+  // in the order of the raw data, as in the DetSetVector of SiPixelRawToDigi
+  const unsigned int nDigis = unpacked_.digis.size();
+  order_.resize(nDigis);
+  for (unsigned int i = 0; i < nDigis; ++i)
+    order_[i] = (uint64_t(unpacked_.rawIds[i]) << 32) | i;
+  std::sort(order_.begin(), order_.end());
+  digis_.resize(nDigis);
+  for (unsigned int i = 0; i < nDigis; ++i)
+    digis_[i] = unpacked_.digis[order_[i] & 0xffffffff];
+
+  auto clusters = std::make_unique<SiPixelClustersSoA>();
+  auto hits = std::make_unique<SiPixelRecHitsSoA>();
+  clusters->reserve(0, nDigis / 4, nDigis);
+  hits->reserve(nDigis / 4);
+
+  for (unsigned int first = 0, last = 0; first < nDigis; first = last) {
+    const uint32_t rawId = order_[first] >> 32;
+    while (last < nDigis && (order_[last] >> 32) == rawId)
+      ++last;
+
+    DetId detIdObject(rawId);
+    const GeomDetUnit* genericDet = geom->idToDetUnit(detIdObject);
+    const PixelGeomDetUnit* pixDet = dynamic_cast<const PixelGeomDetUnit*>(genericDet);
+    assert(pixDet);
+    const PixelTopology& topol = pixDet->specificTopology();
+    const bool layer1 = detIdObject.subdetId() == PixelSubdetector::PixelBarrel && tTopo->pxbLayer(rawId) == 1;
+
+    // calibration, as in PixelThresholdClusterizer::copy_to_buffer
+    const unsigned int n = last - first;
+    electron_.resize(n);
+    auto begin = digis_.cbegin() + first;
+    auto end = digis_.cbegin() + last;
+    if (doMissCalibrate_) {
+      if (layer1)
+        gainCalibration_->calibrate(rawId, begin, end, conversionFactor_L1_, offset_L1_, electron_.data());
+      else
+        gainCalibration_->calibrate(rawId, begin, end, conversionFactor_, offset_, electron_.data());
+    } else {
+      for (unsigned int i = 0; i < n; ++i)
+        electron_[i] = int(digis_[first + i].adc() * electronPerADCGain_);
+    }
+
+    const unsigned int firstCluster = clusters->nClusters();
+    clusters->beginModule(rawId);
+    clusterizer_.clusterize(&digis_[first],
+                            electron_.data(),
+                            n,
+                            topol.nrows(),
+                            topol.ncolumns(),
+                            layer1 ? clusterThreshold_L1_ : clusterThreshold_,
+                            *clusters);
+
+    for (unsigned int i = firstCluster; i < clusters->nClusters(); ++i) {
+      auto tuple = cpe.getParameters(clusters->cluster(i), *genericDet);
+      hits->push_back(std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple));
+    }
+
+    if ((maxTotalClusters_ >= 0) && (int(clusters->nClusters()) > maxTotalClusters_)) {
+      edm::LogError("TooManyClusters")
+          << "Limit on the number of clusters exceeded. An empty cluster collection will be produced instead.\n";
+      clusters = std::make_unique<SiPixelClustersSoA>();
+      hits = std::make_unique<SiPixelRecHitsSoA>();
+      break;
+    }
+  }
+
+  ev.put(tPutClusters, std::move(clusters));
+  ev.put(tPutRecHits, std::move(hits));
+}
+
+DEFINE_FWK_MODULE(SiPixelRawToRecHitsSoA);
@@ -0,0 +1,91 @@
+/** \class SiPixelRecHitsFromSoA
+ *
+ *  Conversion of the SiPixelClustersSoA and SiPixelRecHitsSoA of SiPixelRawToRecHitsSoA to the
+ *  SiPixelClusterCollectionNew and SiPixelRecHitCollection of SiPixelClusterProducer and
+ *  SiPixelRecHitConverter, for the consumers of the legacy collections.
+ */
+
+#include "FWCore/Framework/interface/global/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+
+#include "DataFormats/Common/interface/DetSetVectorNew.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelClustersSoA.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHitCollection.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHitsSoA.h"
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+
+#include <cassert>
+
+class SiPixelRecHitsFromSoA : public edm::global::EDProducer<> {
+public:
+  explicit SiPixelRecHitsFromSoA(const edm::ParameterSet& conf);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void produce(edm::StreamID, edm::Event& ev, const edm::EventSetup& es) const override;
+
+private:
+  const edm::EDGetTokenT<SiPixelClustersSoA> tClusters;
+  const edm::EDGetTokenT<SiPixelRecHitsSoA> tRecHits;
+  const edm::EDPutTokenT<SiPixelClusterCollectionNew> tPutClusters;
+  const edm::EDPutTokenT<SiPixelRecHitCollection> tPutRecHits;
+};
+
+SiPixelRecHitsFromSoA::SiPixelRecHitsFromSoA(const edm::ParameterSet& conf)
+    : tClusters(consumes<SiPixelClustersSoA>(conf.getParameter<edm::InputTag>("src"))),
+      tRecHits(consumes<SiPixelRecHitsSoA>(conf.getParameter<edm::InputTag>("src"))),
+      tPutClusters(produces<SiPixelClusterCollectionNew>()),
+      tPutRecHits(produces<SiPixelRecHitCollection>()) {}
+
+void SiPixelRecHitsFromSoA::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("src", edm::InputTag("siPixelRawToRecHitsSoA"));
+  descriptions.add("siPixelRecHitsFromSoA", desc);
+}
+
+void SiPixelRecHitsFromSoA::produce(edm::StreamID, edm::Event& ev, const edm::EventSetup& es) const {
+  auto const& clusters = ev.get(tClusters);
+  auto const& hits = ev.get(tRecHits);
+  assert(hits.size() == clusters.nClusters());
+
+  edm::ESHandle<TrackerGeometry> geom;
+  es.get<TrackerDigiGeometryRecord>().get(geom);
+
+  // the modules without clusters are not stored, as in SiPixelClusterProducer
+  SiPixelClusterCollectionNew legacyClusters;
+  legacyClusters.reserve(clusters.nModules(), clusters.nClusters());
+  for (unsigned int m = 0; m < clusters.nModules(); ++m) {
+    if (clusters.moduleBegin(m) == clusters.moduleEnd(m))
+      continue;
+    SiPixelClusterCollectionNew::FastFiller spc(legacyClusters, clusters.detId(m));
+    for (unsigned int i = clusters.moduleBegin(m); i < clusters.moduleEnd(m); ++i)
+      spc.push_back(clusters.cluster(i));
+  }
+  auto clusterHandle = ev.emplace(tPutClusters, std::move(legacyClusters));
+
+  // cluster i of the SoA is element i of the data of the legacy collection
+  SiPixelRecHitCollection legacyHits;
+  legacyHits.reserve(clusters.nModules(), clusters.nClusters());
+  for (unsigned int m = 0; m < clusters.nModules(); ++m) {
+    if (clusters.moduleBegin(m) == clusters.moduleEnd(m))
+      continue;
+    const GeomDetUnit* genericDet = geom->idToDetUnit(DetId(clusters.detId(m)));
+    SiPixelRecHitCollection::FastFiller recHitsOnDetUnit(legacyHits, clusters.detId(m));
+    for (unsigned int i = clusters.moduleBegin(m); i < clusters.moduleEnd(m); ++i) {
+      SiPixelClusterRefNew cluster = edmNew::makeRefTo(clusterHandle, &clusterHandle->data()[i]);
+      recHitsOnDetUnit.push_back(
+          SiPixelRecHit(hits.localPosition(i), hits.localPositionError(i), hits.qualWord(i), *genericDet, cluster));
+    }
+  }
+  ev.emplace(tPutRecHits, std::move(legacyHits));
+}
+
+DEFINE_FWK_MODULE(SiPixelRecHitsFromSoA);
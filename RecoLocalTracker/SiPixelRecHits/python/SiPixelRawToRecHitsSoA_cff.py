@@ -0,0 +1,26 @@
+import FWCore.ParameterSet.Config as cms
+
+# Pixel clusters and hits from the raw data in one module, with the legacy collections made on demand.
+# There are no error collections and no regional unpacking: siPixelDigis (with IncludeErrors) is still
+# needed for the inactive modules of the MeasurementTracker, and the regional HLT sequences keep the
+# siPixelDigis, siPixelClusters and siPixelRecHits chain.
+from RecoLocalTracker.SiPixelRecHits.siPixelRawToRecHitsSoA_cfi import siPixelRawToRecHitsSoA as _siPixelRawToRecHitsSoA
+from RecoLocalTracker.SiPixelRecHits.siPixelRecHitsFromSoA_cfi import siPixelRecHitsFromSoA
+
+siPixelRawToRecHitsSoA = _siPixelRawToRecHitsSoA.clone()
+
+# phase1 pixel, as siPixelDigis and siPixelClusters
+from Configuration.Eras.Modifier_phase1Pixel_cff import phase1Pixel
+phase1Pixel.toModify(siPixelRawToRecHitsSoA,
+  UsePhase1               = True,
+  VCaltoElectronGain      = 47,
+  VCaltoElectronGain_L1   = 50,
+  VCaltoElectronOffset    = -60,
+  VCaltoElectronOffset_L1 = -670,
+  ChannelThreshold        = 10,
+  SeedThreshold           = 1000,
+  ClusterThreshold        = 4000,
+  ClusterThreshold_L1     = 2000
+)
+
+siPixelRawToRecHitsSoATask = cms.Task(siPixelRawToRecHitsSoA, siPixelRecHitsFromSoA)
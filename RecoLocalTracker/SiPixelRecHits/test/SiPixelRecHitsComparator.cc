@@ -0,0 +1,172 @@
+/*
+ * Compares the pixel clusters and rechits of two producers module by module, whatever their order
+ * in the module, and throws if they differ. A cluster is identified by its pixels, a rechit by the
+ * pixels of its cluster. Used to check that SiPixelRawToRecHitsSoA and SiPixelRecHitsFromSoA give
+ * the clusters and rechits of the SiPixelRawToDigi, SiPixelClusterProducer and SiPixelRecHitConverter
+ * chain.
+ */
+
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHitCollection.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+class SiPixelRecHitsComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit SiPixelRecHitsComparator(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions&);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  typedef std::vector<std::tuple<int, int, int>> PixelList;
+
+  static PixelList pixels(const SiPixelCluster& cluster);
+
+  void compareClusters(const edm::Event&) const;
+  void compareRecHits(const edm::Event&) const;
+
+  const edm::InputTag referenceClustersTag_;
+  const edm::InputTag testClustersTag_;
+  const edm::InputTag referenceRecHitsTag_;
+  const edm::InputTag testRecHitsTag_;
+  const double tolerance_;
+  const edm::EDGetTokenT<SiPixelClusterCollectionNew> referenceClustersToken_;
+  const edm::EDGetTokenT<SiPixelClusterCollectionNew> testClustersToken_;
+  const edm::EDGetTokenT<SiPixelRecHitCollection> referenceRecHitsToken_;
+  const edm::EDGetTokenT<SiPixelRecHitCollection> testRecHitsToken_;
+};
+
+SiPixelRecHitsComparator::SiPixelRecHitsComparator(const edm::ParameterSet& iConfig)
+    : referenceClustersTag_(iConfig.getParameter<edm::InputTag>("referenceClusters")),
+      testClustersTag_(iConfig.getParameter<edm::InputTag>("testClusters")),
+      referenceRecHitsTag_(iConfig.getParameter<edm::InputTag>("referenceRecHits")),
+      testRecHitsTag_(iConfig.getParameter<edm::InputTag>("testRecHits")),
+      tolerance_(iConfig.getParameter<double>("tolerance")),
+      referenceClustersToken_(consumes<SiPixelClusterCollectionNew>(referenceClustersTag_)),
+      testClustersToken_(consumes<SiPixelClusterCollectionNew>(testClustersTag_)),
+      referenceRecHitsToken_(consumes<SiPixelRecHitCollection>(referenceRecHitsTag_)),
+      testRecHitsToken_(consumes<SiPixelRecHitCollection>(testRecHitsTag_)) {}
+
+void SiPixelRecHitsComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("referenceClusters", edm::InputTag("siPixelClusters"));
+  desc.add<edm::InputTag>("testClusters", edm::InputTag("siPixelRecHitsFromSoA"));
+  desc.add<edm::InputTag>("referenceRecHits", edm::InputTag("siPixelRecHits"));
+  desc.add<edm::InputTag>("testRecHits", edm::InputTag("siPixelRecHitsFromSoA"));
+  desc.add<double>("tolerance", 1.e-5)
+      ->setComment("largest allowed difference of the local positions and errors, in cm and cm^2");
+  descriptions.add("siPixelRecHitsComparator", desc);
+}
+
+SiPixelRecHitsComparator::PixelList SiPixelRecHitsComparator::pixels(const SiPixelCluster& cluster) {
+  PixelList list;
+  for (auto const& pixel : cluster.pixels())
+    list.emplace_back(pixel.x, pixel.y, pixel.adc);
+  std::sort(list.begin(), list.end());
+  return list;
+}
+
+void SiPixelRecHitsComparator::analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup&) const {
+  compareClusters(iEvent);
+  compareRecHits(iEvent);
+}
+
+void SiPixelRecHitsComparator::compareClusters(const edm::Event& iEvent) const {
+  const auto& reference = iEvent.get(referenceClustersToken_);
+  const auto& test = iEvent.get(testClustersToken_);
+  if (reference.size() != test.size() || reference.dataSize() != test.dataSize()) {
+    throw cms::Exception("SiPixelClusterMismatch")
+        << testClustersTag_.encode() << " has " << test.dataSize() << " clusters in " << test.size() << " modules, "
+        << referenceClustersTag_.encode() << " " << reference.dataSize() << " in " << reference.size()
+        << " modules in event " << iEvent.id();
+  }
+  for (auto const& referenceModule : reference) {
+    auto testModule = test.find(referenceModule.detId());
+    if (testModule == test.end() || testModule->size() != referenceModule.size()) {
+      throw cms::Exception("SiPixelClusterMismatch")
+          << "module " << referenceModule.detId() << " has " << referenceModule.size() << " clusters in "
+          << referenceClustersTag_.encode() << ", " << (testModule == test.end() ? 0 : testModule->size()) << " in "
+          << testClustersTag_.encode() << " in event " << iEvent.id();
+    }
+    std::vector<PixelList> referenceClusters, testClusters;
+    for (auto const& cluster : referenceModule)
+      referenceClusters.push_back(pixels(cluster));
+    for (auto const& cluster : *testModule)
+      testClusters.push_back(pixels(cluster));
+    std::sort(referenceClusters.begin(), referenceClusters.end());
+    std::sort(testClusters.begin(), testClusters.end());
+    if (referenceClusters != testClusters) {
+      throw cms::Exception("SiPixelClusterMismatch")
+          << "module " << referenceModule.detId() << " has different clusters in " << referenceClustersTag_.encode()
+          << " and " << testClustersTag_.encode() << " in event " << iEvent.id();
+    }
+  }
+}
+
+void SiPixelRecHitsComparator::compareRecHits(const edm::Event& iEvent) const {
+  const auto& reference = iEvent.get(referenceRecHitsToken_);
+  const auto& test = iEvent.get(testRecHitsToken_);
+  if (reference.size() != test.size() || reference.dataSize() != test.dataSize()) {
+    throw cms::Exception("SiPixelRecHitMismatch")
+        << testRecHitsTag_.encode() << " has " << test.dataSize() << " rechits in " << test.size() << " modules, "
+        << referenceRecHitsTag_.encode() << " " << reference.dataSize() << " in " << reference.size()
+        << " modules in event " << iEvent.id();
+  }
+  auto differ = [this](double a, double b) { return !(std::abs(a - b) <= tolerance_); };
+  for (auto const& referenceModule : reference) {
+    auto testModule = test.find(referenceModule.detId());
+    if (testModule == test.end() || testModule->size() != referenceModule.size()) {
+      throw cms::Exception("SiPixelRecHitMismatch")
+          << "module " << referenceModule.detId() << " has " << referenceModule.size() << " rechits in "
+          << referenceRecHitsTag_.encode() << ", " << (testModule == test.end() ? 0 : testModule->size()) << " in "
+          << testRecHitsTag_.encode() << " in event " << iEvent.id();
+    }
+    // the rechits of both collections, ordered by the pixels of their clusters
+    std::vector<std::pair<PixelList, const SiPixelRecHit*>> referenceHits, testHits;
+    for (auto const& hit : referenceModule)
+      referenceHits.emplace_back(pixels(*hit.cluster()), &hit);
+    for (auto const& hit : *testModule)
+      testHits.emplace_back(pixels(*hit.cluster()), &hit);
+    auto byPixels = [](auto const& a, auto const& b) { return a.first < b.first; };
+    std::sort(referenceHits.begin(), referenceHits.end(), byPixels);
+    std::sort(testHits.begin(), testHits.end(), byPixels);
+    for (std::size_t i = 0; i < referenceHits.size(); i++) {
+      const SiPixelRecHit& referenceHit = *referenceHits[i].second;
+      const SiPixelRecHit& testHit = *testHits[i].second;
+      if (referenceHits[i].first != testHits[i].first) {
+        throw cms::Exception("SiPixelRecHitMismatch")
+            << "module " << referenceModule.detId() << " has rechits of different clusters in "
+            << referenceRecHitsTag_.encode() << " and " << testRecHitsTag_.encode() << " in event " << iEvent.id();
+      }
+      auto const& referencePosition = referenceHit.localPosition();
+      auto const& testPosition = testHit.localPosition();
+      auto const& referenceError = referenceHit.localPositionError();
+      auto const& testError = testHit.localPositionError();
+      if (differ(referencePosition.x(), testPosition.x()) || differ(referencePosition.y(), testPosition.y()) ||
+          differ(referenceError.xx(), testError.xx()) || differ(referenceError.xy(), testError.xy()) ||
+          differ(referenceError.yy(), testError.yy()) || referenceHit.rawQualityWord() != testHit.rawQualityWord()) {
+        throw cms::Exception("SiPixelRecHitMismatch")
+            << "rechit of a cluster of " << referenceHits[i].first.size() << " pixels in module "
+            << referenceModule.detId() << " at " << testPosition << " +- " << testError << " in "
+            << testRecHitsTag_.encode() << ", " << referencePosition << " +- " << referenceError << " in "
+            << referenceRecHitsTag_.encode() << " in event " << iEvent.id();
+      }
+    }
+  }
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(SiPixelRecHitsComparator);
@@ -0,0 +1,46 @@
+# Runs the pixel local reconstruction from the raw data with the siPixelDigis, siPixelClusters and
+# siPixelRecHits chain and with siPixelRawToRecHitsSoA, and checks that they give the same clusters
+# and rechits in every module, whatever their order in the module.
+#
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.Eras.Era_Run2_2017_cff import Run2_2017
+
+process = cms.Process("CompareRecHits", Run2_2017)
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.RawToDigi_Data_cff")
+process.load("RecoLocalTracker.SiPixelClusterizer.SiPixelClusterizer_cfi")
+process.load("RecoLocalTracker.SiPixelRecHits.SiPixelRecHits_cfi")
+process.load("RecoLocalTracker.SiPixelRecHits.PixelCPEESProducers_cff")
+process.load("RecoLocalTracker.SiPixelRecHits.SiPixelRawToRecHitsSoA_cff")
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_data', '')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+        '/store/relval/CMSSW_10_2_0_pre4/DoubleEG/RAW-RECO/ZElectron-102X_dataRun2_PromptLike_v1_RelVal_doubEG2017B-v1/20000/2A91DAFF-9161-E811-93F5-0CC47A4D765E.root'
+    )
+)
+
+process.siPixelRawToRecHitsSoA.InputLabel = 'rawDataCollector'
+
+process.siPixelRecHitsComparator = cms.EDAnalyzer("SiPixelRecHitsComparator",
+    referenceClusters = cms.InputTag("siPixelClusters"),
+    testClusters = cms.InputTag("siPixelRecHitsFromSoA"),
+    referenceRecHits = cms.InputTag("siPixelRecHits"),
+    testRecHits = cms.InputTag("siPixelRecHitsFromSoA"),
+    tolerance = cms.double(1.e-5)
+)
+
+process.p = cms.Path(process.siPixelDigis * process.siPixelClusters * process.siPixelRecHits *
+                     process.siPixelRecHitsComparator, process.siPixelRawToRecHitsSoATask)
@@ -34,6 +34,28 @@ public:
   void suppress(const edm::DetSet<SiStripRawDigi>& in, edm::DetSet<SiStripDigi>& out);
   void suppress(const std::vector<int16_t>& in, uint16_t firstAPV, edm::DetSet<SiStripDigi>& out);
 
+  /*
+    Same decision as isAValidDigi for all 128 strips of one APV at once.
+    adcs, lows and highs hold the strips of the APV starting at index 2 and are padded
+    with two strips on both sides with an adc of 0 and thresholds of 9999, which is
+    what the FED assumes for the neighbours across the edges of the chip.
+    Written without branches so that the loop over the strips is vectorised.
+  */
+  template <uint16_t FEDalgorithm>
+  static void selectStrips(const int16_t* adcs, const int16_t* lows, const int16_t* highs, bool* accepted);
+
+  /*
+    Fills adcs, lows and highs as selectStrips expects them with the first nStrips (at most 128)
+    strips of an APV. The strips missing from a partial APV are padded like the edges of the chip.
+  */
+  static void fillAPV(const int16_t* in,
+                      const int16_t* lowThr,
+                      const int16_t* highThr,
+                      unsigned int nStrips,
+                      int16_t* adcs,
+                      int16_t* lows,
+                      int16_t* highs);
+
   uint16_t truncate(int16_t adc) const {
     if (adc > 253 && doTruncate && !doTruncate10bits)
       return ((adc == 1023) ? 255 : 254);
@@ -78,4 +100,50 @@ private:
 
   void fillThresholds_(const uint32_t detID, size_t size);
 };
+
+template <uint16_t FEDalgorithm>
+void SiStripFedZeroSuppression::selectStrips(const int16_t* adcs,
+                                             const int16_t* lows,
+                                             const int16_t* highs,
+                                             bool* accepted) {
+  for (unsigned int i = 0; i < 128; ++i) {
+    const unsigned int s = i + 2;
+    const int16_t adc = adcs[s];
+    const int16_t adcPrev = adcs[s - 1];
+    const int16_t adcNext = adcs[s + 1];
+    const bool prevIsMax = adcNext < adcPrev;
+    const int16_t adcMaxNeigh = prevIsMax ? adcPrev : adcNext;
+    const int16_t theNeighFEDlowThresh = prevIsMax ? lows[s - 1] : lows[s + 1];
+    const int16_t theNeighFEDhighThresh = prevIsMax ? highs[s - 1] : highs[s + 1];
+
+    bool accept = false;
+    switch (FEDalgorithm) {
+      case 1:
+        accept = (adc >= lows[s]);
+        break;
+      case 2:
+        accept = (adc >= highs[s]) | ((adc >= lows[s]) & (adcMaxNeigh >= theNeighFEDlowThresh));
+        break;
+      case 3:
+        accept = (adc >= highs[s]) | ((adc >= lows[s]) & (adcMaxNeigh >= theNeighFEDhighThresh));
+        break;
+      case 4: {
+        const int16_t adcPrev2 = adcs[s - 2];
+        const int16_t adcNext2 = adcs[s + 2];
+        const bool bothNeighHigh = (adcPrev >= highs[s - 1]) & (adcNext >= highs[s + 1]);
+        const bool prevHighNextLow = (adcPrev >= highs[s - 1]) & (adcNext >= lows[s + 1]) & (adcNext2 >= lows[s + 2]);
+        const bool nextHighPrevLow = (adcNext >= highs[s + 1]) & (adcPrev >= lows[s - 1]) & (adcPrev2 >= lows[s - 2]);
+        const bool allNeighLow = (adcNext >= lows[s + 1]) & (adcNext2 >= lows[s + 2]) & (adcPrev >= lows[s - 1]) &
+                                 (adcPrev2 >= lows[s - 2]);
+        accept = (adc >= highs[s]) | ((adc >= lows[s]) & (adcMaxNeigh >= theNeighFEDlowThresh)) |
+                 ((adc < lows[s]) & (bothNeighHigh | prevHighNextLow | nextHighPrevLow | allNeighLow));
+        break;
+      }
+      case 5:
+        accept = adc > 0;
+        break;
+    }
+    accepted[i] = accept;
+  }
+}
 #endif
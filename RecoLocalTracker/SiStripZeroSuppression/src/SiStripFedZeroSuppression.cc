@@ -5,6 +5,8 @@
 #include "CondFormats/DataRecord/interface/SiStripThresholdRcd.h"
 #include "CondFormats/SiStripObjects/interface/SiStripThreshold.h"
 
+#include <algorithm>
+
 //#define DEBUG_SiStripZeroSuppression_
 //#define ML_DEBUG
 using namespace std;
@@ -276,101 +278,73 @@ void SiStripFedZeroSuppression::suppress(const std::vector<int16_t>& in,
 
   fillThresholds_(detID, size + firstAPV * 128);  // want to decouple this from the other cost
 
-  std::vector<int16_t>::const_iterator in_iter = in.begin();
-  uint16_t strip = firstAPV * 128;
-  for (; strip < size + firstAPV * 128; ++strip, ++in_iter) {
-    size_t strip_mod_128 = strip & 127;
-#ifdef DEBUG_SiStripZeroSuppression_
-    if (edm::isDebugEnabled())
-      LogTrace("SiStripZeroSuppression") << "[SiStripFedZeroSuppression::suppress]  detID= " << detID
-                                         << " strip= " << strip << "  adc= " << *in_iter;
-#endif
-    adc = *in_iter;
-
-    theFEDlowThresh = lowThr_[strip];
-    theFEDhighThresh = highThr_[strip];
-
-    //Find adc values for neighbouring strips
-
-    /*
-      If a strip is the last one on the chip
-      set its next neighbor's thresholds to infinity
-      because the FED does not merge clusters across
-      chip boundaries right now
-    */
-
-    //adcPrev = -9999;  // useless, they are set
-    //adcNext = -9999;  // in the next lines in any case
-    if (strip_mod_128 == 127) {
-      adcNext = 0;
-      theNextFEDlowThresh = 9999;
-      theNextFEDhighThresh = 9999;
-    } else {
-      adcNext = *(in_iter + 1);
-      theNextFEDlowThresh = lowThr_[strip + 1];
-      theNextFEDhighThresh = highThr_[strip + 1];
+  // one APV at a time, padded with the values the FED uses beyond the edges of the chip
+  alignas(32) int16_t adcs[128 + 4];
+  alignas(32) int16_t lows[128 + 4];
+  alignas(32) int16_t highs[128 + 4];
+  bool accepted[128];
+
+  for (size_t first = 0; first < size; first += 128) {
+    // the last APV may be partial, only its strips are read and selected
+    const unsigned int nStrips = std::min<size_t>(128, size - first);
+    const uint16_t apvStrip = firstAPV * 128 + first;
+    fillAPV(in.data() + first, lowThr_.data() + apvStrip, highThr_.data() + apvStrip, nStrips, adcs, lows, highs);
+
+    switch (theFEDalgorithm) {
+      case 1:
+        selectStrips<1>(adcs, lows, highs, accepted);
+        break;
+      case 2:
+        selectStrips<2>(adcs, lows, highs, accepted);
+        break;
+      case 3:
+        selectStrips<3>(adcs, lows, highs, accepted);
+        break;
+      case 4:
+        selectStrips<4>(adcs, lows, highs, accepted);
+        break;
+      case 5:
+        selectStrips<5>(adcs, lows, highs, accepted);
+        break;
+      default:
+        std::fill(accepted, accepted + 128, false);
     }
 
-    /*
-      Similarily, for the first strip 
-      on a chip
-    */
-    if (strip_mod_128 == 0) {
-      adcPrev = 0;
-      thePrevFEDlowThresh = 9999;
-      thePrevFEDhighThresh = 9999;
-    } else {
-      adcPrev = *(in_iter - 1);
-      thePrevFEDlowThresh = lowThr_[strip - 1];
-      thePrevFEDhighThresh = highThr_[strip - 1];
-    }
-
-    if (adcNext < adcPrev) {
-      adcMaxNeigh = adcPrev;
-      theNeighFEDlowThresh = thePrevFEDlowThresh;
-      theNeighFEDhighThresh = thePrevFEDhighThresh;
-    } else {
-      adcMaxNeigh = adcNext;
-      theNeighFEDlowThresh = theNextFEDlowThresh;
-      theNeighFEDhighThresh = theNextFEDhighThresh;
-    }
-
-    //Find adc values for next neighbouring strips
-    //adcPrev2 = -9999;           //
-    //adcNext2 = -9999;           // useless to set them here
-    //thePrev2FEDlowThresh  = 1;  // they are overwritten always in the next 8 lines
-    //theNext2FEDlowThresh  = 1;  //
-    if (strip_mod_128 >= 126) {
-      adcNext2 = 0;
-      theNext2FEDlowThresh = 9999;
-      //} else if ( strip_mod_128 < 126 ) { // if it's not >= then is <, no need to "if" again
-    } else {
-      adcNext2 = *(in_iter + 2);
-      theNext2FEDlowThresh = lowThr_[strip + 2];
-    }
-    if (strip_mod_128 <= 1) {
-      adcPrev2 = 0;
-      thePrev2FEDlowThresh = 9999;
-      //} else if ( strip_mod_128 > 1 ) { // same as above
-    } else {
-      adcPrev2 = *(in_iter - 2);
-      thePrev2FEDlowThresh = lowThr_[strip - 2];
-      ;
-    }
-
-    if (isAValidDigi()) {
+    for (uint16_t i = 0; i < nStrips; ++i) {
+      if (accepted[i]) {
+        const uint16_t strip = apvStrip + i;
+        const int16_t adc = in[first + i];
 #ifdef DEBUG_SiStripZeroSuppression_
-      if (edm::isDebugEnabled())
-        LogTrace("SiStripZeroSuppression")
-            << "[SiStripFedZeroSuppression::suppress] DetId " << out.id << " strip " << strip << " adc " << *in_iter
-            << " digiCollection size " << out.data.size();
+        if (edm::isDebugEnabled())
+          LogTrace("SiStripZeroSuppression")
+              << "[SiStripFedZeroSuppression::suppress] DetId " << out.id << " strip " << strip << " adc " << adc
+              << " digiCollection size " << out.data.size();
 #endif
-      //GB 23/6/08: truncation should be done at the very beginning
-      out.push_back(SiStripDigi(strip, (*in_iter < 0 ? 0 : truncate(*in_iter))));
+        //GB 23/6/08: truncation should be done at the very beginning
+        out.push_back(SiStripDigi(strip, (adc < 0 ? 0 : truncate(adc))));
+      }
     }
   }
 }
 
+void SiStripFedZeroSuppression::fillAPV(const int16_t* in,
+                                        const int16_t* lowThr,
+                                        const int16_t* highThr,
+                                        unsigned int nStrips,
+                                        int16_t* adcs,
+                                        int16_t* lows,
+                                        int16_t* highs) {
+  std::fill(adcs, adcs + 2, 0);
+  std::fill(lows, lows + 2, 9999);
+  std::fill(highs, highs + 2, 9999);
+  std::copy(in, in + nStrips, adcs + 2);
+  std::copy(lowThr, lowThr + nStrips, lows + 2);
+  std::copy(highThr, highThr + nStrips, highs + 2);
+  std::fill(adcs + 2 + nStrips, adcs + 128 + 4, 0);
+  std::fill(lows + 2 + nStrips, lows + 128 + 4, 9999);
+  std::fill(highs + 2 + nStrips, highs + 128 + 4, 9999);
+}
+
 bool SiStripFedZeroSuppression::isAValidDigi() {
 #ifdef DEBUG_SiStripZeroSuppression_
 
@@ -0,0 +1,101 @@
+#ifndef RECOLOCALTRACKER_SISTRIPZEROSUPPRESSION_TEST_SISTRIPFEDZEROSUPPRESSIONREFERENCE_H
+#define RECOLOCALTRACKER_SISTRIPZEROSUPPRESSION_TEST_SISTRIPFEDZEROSUPPRESSIONREFERENCE_H
+
+#include <cstdint>
+
+/*
+  The strip by strip zero suppression SiStripFedZeroSuppression::suppress used
+  for raw data before SiStripFedZeroSuppression::selectStrips, on the strips of
+  whole APVs with their thresholds in adc counts.
+*/
+inline bool referenceAccept(
+    uint16_t algorithm, const int16_t* in, const int16_t* lowThr, const int16_t* highThr, int strip) {
+  const int strip_mod_128 = strip & 127;
+  const int16_t adc = in[strip];
+  const int16_t theFEDlowThresh = lowThr[strip];
+  const int16_t theFEDhighThresh = highThr[strip];
+  int16_t adcPrev, adcNext, adcPrev2, adcNext2, adcMaxNeigh;
+  int16_t thePrevFEDlowThresh, thePrevFEDhighThresh, theNextFEDlowThresh, theNextFEDhighThresh;
+  int16_t theNeighFEDlowThresh, theNeighFEDhighThresh, thePrev2FEDlowThresh, theNext2FEDlowThresh;
+  if (strip_mod_128 == 127) {
+    adcNext = 0;
+    theNextFEDlowThresh = 9999;
+    theNextFEDhighThresh = 9999;
+  } else {
+    adcNext = in[strip + 1];
+    theNextFEDlowThresh = lowThr[strip + 1];
+    theNextFEDhighThresh = highThr[strip + 1];
+  }
+  if (strip_mod_128 == 0) {
+    adcPrev = 0;
+    thePrevFEDlowThresh = 9999;
+    thePrevFEDhighThresh = 9999;
+  } else {
+    adcPrev = in[strip - 1];
+    thePrevFEDlowThresh = lowThr[strip - 1];
+    thePrevFEDhighThresh = highThr[strip - 1];
+  }
+  if (adcNext < adcPrev) {
+    adcMaxNeigh = adcPrev;
+    theNeighFEDlowThresh = thePrevFEDlowThresh;
+    theNeighFEDhighThresh = thePrevFEDhighThresh;
+  } else {
+    adcMaxNeigh = adcNext;
+    theNeighFEDlowThresh = theNextFEDlowThresh;
+    theNeighFEDhighThresh = theNextFEDhighThresh;
+  }
+  if (strip_mod_128 >= 126) {
+    adcNext2 = 0;
+    theNext2FEDlowThresh = 9999;
+  } else {
+    adcNext2 = in[strip + 2];
+    theNext2FEDlowThresh = lowThr[strip + 2];
+  }
+  if (strip_mod_128 <= 1) {
+    adcPrev2 = 0;
+    thePrev2FEDlowThresh = 9999;
+  } else {
+    adcPrev2 = in[strip - 2];
+    thePrev2FEDlowThresh = lowThr[strip - 2];
+  }
+
+  switch (algorithm) {
+    case 1:
+      return (adc >= theFEDlowThresh);
+    case 2:
+      return (adc >= theFEDhighThresh || (adc >= theFEDlowThresh && adcMaxNeigh >= theNeighFEDlowThresh));
+    case 3:
+      return (adc >= theFEDhighThresh || (adc >= theFEDlowThresh && adcMaxNeigh >= theNeighFEDhighThresh));
+    case 4:
+      return ((adc >= theFEDhighThresh) || ((adc >= theFEDlowThresh) && (adcMaxNeigh >= theNeighFEDlowThresh)) ||
+              ((adc < theFEDlowThresh) &&
+               (((adcPrev >= thePrevFEDhighThresh) && (adcNext >= theNextFEDhighThresh)) ||
+                ((adcPrev >= thePrevFEDhighThresh) && (adcNext >= theNextFEDlowThresh) &&
+                 (adcNext2 >= theNext2FEDlowThresh)) ||
+                ((adcNext >= theNextFEDhighThresh) && (adcPrev >= thePrevFEDlowThresh) &&
+                 (adcPrev2 >= thePrev2FEDlowThresh)) ||
+                ((adcNext >= theNextFEDlowThresh) && (adcNext2 >= theNext2FEDlowThresh) &&
+                 (adcPrev >= thePrevFEDlowThresh) && (adcPrev2 >= thePrev2FEDlowThresh)))));
+    case 5:
+      return adc > 0;
+  }
+  return false;
+}
+
+// pad one APV the way SiStripFedZeroSuppression::selectStrips expects it
+inline void padAPV(const int16_t* in,
+                   const int16_t* lowThr,
+                   const int16_t* highThr,
+                   int16_t* adcs,
+                   int16_t* lows,
+                   int16_t* highs) {
+  adcs[0] = adcs[1] = adcs[130] = adcs[131] = 0;
+  lows[0] = lows[1] = lows[130] = lows[131] = 9999;
+  highs[0] = highs[1] = highs[130] = highs[131] = 9999;
+  for (unsigned int i = 0; i < 128; ++i) {
+    adcs[i + 2] = in[i];
+    lows[i + 2] = lowThr[i];
+    highs[i + 2] = highThr[i];
+  }
+}
+#endif
@@ -0,0 +1,64 @@
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/SiStripFedZeroSuppression.h"
+#include "RecoLocalTracker/SiStripZeroSuppression/test/SiStripFedZeroSuppressionReference.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+// Zero suppression of a 6 APV module with typical noise and a few hits, strip by strip
+// as SiStripFedZeroSuppression did before and with SiStripFedZeroSuppression::selectStrips.
+
+namespace {
+  constexpr unsigned int kAPVsPerModule = 6;
+
+  struct Module {
+    Module() {
+      std::mt19937 engine(42);
+      std::normal_distribution<float> noise(0.f, 4.f);
+      std::uniform_int_distribution<int> thresholds(8, 20);
+      for (unsigned int strip = 0; strip < kAPVsPerModule * 128; ++strip) {
+        in[strip] = (strip % 40 == 0) ? 80 : static_cast<int16_t>(noise(engine));
+        lowThr[strip] = thresholds(engine) / 2;
+        highThr[strip] = thresholds(engine);
+      }
+    }
+    int16_t in[kAPVsPerModule * 128], lowThr[kAPVsPerModule * 128], highThr[kAPVsPerModule * 128];
+  };
+
+  template <uint16_t ALGO>
+  void BM_StripByStrip(benchmark::State& state) {
+    const Module module;
+    for (auto _ : state) {
+      unsigned int nAccepted = 0;
+      for (unsigned int strip = 0; strip < kAPVsPerModule * 128; ++strip)
+        nAccepted += referenceAccept(ALGO, module.in, module.lowThr, module.highThr, strip);
+      benchmark::DoNotOptimize(nAccepted);
+    }
+    state.SetItemsProcessed(state.iterations() * kAPVsPerModule * 128);
+  }
+
+  template <uint16_t ALGO>
+  void BM_SelectStrips(benchmark::State& state) {
+    const Module module;
+    alignas(32) int16_t adcs[132], lows[132], highs[132];
+    bool accepted[128];
+    for (auto _ : state) {
+      unsigned int nAccepted = 0;
+      for (unsigned int apv = 0; apv < kAPVsPerModule; ++apv) {
+        padAPV(module.in + apv * 128, module.lowThr + apv * 128, module.highThr + apv * 128, adcs, lows, highs);
+        SiStripFedZeroSuppression::selectStrips<ALGO>(adcs, lows, highs, accepted);
+        for (unsigned int i = 0; i < 128; ++i)
+          nAccepted += accepted[i];
+      }
+      benchmark::DoNotOptimize(nAccepted);
+    }
+    state.SetItemsProcessed(state.iterations() * kAPVsPerModule * 128);
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_StripByStrip, 3);
+BENCHMARK_TEMPLATE(BM_SelectStrips, 3);
+BENCHMARK_TEMPLATE(BM_StripByStrip, 4);
+BENCHMARK_TEMPLATE(BM_SelectStrips, 4);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/SiStripFedZeroSuppression.h"
+#include "RecoLocalTracker/SiStripZeroSuppression/test/SiStripFedZeroSuppressionReference.h"
+
+#include <cassert>
+#include <iostream>
+#include <random>
+
+namespace {
+  void select(uint16_t algorithm, const int16_t* adcs, const int16_t* lows, const int16_t* highs, bool* accepted) {
+    switch (algorithm) {
+      case 1:
+        SiStripFedZeroSuppression::selectStrips<1>(adcs, lows, highs, accepted);
+        break;
+      case 2:
+        SiStripFedZeroSuppression::selectStrips<2>(adcs, lows, highs, accepted);
+        break;
+      case 3:
+        SiStripFedZeroSuppression::selectStrips<3>(adcs, lows, highs, accepted);
+        break;
+      case 4:
+        SiStripFedZeroSuppression::selectStrips<4>(adcs, lows, highs, accepted);
+        break;
+      case 5:
+        SiStripFedZeroSuppression::selectStrips<5>(adcs, lows, highs, accepted);
+        break;
+    }
+  }
+}  // namespace
+
+int main() {
+  constexpr unsigned int nAPVs = 6;
+  std::mt19937 engine(42);
+  // thresholds and adcs close to each other, so that all branches are exercised
+  std::uniform_int_distribution<int> adcDist(-20, 60);
+  std::uniform_int_distribution<int> thrDist(0, 40);
+
+  int16_t in[nAPVs * 128], lowThr[nAPVs * 128], highThr[nAPVs * 128];
+  int16_t adcs[132], lows[132], highs[132];
+  bool accepted[128];
+  for (uint16_t algorithm = 1; algorithm <= 5; ++algorithm) {
+    for (unsigned int iTest = 0; iTest < 1000; ++iTest) {
+      for (unsigned int strip = 0; strip < nAPVs * 128; ++strip) {
+        in[strip] = adcDist(engine);
+        lowThr[strip] = thrDist(engine);
+        highThr[strip] = lowThr[strip] + thrDist(engine) / 2;
+      }
+      for (unsigned int apv = 0; apv < nAPVs; ++apv) {
+        padAPV(in + apv * 128, lowThr + apv * 128, highThr + apv * 128, adcs, lows, highs);
+        select(algorithm, adcs, lows, highs, accepted);
+        for (unsigned int i = 0; i < 128; ++i) {
+          assert(accepted[i] == referenceAccept(algorithm, in, lowThr, highThr, apv * 128 + i));
+        }
+      }
+    }
+  }
+
+  // a partial APV is selected as if its missing strips were beyond the edge of the chip
+  int16_t tail[128], tailLowThr[128], tailHighThr[128];
+  for (uint16_t algorithm = 1; algorithm <= 5; ++algorithm) {
+    for (unsigned int nStrips = 1; nStrips < 128; ++nStrips) {
+      for (unsigned int strip = 0; strip < 128; ++strip) {
+        tail[strip] = strip < nStrips ? adcDist(engine) : 0;
+        tailLowThr[strip] = strip < nStrips ? thrDist(engine) : 9999;
+        tailHighThr[strip] = strip < nStrips ? tailLowThr[strip] + thrDist(engine) / 2 : 9999;
+      }
+      SiStripFedZeroSuppression::fillAPV(tail, tailLowThr, tailHighThr, nStrips, adcs, lows, highs);
+      select(algorithm, adcs, lows, highs, accepted);
+      for (unsigned int i = 0; i < nStrips; ++i) {
+        assert(accepted[i] == referenceAccept(algorithm, tail, tailLowThr, tailHighThr, i));
+      }
+    }
+  }
+
+  std::cout << "SiStripFedZeroSuppression::selectStrips agrees with the strip by strip selection" << std::endl;
+  return 0;
+}
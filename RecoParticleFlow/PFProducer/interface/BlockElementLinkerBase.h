@@ -18,6 +18,17 @@ public:
 
   virtual double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const = 0;
 
+  // Linkers which only link elements close in (eta, phi) can give the largest distance of a
+  // link and the position of the elements: PFBlockAlgo then finds the pairs to test with a
+  // KD-tree instead of testing all the pairs of elements.
+  // A link must imply |deta| <= linkWindow() and |dphi| <= linkWindow().
+  virtual float linkWindow() const { return -1.f; }
+
+  // Position used for the spatial index, false if the element can not be linked by this linker
+  virtual bool linkPosition(const reco::PFBlockElement*, double& eta, double& phi) const { return false; }
+
+  bool useSpatialIndex() const { return linkWindow() > 0.f; }
+
   const std::string& name() const { return _linkerName; }
 
 private:
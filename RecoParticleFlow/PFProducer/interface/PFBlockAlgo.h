@@ -67,6 +67,10 @@ private:
   /// check whether 2 elements are linked. Returns distance
   inline void link(const reco::PFBlockElement* el1, const reco::PFBlockElement* el2, double& dist) const;
 
+  /// for each element, the sorted indices of the elements which may be linked to it
+  /// by the linkers with a spatial index, found with a KD-tree in (eta, phi)
+  void findSpatialCandidates(std::vector<std::vector<unsigned>>& candidates) const;
+
   // the test elements will be transferred to the blocks
   ElementList elements_;
   ElementRanges ranges_;
@@ -82,6 +86,9 @@ private:
   const std::unordered_map<std::string, reco::PFBlockElement::Type> elementTypes_;
   std::vector<std::unique_ptr<BlockElementLinkerBase>> linkTests_;
   unsigned int linkTestSquare_[reco::PFBlockElement::kNBETypes][reco::PFBlockElement::kNBETypes];
+  // linkers which only test the pairs found with their spatial index
+  std::vector<unsigned int> spatialLinkTests_;
+  std::vector<bool> useSpatialIndex_;
 
   std::vector<std::unique_ptr<KDTreeLinkerBase>> kdtrees_;
 };
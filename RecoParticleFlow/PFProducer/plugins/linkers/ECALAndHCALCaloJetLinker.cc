@@ -12,6 +12,10 @@ public:
 
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  float linkWindow() const override { return 0.2f; }
+
+  bool linkPosition(const reco::PFBlockElement*, double& eta, double& phi) const override;
+
 private:
   bool _useKDTree, _debug;
 };
@@ -46,3 +50,13 @@ double ECALAndHCALCaloJetLinker::testLink(const reco::PFBlockElement* elem1, con
 
   return (dist < 0.2 ? dist : -1.0);
 }
+
+bool ECALAndHCALCaloJetLinker::linkPosition(const reco::PFBlockElement* elem, double& eta, double& phi) const {
+  const reco::PFClusterRef& clusterref = static_cast<const reco::PFBlockElementCluster*>(elem)->clusterRef();
+  if (clusterref.isNull()) {
+    throw cms::Exception("BadClusterRefs") << "PFBlockElementCluster's refs are null!";
+  }
+  eta = clusterref->positionREP().Eta();
+  phi = clusterref->positionREP().Phi();
+  return true;
+}
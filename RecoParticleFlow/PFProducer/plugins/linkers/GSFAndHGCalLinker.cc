@@ -13,6 +13,10 @@ public:
 
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  float linkWindow() const override { return 0.3f; }
+
+  bool linkPosition(const reco::PFBlockElement*, double& eta, double& phi) const override;
+
 private:
   bool _useKDTree, _debug;
 };
@@ -54,3 +58,20 @@ double GSFAndHGCalLinker::testLink(const reco::PFBlockElement* elem1, const reco
 
   return dist;
 }
+
+bool GSFAndHGCalLinker::linkPosition(const reco::PFBlockElement* elem, double& eta, double& phi) const {
+  if (elem->type() == reco::PFBlockElement::GSF) {
+    const reco::PFTrajectoryPoint& tkAtECAL =
+        static_cast<const reco::PFBlockElementGsfTrack*>(elem)->GsftrackPF().extrapolatedPoint(
+            reco::PFTrajectoryPoint::ECALShowerMax);
+    if (!tkAtECAL.isValid())
+      return false;
+    eta = tkAtECAL.positionREP().eta();
+    phi = tkAtECAL.positionREP().phi();
+  } else {
+    const reco::PFClusterRef& clusterref = static_cast<const reco::PFBlockElementCluster*>(elem)->clusterRef();
+    eta = clusterref->positionREP().Eta();
+    phi = clusterref->positionREP().Phi();
+  }
+  return true;
+}
@@ -12,6 +12,10 @@ public:
 
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  float linkWindow() const override { return 0.2f; }
+
+  bool linkPosition(const reco::PFBlockElement*, double& eta, double& phi) const override;
+
 private:
   bool _useKDTree, _debug;
 };
@@ -40,3 +44,14 @@ double HCALAndHOLinker::testLink(const reco::PFBlockElement* elem1, const reco::
               : -1.0);
   return (dist < 0.2 ? dist : -1.0);
 }
+
+bool HCALAndHOLinker::linkPosition(const reco::PFBlockElement* elem, double& eta, double& phi) const {
+  const reco::PFClusterRef& clusterref = static_cast<const reco::PFBlockElementCluster*>(elem)->clusterRef();
+  if (clusterref.isNull()) {
+    throw cms::Exception("BadClusterRefs") << "PFBlockElementCluster's refs are null!";
+  }
+  eta = clusterref->positionREP().Eta();
+  phi = clusterref->positionREP().Phi();
+  // only the barrel HCAL clusters are linked
+  return (elem->type() != reco::PFBlockElement::HCAL || std::abs(eta) < 1.5);
+}
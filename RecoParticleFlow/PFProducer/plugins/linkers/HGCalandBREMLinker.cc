@@ -13,6 +13,10 @@ public:
 
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  float linkWindow() const override { return 0.3f; }
+
+  bool linkPosition(const reco::PFBlockElement*, double& eta, double& phi) const override;
+
 private:
   bool _useKDTree, _debug;
 };
@@ -44,3 +48,20 @@ double HGCalAndBREMLinker::testLink(const reco::PFBlockElement* elem1, const rec
   }
   return dist;
 }
+
+bool HGCalAndBREMLinker::linkPosition(const reco::PFBlockElement* elem, double& eta, double& phi) const {
+  if (elem->type() == reco::PFBlockElement::BREM) {
+    const reco::PFTrajectoryPoint& tkAtECAL =
+        static_cast<const reco::PFBlockElementBrem*>(elem)->trackPF().extrapolatedPoint(
+            reco::PFTrajectoryPoint::ECALShowerMax);
+    if (!tkAtECAL.isValid())
+      return false;
+    eta = tkAtECAL.positionREP().eta();
+    phi = tkAtECAL.positionREP().phi();
+  } else {
+    const reco::PFClusterRef& clusterref = static_cast<const reco::PFBlockElementCluster*>(elem)->clusterRef();
+    eta = clusterref->positionREP().Eta();
+    phi = clusterref->positionREP().Phi();
+  }
+  return true;
+}
@@ -1,4 +1,5 @@
 #include "RecoParticleFlow/PFProducer/interface/PFBlockAlgo.h"
+#include "CommonTools/RecoAlgos/interface/KDTreeLinkerAlgo.h"
 #include "FWCore/Framework/interface/ProductRegistryHelper.h"
 #include "FWCore/Framework/src/WorkerMaker.h"
 #include "FWCore/MessageLogger/interface/ErrorObj.h"
@@ -8,6 +9,7 @@
 #include <algorithm>
 #include <iostream>
 #include <array>
+#include <cmath>
 #include <iterator>
 #include <sstream>
 #include <type_traits>
@@ -91,6 +93,8 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
     }
   }
   linkTests_.resize(rowsize * rowsize);
+  spatialLinkTests_.clear();
+  useSpatialIndex_.assign(rowsize * rowsize, false);
   const std::string prefix("PFBlockElement::");
   const std::string pfx_kdtree("KDTree");
   for (const auto& conf : confs) {
@@ -113,6 +117,10 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
     linkTests_[index] = BlockElementLinkerFactory::get()->create(linkerName, conf);
     linkTestSquare_[type1][type2] = index;
     linkTestSquare_[type2][type1] = index;
+    if (linkTests_[index]->useSpatialIndex()) {
+      spatialLinkTests_.push_back(index);
+      useSpatialIndex_[index] = true;
+    }
     // setup KDtree if requested
     const bool useKDTree = conf.getParameter<bool>("useKDTree");
     if (useKDTree) {
@@ -148,27 +156,47 @@ reco::PFBlockCollection PFBlockAlgo::findBlocks() {
   // the blocks have not been passed to the event, and need to be cleared
   blocks.reserve(elements_.size());
 
+  std::vector<std::vector<unsigned>> candidates;
+  if (!spatialLinkTests_.empty())
+    findSpatialCandidates(candidates);
+
   QuickUnion qu(elements_.size());
+  auto testLink = [&](unsigned i, unsigned j) {
+    if (qu.connected(i, j) || j == i)
+      return;
+    auto p1(elements_[i].get()), p2(elements_[j].get());
+    const PFBlockElement::Type type1 = p1->type();
+    const PFBlockElement::Type type2 = p2->type();
+    const unsigned index = linkTestSquare_[type1][type2];
+    if (linkTests_[index]->linkPrefilter(p1, p2)) {
+      const double dist = linkTests_[index]->testLink(p1, p2);
+      // compute linking info if it is possible
+      if (dist > -0.5) {
+        qu.unite(i, j);
+      }
+    }
+  };
   const auto elem_size = elements_.size();
   for (unsigned i = 0; i < elem_size; ++i) {
     for (unsigned j = 0; j < elem_size; ++j) {
+      const unsigned index = linkTestSquare_[elements_[i]->type()][elements_[j]->type()];
+      if (useSpatialIndex_[index]) {
+        // only the candidates of this type, in the same order as in the loop over all the elements
+        const unsigned last = ranges_[elements_[j]->type()].second;
+        for (auto k = std::lower_bound(candidates[i].begin(), candidates[i].end(), j);
+             k != candidates[i].end() && *k <= last;
+             ++k)
+          testLink(i, *k);
+        j = last;
+        continue;
+      }
       if (qu.connected(i, j) || j == i)
         continue;
-      if (!linkTests_[linkTestSquare_[elements_[i]->type()][elements_[j]->type()]]) {
+      if (!linkTests_[index]) {
         j = ranges_[elements_[j]->type()].second;
         continue;
       }
-      auto p1(elements_[i].get()), p2(elements_[j].get());
-      const PFBlockElement::Type type1 = p1->type();
-      const PFBlockElement::Type type2 = p2->type();
-      const unsigned index = linkTestSquare_[type1][type2];
-      if (linkTests_[index]->linkPrefilter(p1, p2)) {
-        const double dist = linkTests_[index]->testLink(p1, p2);
-        // compute linking info if it is possible
-        if (dist > -0.5) {
-          qu.unite(i, j);
-        }
-      }
+      testLink(i, j);
     }
   }
 
@@ -216,6 +244,71 @@ reco::PFBlockCollection PFBlockAlgo::findBlocks() {
   return blocks;
 }
 
+void PFBlockAlgo::findSpatialCandidates(std::vector<std::vector<unsigned>>& candidates) const {
+  constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
+  candidates.assign(elements_.size(), std::vector<unsigned>());
+
+  // indices of the elements of a type, which are contiguous after buildElements
+  auto typeRange = [this](unsigned type) {
+    const auto& range = ranges_[type];
+    if (elements_.empty() || elements_[range.first]->type() != type)
+      return std::make_pair(0u, 0u);
+    return std::make_pair(range.first, range.second + 1);
+  };
+
+  std::vector<KDTreeNodeInfo<unsigned, 2>> eltList;
+  std::vector<unsigned> found;
+  for (auto index : spatialLinkTests_) {
+    const auto& linker = *linkTests_[index];
+    const auto range1 = typeRange(index % rowsize);
+    const auto range2 = typeRange(index / rowsize);
+    if (range1.first == range1.second || range2.first == range2.second)
+      continue;
+    // margin for the float precision of the tree
+    const float window = linker.linkWindow() + 1.e-4f;
+
+    // the elements of the second type, the ones close to phi = +-pi being also added at phi -+ 2pi
+    eltList.clear();
+    float etamin = 0.f, etamax = 0.f;
+    for (unsigned j = range2.first; j < range2.second; ++j) {
+      double eta, phi;
+      if (!linker.linkPosition(elements_[j].get(), eta, phi))
+        continue;
+      eltList.emplace_back(j, float(eta), float(phi));
+      if (phi > M_PI - window)
+        eltList.emplace_back(j, float(eta), float(phi - 2. * M_PI));
+      if (phi < -M_PI + window)
+        eltList.emplace_back(j, float(eta), float(phi + 2. * M_PI));
+      etamin = std::min(etamin, float(eta));
+      etamax = std::max(etamax, float(eta));
+    }
+    if (eltList.empty())
+      continue;
+    KDTreeLinkerAlgo<unsigned, 2> tree;
+    tree.build(eltList, KDTreeBox<2>(etamin, etamax, float(-M_PI) - window, float(M_PI) + window));
+
+    for (unsigned i = range1.first; i < range1.second; ++i) {
+      double eta, phi;
+      if (!linker.linkPosition(elements_[i].get(), eta, phi))
+        continue;
+      found.clear();
+      tree.search(KDTreeBox<2>(float(eta) - window, float(eta) + window, float(phi) - window, float(phi) + window),
+                  found);
+      for (auto j : found) {
+        if (j == i)
+          continue;
+        candidates[i].push_back(j);
+        candidates[j].push_back(i);
+      }
+    }
+  }
+
+  for (auto& list : candidates) {
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+  }
+}
+
 void PFBlockAlgo::packLinks(reco::PFBlock& block,
                             const std::unordered_map<std::pair<unsigned int, unsigned int>, double>& links) const {
   constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
@@ -0,0 +1,186 @@
+/*
+ * Links the elements of the PF blocks again by testing every pair of elements with the linkers of
+ * the block producer, without the KD-tree of the linkers with a spatial window, and throws if the
+ * connected elements are not the blocks. Counts the links of the linkers with a spatial window
+ * across phi = +-pi, and throws at the end of the job if the sample had less than
+ * minWrapAroundLinks of them.
+ */
+
+#include "DataFormats/ParticleFlowReco/interface/PFBlock.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockFwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "RecoParticleFlow/PFProducer/interface/BlockElementLinkerBase.h"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+class PFBlockBruteForceComparator : public edm::one::EDAnalyzer<> {
+public:
+  explicit PFBlockBruteForceComparator(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions&);
+
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob() override;
+
+private:
+  typedef reco::PFBlockElement::Type Type;
+
+  static Type elementType(const std::string& name);
+
+  const edm::EDGetTokenT<reco::PFBlockCollection> blocksToken_;
+  const unsigned int minWrapAroundLinks_;
+  std::vector<std::unique_ptr<BlockElementLinkerBase>> linkers_;
+  std::array<std::array<const BlockElementLinkerBase*, reco::PFBlockElement::kNBETypes>,
+             reco::PFBlockElement::kNBETypes>
+      linkerSquare_;
+
+  unsigned long nBlocks_ = 0;
+  unsigned long nSpatialLinks_ = 0;
+  unsigned long nWrapAroundLinks_ = 0;
+};
+
+namespace {
+  std::vector<unsigned> connectedComponents(const std::vector<std::pair<unsigned, unsigned>>& links, unsigned size) {
+    std::vector<unsigned> id(size);
+    std::iota(id.begin(), id.end(), 0);
+    auto find = [&id](unsigned p) {
+      while (p != id[p]) {
+        id[p] = id[id[p]];
+        p = id[p];
+      }
+      return p;
+    };
+    for (auto const& link : links)
+      id[find(link.first)] = find(link.second);
+    for (unsigned i = 0; i < size; ++i)
+      id[i] = find(i);
+    return id;
+  }
+}  // namespace
+
+PFBlockBruteForceComparator::PFBlockBruteForceComparator(const edm::ParameterSet& iConfig)
+    : blocksToken_(consumes<reco::PFBlockCollection>(iConfig.getParameter<edm::InputTag>("blocks"))),
+      minWrapAroundLinks_(iConfig.getParameter<unsigned int>("minWrapAroundLinks")) {
+  for (auto& row : linkerSquare_)
+    row.fill(nullptr);
+  for (auto const& conf : iConfig.getParameter<std::vector<edm::ParameterSet>>("linkDefinitions")) {
+    const std::string& linkType = conf.getParameter<std::string>("linkType");
+    const size_t split = linkType.find(':');
+    if (split == std::string::npos) {
+      throw cms::Exception("MalformedLinkType") << "\"" << linkType << "\" is not a valid link type definition.";
+    }
+    const Type type1 = elementType(linkType.substr(0, split));
+    const Type type2 = elementType(linkType.substr(split + 1));
+    linkers_.emplace_back(
+        BlockElementLinkerFactory::get()->create(conf.getParameter<std::string>("linkerName"), conf));
+    linkerSquare_[type1][type2] = linkers_.back().get();
+    linkerSquare_[type2][type1] = linkers_.back().get();
+  }
+}
+
+void PFBlockBruteForceComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("blocks", edm::InputTag("particleFlowBlock"));
+  edm::ParameterSetDescription linkerDesc;
+  linkerDesc.setAllowAnything();
+  desc.addVPSet("linkDefinitions", linkerDesc, std::vector<edm::ParameterSet>())
+      ->setComment("the linkDefinitions of the block producer");
+  desc.add<unsigned int>("minWrapAroundLinks", 0)
+      ->setComment("smallest number of links across phi = +-pi of the linkers with a spatial window in the job");
+  descriptions.add("pfBlockBruteForceComparator", desc);
+}
+
+PFBlockBruteForceComparator::Type PFBlockBruteForceComparator::elementType(const std::string& name) {
+  static const std::array<std::string, reco::PFBlockElement::kNBETypes> names = {
+      {"NONE", "TRACK", "PS1", "PS2", "ECAL", "HCAL", "GSF", "BREM", "HFEM", "HFHAD", "SC", "HO", "HGCAL"}};
+  for (unsigned type = 1; type < names.size(); ++type) {
+    if (names[type] == name)
+      return static_cast<Type>(type);
+  }
+  throw cms::Exception("InvalidBlockElementType") << "\"" << name << "\" is not a valid block element type";
+}
+
+void PFBlockBruteForceComparator::analyze(const edm::Event& iEvent, const edm::EventSetup&) {
+  const auto& blocks = iEvent.get(blocksToken_);
+
+  // all the elements, with the block they were put in
+  std::vector<const reco::PFBlockElement*> elements;
+  std::vector<unsigned> blockOf;
+  for (unsigned b = 0; b < blocks.size(); ++b) {
+    for (auto const& element : blocks[b].elements()) {
+      elements.push_back(&element);
+      blockOf.push_back(b);
+    }
+  }
+
+  // every pair of elements, in both orders as in the loop of PFBlockAlgo over all the elements
+  std::vector<std::pair<unsigned, unsigned>> links;
+  auto linked = [](const BlockElementLinkerBase& linker,
+                   const reco::PFBlockElement* p1,
+                   const reco::PFBlockElement* p2) {
+    return linker.linkPrefilter(p1, p2) && linker.testLink(p1, p2) > -0.5;
+  };
+  for (unsigned i = 0; i < elements.size(); ++i) {
+    for (unsigned j = i + 1; j < elements.size(); ++j) {
+      const BlockElementLinkerBase* linker = linkerSquare_[elements[i]->type()][elements[j]->type()];
+      if (linker == nullptr ||
+          !(linked(*linker, elements[i], elements[j]) || linked(*linker, elements[j], elements[i])))
+        continue;
+      links.emplace_back(i, j);
+      double eta1, phi1, eta2, phi2;
+      if (linker->useSpatialIndex() && linker->linkPosition(elements[i], eta1, phi1) &&
+          linker->linkPosition(elements[j], eta2, phi2)) {
+        ++nSpatialLinks_;
+        if (std::abs(phi1 - phi2) > M_PI)
+          ++nWrapAroundLinks_;
+      }
+    }
+  }
+
+  // the elements of a block must be connected, and only to the elements of the same block
+  const auto component = connectedComponents(links, elements.size());
+  std::vector<int> componentOfBlock(blocks.size(), -1);
+  std::vector<int> blockOfComponent(elements.size(), -1);
+  for (unsigned i = 0; i < elements.size(); ++i) {
+    const unsigned b = blockOf[i];
+    const unsigned c = component[i];
+    if (componentOfBlock[b] < 0)
+      componentOfBlock[b] = c;
+    if (blockOfComponent[c] < 0)
+      blockOfComponent[c] = b;
+    if (componentOfBlock[b] != int(c) || blockOfComponent[c] != int(b)) {
+      throw cms::Exception("PFBlockMismatch")
+          << "element " << elements[i]->index() << " of type " << elements[i]->type() << " of the block " << b
+          << " is not linked to the same elements by testing all the pairs in event " << iEvent.id();
+    }
+  }
+  nBlocks_ += blocks.size();
+}
+
+void PFBlockBruteForceComparator::endJob() {
+  edm::LogVerbatim("PFBlockBruteForceComparator")
+      << "PFBlockBruteForceComparator: " << nBlocks_ << " blocks identical to the linking of all the pairs, "
+      << nSpatialLinks_ << " links of the linkers with a spatial window, " << nWrapAroundLinks_
+      << " of them across phi = +-pi";
+  if (nWrapAroundLinks_ < minWrapAroundLinks_) {
+    throw cms::Exception("PFBlockMismatch") << "only " << nWrapAroundLinks_ << " links across phi = +-pi, "
+                                            << minWrapAroundLinks_ << " are needed to check the spatial index";
+  }
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(PFBlockBruteForceComparator);
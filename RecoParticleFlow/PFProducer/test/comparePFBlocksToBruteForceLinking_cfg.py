@@ -0,0 +1,39 @@
+# Runs the reconstruction from the raw data, links the elements of the particleFlowBlock blocks
+# again by testing all the pairs of elements with the same linkers, and checks that this gives the
+# same blocks. The links of the linkers with a spatial window (HCAL:HO, ECAL:HCAL, ...) across
+# phi = +-pi are counted, and the job fails if the sample has none of them.
+#
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.Eras.Era_Run2_2017_cff import Run2_2017
+
+process = cms.Process("ComparePFBlocks", Run2_2017)
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.RawToDigi_Data_cff")
+process.load("Configuration.StandardSequences.Reconstruction_Data_cff")
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_data', '')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+        '/store/relval/CMSSW_10_2_0_pre4/DoubleEG/RAW-RECO/ZElectron-102X_dataRun2_PromptLike_v1_RelVal_doubEG2017B-v1/20000/2A91DAFF-9161-E811-93F5-0CC47A4D765E.root'
+    )
+)
+
+process.pfBlockBruteForceComparator = cms.EDAnalyzer("PFBlockBruteForceComparator",
+    blocks = cms.InputTag("particleFlowBlock"),
+    linkDefinitions = process.particleFlowBlock.linkDefinitions,
+    minWrapAroundLinks = cms.uint32(1)
+)
+
+process.p = cms.Path(process.RawToDigi * process.reconstruction * process.pfBlockBruteForceComparator)
@@ -452,7 +452,7 @@ namespace goodseedhelpers {
                                                            edm::FileInPath(conf.getParameter<string>("Weights9"))}};
 
       for (UInt_t j = 0; j < gbr.size(); ++j) {
-        gbr[j] = createGBRForest(weights[j]);
+        gbr[j] = createFlatGBRForest(weights[j]);
       }
     }
   }
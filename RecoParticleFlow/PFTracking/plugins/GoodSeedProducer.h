@@ -23,7 +23,7 @@
 #include "TrackingTools/PatternTools/interface/Trajectory.h"
 #include "RecoParticleFlow/PFTracking/interface/PFGeometry.h"
 
-#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
 
 #include "RecoTracker/TransientTrackingRecHit/interface/TkTransientTrackingRecHitBuilder.h"
 
@@ -56,7 +56,7 @@ namespace goodseedhelpers {
 
   public:
     HeavyObjectCache(const edm::ParameterSet& conf);
-    std::array<std::unique_ptr<const GBRForest>, kMaxWeights> gbr;
+    std::array<std::unique_ptr<const FlatGBRForest>, kMaxWeights> gbr;
 
   private:
     // for temporary variable binding while reading
@@ -61,21 +61,10 @@ public:
 
   float getOuterPhi() const { return theDoublets->phi(theDoubletId, HitDoublets::outer); }
 
-  void evolve(unsigned int me, CAStatusColl& allStatus) {
-    allStatus[me].hasSameStateNeighbors = 0;
-    auto mystate = allStatus[me].theCAState;
-
-    for (auto oc : theOuterNeighbors) {
-      if (allStatus[oc].getCAState() == mystate) {
-        allStatus[me].hasSameStateNeighbors = 1;
-
-        break;
-      }
-    }
-  }
-
-  void checkAlignmentAndAct(CAColl& allCells,
-                            CAntuple& innerCells,
+  // call act(i) for each cell i of innerCells aligned with this cell
+  template <typename Action>
+  void checkAlignmentAndAct(const CAColl& allCells,
+                            const CAntuple& innerCells,
                             const float ptmin,
                             const float region_origin_x,
                             const float region_origin_y,
@@ -83,7 +72,7 @@ public:
                             const float thetaCut,
                             const float phiCut,
                             const float hardPtCut,
-                            std::vector<CACell::CAntuplet>* foundTriplets) {
+                            Action&& act) const {
     int ncells = innerCells.size();
     int constexpr VSIZE = 16;
     int ok[VSIZE];
@@ -91,7 +80,6 @@ public:
     float z1[VSIZE];
     auto ro = getOuterR();
     auto zo = getOuterZ();
-    unsigned int cellId = this - &allCells.front();
     auto loop = [&](int i, int vs) {
       for (int j = 0; j < vs; ++j) {
         auto koc = innerCells[i + j];
@@ -107,11 +95,7 @@ public:
         auto& oc = allCells[koc];
         if (ok[j] && haveSimilarCurvature(
                          oc, ptmin, region_origin_x, region_origin_y, region_origin_radius, phiCut, hardPtCut)) {
-          if (foundTriplets)
-            foundTriplets->emplace_back(CACell::CAntuplet{koc, cellId});
-          else {
-            oc.tagAsOuterNeighbor(cellId);
-          }
+          act(koc);
         }
       }
     };
@@ -121,28 +105,8 @@ public:
     loop(lim, ncells - lim);
   }
 
-  void checkAlignmentAndTag(CAColl& allCells,
-                            CAntuple& innerCells,
-                            const float ptmin,
-                            const float region_origin_x,
-                            const float region_origin_y,
-                            const float region_origin_radius,
-                            const float thetaCut,
-                            const float phiCut,
-                            const float hardPtCut) {
-    checkAlignmentAndAct(allCells,
-                         innerCells,
-                         ptmin,
-                         region_origin_x,
-                         region_origin_y,
-                         region_origin_radius,
-                         thetaCut,
-                         phiCut,
-                         hardPtCut,
-                         nullptr);
-  }
-  void checkAlignmentAndPushTriplet(CAColl& allCells,
-                                    CAntuple& innerCells,
+  void checkAlignmentAndPushTriplet(const CAColl& allCells,
+                                    const CAntuple& innerCells,
                                     std::vector<CACell::CAntuplet>& foundTriplets,
                                     const float ptmin,
                                     const float region_origin_x,
@@ -150,7 +114,8 @@ public:
                                     const float region_origin_radius,
                                     const float thetaCut,
                                     const float phiCut,
-                                    const float hardPtCut) {
+                                    const float hardPtCut) const {
+    unsigned int cellId = this - &allCells.front();
     checkAlignmentAndAct(allCells,
                          innerCells,
                          ptmin,
@@ -160,7 +125,7 @@ public:
                          thetaCut,
                          phiCut,
                          hardPtCut,
-                         &foundTriplets);
+                         [&](unsigned int koc) { foundTriplets.emplace_back(CACell::CAntuplet{koc, cellId}); });
   }
 
   int areAlignedRZ(float r1, float z1, float ro, float zo, const float ptmin, const float thetaCut) const {
@@ -174,8 +139,6 @@ public:
     return tan_12_13_half_mul_distance_13_squared * pMin <= thetaCut * distance_13_squared * radius_diff;
   }
 
-  void tagAsOuterNeighbor(unsigned int otherCell) { theOuterNeighbors.push_back(otherCell); }
-
   bool haveSimilarCurvature(const CACell& otherCell,
                             const float ptmin,
                             const float region_origin_x,
@@ -245,33 +208,7 @@ public:
     return false;
   }
 
-  // trying to free the track building process from hardcoded layers, leaving the visit of the graph
-  // based on the neighborhood connections between cells.
-
-  void findNtuplets(CAColl& allCells,
-                    std::vector<CAntuplet>& foundNtuplets,
-                    CAntuplet& tmpNtuplet,
-                    const unsigned int minHitsPerNtuplet) const {
-    // the building process for a track ends if:
-    // it has no outer neighbor
-    // it has no compatible neighbor
-    // the ntuplets is then saved if the number of hits it contains is greater than a threshold
-
-    if (tmpNtuplet.size() == minHitsPerNtuplet - 1) {
-      foundNtuplets.push_back(tmpNtuplet);
-    } else {
-      unsigned int numberOfOuterNeighbors = theOuterNeighbors.size();
-      for (unsigned int i = 0; i < numberOfOuterNeighbors; ++i) {
-        tmpNtuplet.push_back((theOuterNeighbors[i]));
-        allCells[theOuterNeighbors[i]].findNtuplets(allCells, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
-        tmpNtuplet.pop_back();
-      }
-    }
-  }
-
 private:
-  CAntuple theOuterNeighbors;
-
   const HitDoublets* theDoublets;
   const int theDoubletId;
 
@@ -1,7 +1,19 @@
+#include <algorithm>
 #include <queue>
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
 #include "CellularAutomaton.h"
 
+namespace {
+  // cells connected or evolved per task
+  constexpr unsigned int cellsPerTask = 256;
+  // root cells followed per task
+  constexpr unsigned int rootCellsPerTask = 64;
+}  // namespace
+
 void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *> &hitDoublets,
                                               const TrackingRegion &region,
                                               const float thetaCut,
@@ -18,6 +30,9 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
   float region_origin_y = region.origin().y();
   float region_origin_radius = region.originRBound();
 
+  // a layer pair is visited once all the layer pairs ending on its inner layer have been visited,
+  // the cells are numbered in the order of the visit
+  std::vector<int> visitedLayerPairs;
   std::vector<bool> alreadyVisitedLayerPairs;
   alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
   for (auto visited : alreadyVisitedLayerPairs) {
@@ -30,8 +45,6 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
       LayerPairsToVisit.push(LayerPair);
     }
 
-    unsigned int numberOfLayerPairsToVisitAtThisDepth = LayerPairsToVisit.size();
-
     while (not LayerPairsToVisit.empty()) {
       auto currentLayerPair = LayerPairsToVisit.front();
       auto &currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
@@ -51,34 +64,101 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
         for (unsigned int i = 0; i < numberOfDoublets; ++i) {
           allCells.emplace_back(
               doubletLayerPairId, i, doubletLayerPairId->innerHitId(i), doubletLayerPairId->outerHitId(i));
-
-          currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
-
           cellId++;
-
-          auto &neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-          allCells.back().checkAlignmentAndTag(allCells,
-                                               neigCells,
-                                               ptmin,
-                                               region_origin_x,
-                                               region_origin_y,
-                                               region_origin_radius,
-                                               thetaCut,
-                                               phiCut,
-                                               hardPtCut);
         }
-        assert(cellId == currentLayerPairRef.theFoundCells[1]);
         for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs) {
           LayerPairsToVisit.push(outerLayerPair);
         }
 
+        visitedLayerPairs.push_back(currentLayerPair);
         alreadyVisitedLayerPairs[currentLayerPair] = true;
       }
       LayerPairsToVisit.pop();
-      numberOfLayerPairsToVisitAtThisDepth--;
-      if (numberOfLayerPairsToVisitAtThisDepth == 0) {
-        numberOfLayerPairsToVisitAtThisDepth = LayerPairsToVisit.size();
+    }
+  }
+
+  // the cells having their outer hit on each layer, one task per layer
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(std::size_t(0), theLayerGraph.theLayers.size(), [&](std::size_t layer) {
+      auto &isOuterHitOfCell = theLayerGraph.theLayers[layer].isOuterHitOfCell;
+      for (auto layerPair : visitedLayerPairs) {
+        auto const &layerPairRef = theLayerGraph.theLayerPairs[layerPair];
+        if (layerPairRef.theLayers[1] != int(layer))
+          continue;
+        const HitDoublets *doublets = hitDoublets[layerPair];
+        for (auto i = layerPairRef.theFoundCells[0]; i < layerPairRef.theFoundCells[1]; ++i) {
+          isOuterHitOfCell[doublets->outerHitId(i - layerPairRef.theFoundCells[0])].push_back(i);
+        }
+      }
+    });
+  });
+
+  // each task finds the inner neighbors of a block of cells of one layer pair,
+  // as (inner cell, outer cell) ordered by outer cell
+  struct CellBlock {
+    int layerPair;
+    unsigned int begin, end;
+    std::vector<std::pair<unsigned int, unsigned int>> connections;
+  };
+  std::vector<CellBlock> blocks;
+  for (auto layerPair : visitedLayerPairs) {
+    auto const &foundCells = theLayerGraph.theLayerPairs[layerPair].theFoundCells;
+    for (auto i = foundCells[0]; i < foundCells[1]; i += cellsPerTask) {
+      blocks.push_back(CellBlock{layerPair, i, std::min(i + cellsPerTask, foundCells[1]), {}});
+    }
+  }
+
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(std::size_t(0), blocks.size(), [&](std::size_t b) {
+      auto &block = blocks[b];
+      auto const &layerPairRef = theLayerGraph.theLayerPairs[block.layerPair];
+      auto const &innerLayerRef = theLayerGraph.theLayers[layerPairRef.theLayers[0]];
+      const HitDoublets *doublets = hitDoublets[block.layerPair];
+      for (auto i = block.begin; i < block.end; ++i) {
+        auto const &neigCells = innerLayerRef.isOuterHitOfCell[doublets->innerHitId(i - layerPairRef.theFoundCells[0])];
+        allCells[i].checkAlignmentAndAct(allCells,
+                                         neigCells,
+                                         ptmin,
+                                         region_origin_x,
+                                         region_origin_y,
+                                         region_origin_radius,
+                                         thetaCut,
+                                         phiCut,
+                                         hardPtCut,
+                                         [&](unsigned int koc) { block.connections.emplace_back(koc, i); });
       }
+    });
+  });
+
+  // outer neighbors of each cell, in the order of increasing cell index
+  theOuterNeighborOffsets.assign(allCells.size() + 1, 0);
+  for (auto const &block : blocks) {
+    for (auto const &connection : block.connections) {
+      ++theOuterNeighborOffsets[connection.first + 1];
+    }
+  }
+  for (unsigned int i = 0; i < allCells.size(); ++i) {
+    theOuterNeighborOffsets[i + 1] += theOuterNeighborOffsets[i];
+  }
+  theOuterNeighbors.resize(theOuterNeighborOffsets.back());
+  std::vector<unsigned int> filled(theOuterNeighborOffsets.begin(), theOuterNeighborOffsets.end() - 1);
+  for (auto const &block : blocks) {
+    for (auto const &connection : block.connections) {
+      theOuterNeighbors[filled[connection.first]++] = connection.second;
+    }
+  }
+}
+
+void CellularAutomaton::evolveCell(unsigned int cellId) {
+  auto &status = allStatus[cellId];
+  status.hasSameStateNeighbors = 0;
+  auto mystate = status.theCAState;
+
+  for (auto i = theOuterNeighborOffsets[cellId]; i < theOuterNeighborOffsets[cellId + 1]; ++i) {
+    if (allStatus[theOuterNeighbors[i]].getCAState() == mystate) {
+      status.hasSameStateNeighbors = 1;
+
+      break;
     }
   }
 }
@@ -88,30 +168,42 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet) {
 
   unsigned int numberOfIterations = minHitsPerNtuplet - 2;
   // keeping the last iteration for later
-  for (unsigned int iteration = 0; iteration < numberOfIterations - 1; ++iteration) {
-    for (auto &layerPair : theLayerGraph.theLayerPairs) {
-      for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
-        allCells[i].evolve(i, allStatus);
-      }
-    }
+  // the new states only depend on the states of the previous iteration, so the cells are independent
+  tbb::this_task_arena::isolate([&] {
+    for (unsigned int iteration = 0; iteration < numberOfIterations - 1; ++iteration) {
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, allCells.size(), cellsPerTask),
+                        [&](const tbb::blocked_range<unsigned int> &range) {
+                          for (auto i = range.begin(); i < range.end(); ++i) {
+                            evolveCell(i);
+                          }
+                        });
 
-    for (auto &layerPair : theLayerGraph.theLayerPairs) {
-      for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
-        allStatus[i].updateState();
-      }
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, allCells.size(), cellsPerTask),
+                        [&](const tbb::blocked_range<unsigned int> &range) {
+                          for (auto i = range.begin(); i < range.end(); ++i) {
+                            allStatus[i].updateState();
+                          }
+                        });
     }
-  }
+  });
 
   // last iteration
-
+  // the cells starting on one root layer are never neighbors of each other, but they may be
+  // outer neighbors of the cells starting on another root layer, which are evolved later
   for (int rootLayerId : theLayerGraph.theRootLayers) {
     for (int rootLayerPair : theLayerGraph.theLayers[rootLayerId].theOuterLayerPairs) {
       auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
+      tbb::this_task_arena::isolate([&] {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(foundCells[0], foundCells[1], cellsPerTask),
+                          [&](const tbb::blocked_range<unsigned int> &range) {
+                            for (auto i = range.begin(); i < range.end(); ++i) {
+                              evolveCell(i);
+                              allStatus[i].updateState();
+                            }
+                          });
+      });
       for (auto i = foundCells[0]; i < foundCells[1]; ++i) {
-        auto &cell = allStatus[i];
-        allCells[i].evolve(i, allStatus);
-        cell.updateState();
-        if (cell.isRootCell(minHitsPerNtuplet - 2)) {
+        if (allStatus[i].isRootCell(minHitsPerNtuplet - 2)) {
           theRootCells.push_back(i);
         }
       }
@@ -119,15 +211,48 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet) {
   }
 }
 
+void CellularAutomaton::findNtuplets(unsigned int cellId,
+                                     std::vector<CACell::CAntuplet> &foundNtuplets,
+                                     CACell::CAntuplet &tmpNtuplet,
+                                     const unsigned int minHitsPerNtuplet) const {
+  // the building process for a track ends if:
+  // it has no outer neighbor
+  // it has no compatible neighbor
+  // the ntuplets is then saved if the number of hits it contains is greater than a threshold
+
+  if (tmpNtuplet.size() == minHitsPerNtuplet - 1) {
+    foundNtuplets.push_back(tmpNtuplet);
+  } else {
+    for (auto i = theOuterNeighborOffsets[cellId]; i < theOuterNeighborOffsets[cellId + 1]; ++i) {
+      tmpNtuplet.push_back(theOuterNeighbors[i]);
+      findNtuplets(theOuterNeighbors[i], foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+      tmpNtuplet.pop_back();
+    }
+  }
+}
+
 void CellularAutomaton::findNtuplets(std::vector<CACell::CAntuplet> &foundNtuplets,
                                      const unsigned int minHitsPerNtuplet) {
-  CACell::CAntuple tmpNtuplet;
-  tmpNtuplet.reserve(minHitsPerNtuplet);
+  // each task follows a block of root cells, the ntuplets of the blocks are then appended in order
+  std::vector<std::vector<CACell::CAntuplet>> blockNtuplets((theRootCells.size() + rootCellsPerTask - 1) /
+                                                            rootCellsPerTask);
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(std::size_t(0), blockNtuplets.size(), [&](std::size_t b) {
+      CACell::CAntuple tmpNtuplet;
+      tmpNtuplet.reserve(minHitsPerNtuplet);
+
+      auto end = std::min<std::size_t>((b + 1) * rootCellsPerTask, theRootCells.size());
+      for (auto r = b * rootCellsPerTask; r < end; ++r) {
+        auto root_cell = theRootCells[r];
+        tmpNtuplet.clear();
+        tmpNtuplet.push_back(root_cell);
+        findNtuplets(root_cell, blockNtuplets[b], tmpNtuplet, minHitsPerNtuplet);
+      }
+    });
+  });
 
-  for (auto root_cell : theRootCells) {
-    tmpNtuplet.clear();
-    tmpNtuplet.push_back(root_cell);
-    allCells[root_cell].findNtuplets(allCells, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+  for (auto &ntuplets : blockNtuplets) {
+    foundNtuplets.insert(foundNtuplets.end(), ntuplets.begin(), ntuplets.end());
   }
 }
 
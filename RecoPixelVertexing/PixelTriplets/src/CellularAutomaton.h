@@ -9,6 +9,12 @@
 #include "CACell.h"
 #include "CAGraph.h"
 
+/* The cells are created serially, in the order in which the layer pairs are visited starting
+ * from the root layers, then connected, evolved and followed in parallel TBB tasks.
+ * The outer neighbors of all the cells are kept in one flat array, the neighbors of cell i
+ * being theOuterNeighbors[theOuterNeighborOffsets[i]] ... theOuterNeighbors[theOuterNeighborOffsets[i+1]-1],
+ * in the order of increasing cell index. The ntuplets found do not depend on the number of threads.
+ */
 class CellularAutomaton {
 public:
   CellularAutomaton(CAGraph& graph) : theLayerGraph(graph) {}
@@ -28,13 +34,21 @@ public:
                     const float hardPtCut);
 
 private:
+  void evolveCell(unsigned int cellId);
+  void findNtuplets(unsigned int cellId,
+                    std::vector<CACell::CAntuplet>& foundNtuplets,
+                    CACell::CAntuplet& tmpNtuplet,
+                    const unsigned int minHitsPerNtuplet) const;
+
   CAGraph& theLayerGraph;
 
   std::vector<CACell> allCells;
   std::vector<CACellStatus> allStatus;
 
+  std::vector<unsigned int> theOuterNeighborOffsets;
+  std::vector<unsigned int> theOuterNeighbors;
+
   std::vector<unsigned int> theRootCells;
-  std::vector<std::vector<CACell*> > theNtuplets;
 };
 
 #endif  // RecoPixelVertexing_PixelTriplets_src_CellularAutomaton_h
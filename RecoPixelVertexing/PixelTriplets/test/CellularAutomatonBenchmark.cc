@@ -0,0 +1,203 @@
+/*
+ * Runs the cellular automaton on the hit doublets of the events, with the serial implementation
+ * that CellularAutomaton replaced (CellularAutomatonSerial.h), with CellularAutomaton in a single
+ * thread arena and with CellularAutomaton in the framework arena. Throws if the quadruplets found
+ * differ, and prints the time taken by each at the end of the job.
+ */
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "RecoPixelVertexing/PixelTriplets/src/CellularAutomaton.h"
+#include "RecoTracker/TkHitPairs/interface/IntermediateHitDoublets.h"
+
+#include "CellularAutomatonSerial.h"
+
+#include "tbb/task_arena.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <vector>
+
+class CellularAutomatonBenchmark : public edm::one::EDAnalyzer<> {
+public:
+  explicit CellularAutomatonBenchmark(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions&);
+
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob() override;
+
+private:
+  enum { serial, singleThread, frameworkArena, nRuns };
+  // the quadruplets as the sequences of their hits
+  typedef std::vector<std::array<RecHitsSortedInPhi::Hit, 4>> Quadruplets;
+
+  template <typename CA>
+  Quadruplets findQuadruplets(const SeedingLayerSetsHits& layers,
+                              const IntermediateHitDoublets::RegionLayerSets& regionLayerPairs,
+                              double& ms,
+                              unsigned long& nCells) const;
+
+  const edm::EDGetTokenT<IntermediateHitDoublets> doubletToken_;
+  const float caThetaCut_;
+  const float caPhiCut_;
+  const float caHardPtCut_;
+
+  unsigned long nRegions_ = 0;
+  unsigned long nCells_ = 0;
+  unsigned long nQuadruplets_ = 0;
+  std::array<double, nRuns> ms_ = {{0, 0, 0}};
+};
+
+namespace {
+  constexpr unsigned int numberOfHitsInNtuplet = 4;
+
+  // the graph of the layers and layer pairs of a region, as built by CAHitQuadrupletGenerator
+  void fillGraph(const SeedingLayerSetsHits& layers,
+                 const IntermediateHitDoublets::RegionLayerSets& regionLayerPairs,
+                 CAGraph& g,
+                 std::vector<const HitDoublets*>& hitDoublets) {
+    for (unsigned int i = 0; i < layers.size(); i++) {
+      for (unsigned int j = 0; j < numberOfHitsInNtuplet; ++j) {
+        auto foundVertex = std::find(g.theLayers.begin(), g.theLayers.end(), layers[i][j].name());
+        if (foundVertex == g.theLayers.end()) {
+          g.theLayers.emplace_back(layers[i][j].name(), layers[i][j].hits().size());
+          foundVertex = g.theLayers.end() - 1;
+        }
+        int vertexIndex = foundVertex - g.theLayers.begin();
+        if (j == 0) {
+          if (std::find(g.theRootLayers.begin(), g.theRootLayers.end(), vertexIndex) == g.theRootLayers.end()) {
+            g.theRootLayers.emplace_back(vertexIndex);
+          }
+        }
+      }
+    }
+    for (unsigned int i = 0; i < layers.size(); i++) {
+      for (unsigned int j = 1; j < numberOfHitsInNtuplet; ++j) {
+        int vertexIndex = std::find(g.theLayers.begin(), g.theLayers.end(), layers[i][j].name()) - g.theLayers.begin();
+        auto innerVertex = std::find(g.theLayers.begin(), g.theLayers.end(), layers[i][j - 1].name());
+        CALayerPair tmpInnerLayerPair(innerVertex - g.theLayers.begin(), vertexIndex);
+        if (std::find(g.theLayerPairs.begin(), g.theLayerPairs.end(), tmpInnerLayerPair) != g.theLayerPairs.end())
+          continue;
+        auto found = std::find_if(regionLayerPairs.begin(),
+                                  regionLayerPairs.end(),
+                                  [&](const IntermediateHitDoublets::LayerPairHitDoublets& pair) {
+                                    return pair.innerLayerIndex() == layers[i][j - 1].index() &&
+                                           pair.outerLayerIndex() == layers[i][j].index();
+                                  });
+        if (found != regionLayerPairs.end()) {
+          hitDoublets.emplace_back(&(found->doublets()));
+          g.theLayerPairs.push_back(tmpInnerLayerPair);
+          g.theLayers[vertexIndex].theInnerLayers.push_back(innerVertex - g.theLayers.begin());
+          innerVertex->theOuterLayers.push_back(vertexIndex);
+          g.theLayers[vertexIndex].theInnerLayerPairs.push_back(g.theLayerPairs.size() - 1);
+          innerVertex->theOuterLayerPairs.push_back(g.theLayerPairs.size() - 1);
+        }
+      }
+    }
+  }
+}  // namespace
+
+CellularAutomatonBenchmark::CellularAutomatonBenchmark(const edm::ParameterSet& iConfig)
+    : doubletToken_(consumes<IntermediateHitDoublets>(iConfig.getParameter<edm::InputTag>("doublets"))),
+      caThetaCut_(iConfig.getParameter<double>("CAThetaCut")),
+      caPhiCut_(iConfig.getParameter<double>("CAPhiCut")),
+      caHardPtCut_(iConfig.getParameter<double>("CAHardPtCut")) {}
+
+void CellularAutomatonBenchmark::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("doublets", edm::InputTag("initialStepHitDoubletsPreSplitting"));
+  desc.add<double>("CAThetaCut", 0.0012);
+  desc.add<double>("CAPhiCut", 0.2);
+  desc.add<double>("CAHardPtCut", 0);
+  descriptions.add("cellularAutomatonBenchmark", desc);
+}
+
+template <typename CA>
+CellularAutomatonBenchmark::Quadruplets CellularAutomatonBenchmark::findQuadruplets(
+    const SeedingLayerSetsHits& layers,
+    const IntermediateHitDoublets::RegionLayerSets& regionLayerPairs,
+    double& ms,
+    unsigned long& nCells) const {
+  CAGraph g;
+  std::vector<const HitDoublets*> hitDoublets;
+  fillGraph(layers, regionLayerPairs, g, hitDoublets);
+
+  std::vector<CACell::CAntuplet> foundQuadruplets;
+  auto start = std::chrono::steady_clock::now();
+  CA ca(g);
+  ca.createAndConnectCells(hitDoublets, regionLayerPairs.region(), caThetaCut_, caPhiCut_, caHardPtCut_);
+  ca.evolve(numberOfHitsInNtuplet);
+  ca.findNtuplets(foundQuadruplets, numberOfHitsInNtuplet);
+  ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  auto const& allCells = ca.getAllCells();
+  nCells = allCells.size();
+  Quadruplets quadruplets;
+  for (auto const& quadruplet : foundQuadruplets) {
+    quadruplets.push_back({{allCells[quadruplet[0]].getInnerHit(),
+                            allCells[quadruplet[1]].getInnerHit(),
+                            allCells[quadruplet[2]].getInnerHit(),
+                            allCells[quadruplet[2]].getOuterHit()}});
+  }
+  return quadruplets;
+}
+
+void CellularAutomatonBenchmark::analyze(const edm::Event& iEvent, const edm::EventSetup&) {
+  edm::Handle<IntermediateHitDoublets> hdoublets;
+  iEvent.getByToken(doubletToken_, hdoublets);
+  const auto& regionDoublets = *hdoublets;
+
+  const SeedingLayerSetsHits& layers = regionDoublets.seedingLayerHits();
+  if (layers.numberOfLayersInSet() < numberOfHitsInNtuplet) {
+    throw cms::Exception("Configuration") << "CellularAutomatonBenchmark expects quadruplet layer sets, got "
+                                          << layers.numberOfLayersInSet() << " layers per set";
+  }
+
+  tbb::task_arena singleThreadArena(1);
+  for (const auto& regionLayerPairs : regionDoublets) {
+    std::array<unsigned long, nRuns> nCells;
+    std::array<Quadruplets, nRuns> quadruplets;
+    quadruplets[serial] =
+        findQuadruplets<CellularAutomatonSerial>(layers, regionLayerPairs, ms_[serial], nCells[serial]);
+    singleThreadArena.execute([&] {
+      quadruplets[singleThread] = findQuadruplets<CellularAutomaton>(
+          layers, regionLayerPairs, ms_[singleThread], nCells[singleThread]);
+    });
+    quadruplets[frameworkArena] =
+        findQuadruplets<CellularAutomaton>(layers, regionLayerPairs, ms_[frameworkArena], nCells[frameworkArena]);
+
+    for (auto run : {singleThread, frameworkArena}) {
+      if (nCells[run] != nCells[serial] || quadruplets[run] != quadruplets[serial]) {
+        throw cms::Exception("CellularAutomatonMismatch")
+            << "CellularAutomaton " << (run == singleThread ? "in a single thread" : "in the framework arena")
+            << " found " << quadruplets[run].size() << " quadruplets from " << nCells[run]
+            << " cells, the serial implementation " << quadruplets[serial].size() << " from " << nCells[serial]
+            << " in event " << iEvent.id();
+      }
+    }
+    ++nRegions_;
+    nCells_ += nCells[serial];
+    nQuadruplets_ += quadruplets[serial].size();
+  }
+}
+
+void CellularAutomatonBenchmark::endJob() {
+  edm::LogVerbatim("CellularAutomatonBenchmark")
+      << "CellularAutomatonBenchmark: " << nRegions_ << " regions, " << nCells_ << " cells, " << nQuadruplets_
+      << " quadruplets, identical in the three runs\n"
+      << "  serial implementation           " << ms_[serial] << " ms\n"
+      << "  CellularAutomaton, one thread   " << ms_[singleThread] << " ms\n"
+      << "  CellularAutomaton, framework    " << ms_[frameworkArena] << " ms";
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(CellularAutomatonBenchmark);
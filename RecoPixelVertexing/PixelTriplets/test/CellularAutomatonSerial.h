@@ -0,0 +1,176 @@
+#ifndef RecoPixelVertexing_PixelTriplets_test_CellularAutomatonSerial_h
+#define RecoPixelVertexing_PixelTriplets_test_CellularAutomatonSerial_h
+
+#include <cassert>
+#include <queue>
+#include <vector>
+
+#include "RecoPixelVertexing/PixelTriplets/src/CACell.h"
+#include "RecoPixelVertexing/PixelTriplets/src/CAGraph.h"
+
+/* The serial cellular automaton that CellularAutomaton replaced, kept as the reference of
+ * CellularAutomatonBenchmark: the cells are connected while they are created, each cell keeps
+ * its own vector of outer neighbors, and the cells are evolved and followed one after the other.
+ * The alignment and curvature cuts are those of CACell.
+ */
+class CellularAutomatonSerial {
+public:
+  CellularAutomatonSerial(CAGraph& graph) : theLayerGraph(graph) {}
+
+  std::vector<CACell>& getAllCells() { return allCells; }
+
+  void createAndConnectCells(const std::vector<const HitDoublets*>& hitDoublets,
+                             const TrackingRegion& region,
+                             const float thetaCut,
+                             const float phiCut,
+                             const float hardPtCut) {
+    int tsize = 0;
+    for (auto hd : hitDoublets) {
+      tsize += hd->size();
+    }
+    allCells.reserve(tsize);
+    theOuterNeighbors.reserve(tsize);
+    unsigned int cellId = 0;
+    float ptmin = region.ptMin();
+    float region_origin_x = region.origin().x();
+    float region_origin_y = region.origin().y();
+    float region_origin_radius = region.originRBound();
+
+    std::vector<bool> alreadyVisitedLayerPairs(theLayerGraph.theLayerPairs.size(), false);
+    for (int rootVertex : theLayerGraph.theRootLayers) {
+      std::queue<int> LayerPairsToVisit;
+
+      for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs) {
+        LayerPairsToVisit.push(LayerPair);
+      }
+
+      while (not LayerPairsToVisit.empty()) {
+        auto currentLayerPair = LayerPairsToVisit.front();
+        auto& currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
+        auto& currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
+        auto& currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
+        bool allInnerLayerPairsAlreadyVisited{true};
+
+        for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs) {
+          allInnerLayerPairsAlreadyVisited &= alreadyVisitedLayerPairs[innerLayerPair];
+        }
+
+        if (alreadyVisitedLayerPairs[currentLayerPair] == false and allInnerLayerPairsAlreadyVisited) {
+          const HitDoublets* doubletLayerPairId = hitDoublets[currentLayerPair];
+          auto numberOfDoublets = doubletLayerPairId->size();
+          currentLayerPairRef.theFoundCells[0] = cellId;
+          currentLayerPairRef.theFoundCells[1] = cellId + numberOfDoublets;
+          for (unsigned int i = 0; i < numberOfDoublets; ++i) {
+            allCells.emplace_back(
+                doubletLayerPairId, i, doubletLayerPairId->innerHitId(i), doubletLayerPairId->outerHitId(i));
+            theOuterNeighbors.emplace_back();
+
+            currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
+
+            auto& neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
+            allCells.back().checkAlignmentAndAct(allCells,
+                                                 neigCells,
+                                                 ptmin,
+                                                 region_origin_x,
+                                                 region_origin_y,
+                                                 region_origin_radius,
+                                                 thetaCut,
+                                                 phiCut,
+                                                 hardPtCut,
+                                                 [&](unsigned int koc) { theOuterNeighbors[koc].push_back(cellId); });
+            cellId++;
+          }
+          assert(cellId == currentLayerPairRef.theFoundCells[1]);
+          for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs) {
+            LayerPairsToVisit.push(outerLayerPair);
+          }
+
+          alreadyVisitedLayerPairs[currentLayerPair] = true;
+        }
+        LayerPairsToVisit.pop();
+      }
+    }
+  }
+
+  void evolve(const unsigned int minHitsPerNtuplet) {
+    allStatus.resize(allCells.size());
+
+    unsigned int numberOfIterations = minHitsPerNtuplet - 2;
+    // keeping the last iteration for later
+    for (unsigned int iteration = 0; iteration < numberOfIterations - 1; ++iteration) {
+      for (auto& layerPair : theLayerGraph.theLayerPairs) {
+        for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
+          evolveCell(i);
+        }
+      }
+
+      for (auto& layerPair : theLayerGraph.theLayerPairs) {
+        for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
+          allStatus[i].updateState();
+        }
+      }
+    }
+
+    // last iteration
+    for (int rootLayerId : theLayerGraph.theRootLayers) {
+      for (int rootLayerPair : theLayerGraph.theLayers[rootLayerId].theOuterLayerPairs) {
+        auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
+        for (auto i = foundCells[0]; i < foundCells[1]; ++i) {
+          evolveCell(i);
+          allStatus[i].updateState();
+          if (allStatus[i].isRootCell(minHitsPerNtuplet - 2)) {
+            theRootCells.push_back(i);
+          }
+        }
+      }
+    }
+  }
+
+  void findNtuplets(std::vector<CACell::CAntuplet>& foundNtuplets, const unsigned int minHitsPerNtuplet) const {
+    CACell::CAntuple tmpNtuplet;
+    tmpNtuplet.reserve(minHitsPerNtuplet);
+
+    for (auto root_cell : theRootCells) {
+      tmpNtuplet.clear();
+      tmpNtuplet.push_back(root_cell);
+      findNtuplets(root_cell, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+    }
+  }
+
+private:
+  void evolveCell(unsigned int cellId) {
+    auto& status = allStatus[cellId];
+    status.hasSameStateNeighbors = 0;
+    for (auto oc : theOuterNeighbors[cellId]) {
+      if (allStatus[oc].getCAState() == status.theCAState) {
+        status.hasSameStateNeighbors = 1;
+        break;
+      }
+    }
+  }
+
+  void findNtuplets(unsigned int cellId,
+                    std::vector<CACell::CAntuplet>& foundNtuplets,
+                    CACell::CAntuplet& tmpNtuplet,
+                    const unsigned int minHitsPerNtuplet) const {
+    if (tmpNtuplet.size() == minHitsPerNtuplet - 1) {
+      foundNtuplets.push_back(tmpNtuplet);
+    } else {
+      for (auto oc : theOuterNeighbors[cellId]) {
+        tmpNtuplet.push_back(oc);
+        findNtuplets(oc, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+        tmpNtuplet.pop_back();
+      }
+    }
+  }
+
+  CAGraph& theLayerGraph;
+
+  std::vector<CACell> allCells;
+  std::vector<CACellStatus> allStatus;
+  std::vector<CACell::CAntuple> theOuterNeighbors;
+
+  std::vector<unsigned int> theRootCells;
+};
+
+#endif  // RecoPixelVertexing_PixelTriplets_test_CellularAutomatonSerial_h
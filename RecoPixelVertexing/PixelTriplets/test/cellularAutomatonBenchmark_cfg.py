@@ -0,0 +1,45 @@
+# Runs the tracking up to the initial step hit doublets from the raw data, and runs the cellular
+# automaton of initialStepHitQuadrupletsPreSplitting on them with the serial implementation that
+# CellularAutomaton replaced, with CellularAutomaton in a single thread and with CellularAutomaton
+# in the framework arena. Throws if the quadruplets differ, and prints the timings at the end.
+#
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.Eras.Era_Run2_2017_cff import Run2_2017
+
+process = cms.Process("CellularAutomatonBenchmark", Run2_2017)
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.RawToDigi_Data_cff")
+process.load("Configuration.StandardSequences.Reconstruction_Data_cff")
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_data', '')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+        '/store/relval/CMSSW_10_2_0_pre4/DoubleEG/RAW-RECO/ZElectron-102X_dataRun2_PromptLike_v1_RelVal_doubEG2017B-v1/20000/2A91DAFF-9161-E811-93F5-0CC47A4D765E.root'
+    )
+)
+
+process.cellularAutomatonBenchmark = cms.EDAnalyzer("CellularAutomatonBenchmark",
+    doublets = cms.InputTag("initialStepHitDoubletsPreSplitting"),
+    CAThetaCut = cms.double(0.0012),
+    CAPhiCut = cms.double(0.2),
+    CAHardPtCut = cms.double(0)
+)
+
+process.p = cms.Path(process.RawToDigi * process.reconstruction_trackingOnly * process.cellularAutomatonBenchmark)
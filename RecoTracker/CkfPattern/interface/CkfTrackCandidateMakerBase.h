@@ -54,6 +54,14 @@ namespace cms {
 
     std::unique_ptr<BaseCkfTrajectoryBuilder> theTrajectoryBuilder;
 
+    // The seeds can be split in batches of theSeedsPerBatch seeds, up to theMaxConcurrentSeedBatches
+    // of which are built concurrently, each with its own trajectory builder: theTrajectoryBuilder,
+    // then theConcurrentTrajectoryBuilders. The trajectories are stored and the seeds cleaned in seed
+    // order, so the result is the one of the serial loop.
+    unsigned int theMaxConcurrentSeedBatches;
+    unsigned int theSeedsPerBatch;
+    std::vector<std::unique_ptr<BaseCkfTrajectoryBuilder> > theConcurrentTrajectoryBuilders;
+
     std::string theTrajectoryCleanerName;
     const TrajectoryCleaner* theTrajectoryCleaner;
 
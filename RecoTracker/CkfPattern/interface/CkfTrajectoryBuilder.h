@@ -66,6 +66,8 @@ protected:
   bool theIntermediateCleaning; /**< Tells whether an intermediary cleaning stage 
                                      should take place during TB. */
   bool theAlwaysUseInvalidHits;
+  bool theBatchedUpdate; /**< Update the states of all the candidates
+                              of an iteration in a single call to the updator. */
 
 protected:
   void setEvent_(const edm::Event& iEvent, const edm::EventSetup& iSetup) override;
@@ -82,6 +84,7 @@ protected:
                                  TrajectoryContainer& result) const;
 
   void updateTrajectory(TempTrajectory& traj, TM&& tm) const;
+  void updateTrajectory(TempTrajectory& traj, TM&& tm, TSOS&& upState) const;
 
   /*  
       //not mature for integration.  
@@ -17,6 +17,10 @@ ckfTrackCandidates = cms.EDProducer("CkfTrackCandidateMaker",
 #    SeedLabel = cms.string(''),
     maxNSeeds = cms.uint32(500000),
     maxSeedsBeforeCleaning = cms.uint32(5000),
+# Build the seeds in batches of seedsPerBatch seeds, up to maxConcurrentSeedBatches at a time
+# (1 builds all the seeds serially). The track candidates do not depend on these parameters.
+    maxConcurrentSeedBatches = cms.uint32(1),
+    seedsPerBatch = cms.uint32(100),
 # SeedProducer:SeedLabel descoped to src
     src = cms.InputTag('globalMixedSeeds'),                                  
     SimpleMagneticField = cms.string(''),                                    
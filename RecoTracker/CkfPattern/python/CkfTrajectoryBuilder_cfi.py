@@ -15,6 +15,7 @@ CkfTrajectoryBuilder = cms.PSet(
     TTRHBuilder = cms.string('WithTrackAngle'),
     updator = cms.string('KFUpdator'),
     alwaysUseInvalidHits = cms.bool(True),
+    batchedUpdate = cms.bool(False),
     propagatorOpposite = cms.string('PropagatorWithMaterialOpposite'),
 #    propagatorOpposite = cms.string('PropagatorWithMaterialParabolicMfOpposite'),
     lostHitPenalty = cms.double(30.0),
@@ -40,9 +40,7 @@
 // #define VI_TBB
 
 #include <thread>
-#ifdef VI_TBB
 #include "tbb/parallel_for.h"
-#endif
 
 #include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
 
@@ -68,6 +66,11 @@ namespace cms {
         theMaxNSeeds(conf.getParameter<unsigned int>("maxNSeeds")),
         theTrajectoryBuilder(
             createBaseCkfTrajectoryBuilder(conf.getParameter<edm::ParameterSet>("TrajectoryBuilderPSet"), iC)),
+        theMaxConcurrentSeedBatches(conf.existsAs<unsigned int>("maxConcurrentSeedBatches")
+                                        ? conf.getParameter<unsigned int>("maxConcurrentSeedBatches")
+                                        : 1),
+        theSeedsPerBatch(conf.existsAs<unsigned int>("seedsPerBatch") ? conf.getParameter<unsigned int>("seedsPerBatch")
+                                                                      : 100),
         theTrajectoryCleanerName(conf.getParameter<std::string>("TrajectoryCleaner")),
         theTrajectoryCleaner(nullptr),
         theInitialState(std::make_unique<TransientInitialStateEstimator>(
@@ -111,6 +114,17 @@ namespace cms {
     }
 #endif
 
+    if (theMaxConcurrentSeedBatches == 0 || theSeedsPerBatch == 0) {
+      throw cms::Exception("Configuration") << "CkfTrackCandidateMakerBase: maxConcurrentSeedBatches ("
+                                            << theMaxConcurrentSeedBatches << ") and seedsPerBatch ("
+                                            << theSeedsPerBatch << ") must be positive";
+    }
+    // the trajectory builders keep per-seed state, so each of the concurrent batches needs its own
+    for (unsigned int i = 1; i < theMaxConcurrentSeedBatches; ++i) {
+      theConcurrentTrajectoryBuilders.push_back(
+          createBaseCkfTrajectoryBuilder(conf.getParameter<edm::ParameterSet>("TrajectoryBuilderPSet"), iC));
+    }
+
 #ifdef VI_REPRODUCIBLE
     std::cout << "CkfTrackCandidateMaker in reproducible setting" << std::endl;
     assert(nullptr == theSeedCleaner);
@@ -139,6 +153,8 @@ namespace cms {
     es.get<NavigationSchoolRecord>().get(theNavigationSchoolName, navigationSchoolH);
     theNavigationSchool = navigationSchoolH.product();
     theTrajectoryBuilder->setNavigationSchool(theNavigationSchool);
+    for (auto& builder : theConcurrentTrajectoryBuilders)
+      builder->setNavigationSchool(theNavigationSchool);
   }
 
   // Functions that gets called by framework every event
@@ -160,6 +176,7 @@ namespace cms {
     edm::Handle<MeasurementTrackerEvent> data;
     e.getByToken(theMTELabel, data);
 
+    const MeasurementTrackerEvent* measurementTrackerEvent = &*data;
     std::unique_ptr<MeasurementTrackerEvent> dataWithMasks;
     if (skipClusters_) {
       edm::Handle<PixelClusterMask> pixelMask;
@@ -168,7 +185,7 @@ namespace cms {
       e.getByToken(maskStrips_, stripMask);
       dataWithMasks = std::make_unique<MeasurementTrackerEvent>(*data, *stripMask, *pixelMask);
       //std::cout << "Trajectory builder " << conf_.getParameter<std::string>("@module_label") << " created with masks " << std::endl;
-      theTrajectoryBuilder->setEvent(e, es, &*dataWithMasks);
+      measurementTrackerEvent = &*dataWithMasks;
     } else if (phase2skipClusters_) {
       //FIXME:just temporary solution for phase2!
       edm::Handle<PixelClusterMask> pixelMask;
@@ -177,11 +194,11 @@ namespace cms {
       e.getByToken(maskPhase2OTs_, phase2OTMask);
       dataWithMasks = std::make_unique<MeasurementTrackerEvent>(*data, *pixelMask, *phase2OTMask);
       //std::cout << "Trajectory builder " << conf_.getParameter<std::string>("@module_label") << " created with phase2 masks " << std::endl;
-      theTrajectoryBuilder->setEvent(e, es, &*dataWithMasks);
-    } else {
-      //std::cout << "Trajectory builder " << conf_.getParameter<std::string>("@module_label") << " created without masks " << std::endl;
-      theTrajectoryBuilder->setEvent(e, es, &*data);
+      measurementTrackerEvent = &*dataWithMasks;
     }
+    theTrajectoryBuilder->setEvent(e, es, measurementTrackerEvent);
+    for (auto& builder : theConcurrentTrajectoryBuilders)
+      builder->setEvent(e, es, measurementTrackerEvent);
     // TISE ES must be set here due to dependence on theTrajectoryBuilder
     theInitialState->setEventSetup(
         es, static_cast<TkTransientTrackingRecHitBuilder const*>(theTrajectoryBuilder->hitBuilder())->cloner());
@@ -264,38 +281,20 @@ namespace cms {
 #endif
 
       std::atomic<unsigned int> ntseed(0);
-      auto theLoop = [&](size_t ii) {
-        auto j = indeces[ii];
-
-        ntseed++;
-
-        // to be moved inside a par section (how with tbb??)
-        std::vector<Trajectory> theTmpTrajectories;
-
-        LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
-
-        {
-          Lock lock(theMutex);
-          // Check if seed hits already used by another track
-          if (theSeedCleaner && !theSeedCleaner->good(&((*collseed)[j]))) {
-            LogDebug("CkfTrackCandidateMakerBase") << " Seed cleaning kills seed " << j;
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
-            return;  // from the lambda!
-          }
-        }
-
+      // builds the trajectories of the seed j with the given builder, fills the number of candidates and the stop
+      // reason of seedStopInfo, returns false if no trajectory is left
+      auto buildSeed = [&](unsigned int j,
+                           BaseCkfTrajectoryBuilder const& builder,
+                           std::vector<Trajectory>& theTmpTrajectories,
+                           SeedStopInfo& seedStopInfo) {
         // Build trajectory from seed outwards
         theTmpTrajectories.clear();
         unsigned int nCandPerSeed = 0;
-        auto const& startTraj =
-            theTrajectoryBuilder->buildTrajectories((*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr);
-        {
-          Lock lock(theMutex);
-          (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
-          if (theTmpTrajectories.empty()) {
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NO_TRAJECTORY);
-            return;  // from the lambda!
-          }
+        auto const& startTraj = builder.buildTrajectories((*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr);
+        seedStopInfo.setCandidatesPerSeed(nCandPerSeed);
+        if (theTmpTrajectories.empty()) {
+          seedStopInfo.setStopReason(SeedStopReason::NO_TRAJECTORY);
+          return false;
         }
 
         LogDebug("CkfPattern") << "======== In-out trajectory building found " << theTmpTrajectories.size()
@@ -315,15 +314,14 @@ namespace cms {
         // seed and if possible further inwards.
 
         if (doSeedingRegionRebuilding) {
-          theTrajectoryBuilder->rebuildTrajectories(startTraj, (*collseed)[j], theTmpTrajectories);
+          builder.rebuildTrajectories(startTraj, (*collseed)[j], theTmpTrajectories);
 
           LogDebug("CkfPattern") << "======== Out-in trajectory building found " << theTmpTrajectories.size()
                                  << " valid/invalid trajectories from seed " << j << " ========\n"
                                  << PrintoutHelper::dumpCandidates(theTmpTrajectories);
           if (theTmpTrajectories.empty()) {
-            Lock lock(theMutex);
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_REGION_REBUILD);
-            return;
+            seedStopInfo.setStopReason(SeedStopReason::SEED_REGION_REBUILD);
+            return false;
           }
         }
 
@@ -333,21 +331,22 @@ namespace cms {
         LogDebug("CkfPattern") << "======== Trajectory cleaning gave the following " << theTmpTrajectories.size()
                                << " valid trajectories from seed " << j << " ========\n"
                                << PrintoutHelper::dumpCandidates(theTmpTrajectories);
+        return true;
+      };
 
-        {
-          Lock lock(theMutex);
-          for (vector<Trajectory>::iterator it = theTmpTrajectories.begin(); it != theTmpTrajectories.end(); it++) {
-            if (it->isValid()) {
-              it->setSeedRef(collseed->refAt(j));
-              (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NOT_STOPPED);
-              // Store trajectory
-              rawResult.push_back(std::move(*it));
-              // Tell seed cleaner which hits this trajectory used.
-              //TO BE FIXED: this cut should be configurable via cfi file
-              if (theSeedCleaner && rawResult.back().foundHits() > 3)
-                theSeedCleaner->add(&rawResult.back());
-              //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
-            }
+      // stores the valid trajectories of the seed j in rawResult and tells the seed cleaner which hits they used
+      auto storeSeed = [&](unsigned int j, std::vector<Trajectory>& theTmpTrajectories) {
+        for (vector<Trajectory>::iterator it = theTmpTrajectories.begin(); it != theTmpTrajectories.end(); it++) {
+          if (it->isValid()) {
+            it->setSeedRef(collseed->refAt(j));
+            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NOT_STOPPED);
+            // Store trajectory
+            rawResult.push_back(std::move(*it));
+            // Tell seed cleaner which hits this trajectory used.
+            //TO BE FIXED: this cut should be configurable via cfi file
+            if (theSeedCleaner && rawResult.back().foundHits() > 3)
+              theSeedCleaner->add(&rawResult.back());
+            //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
           }
         }
 
@@ -355,29 +354,100 @@ namespace cms {
 
         LogDebug("CkfPattern") << "rawResult trajectories found so far = " << rawResult.size();
 
+        if (maxSeedsBeforeCleaning_ > 0 && rawResult.size() > maxSeedsBeforeCleaning_ + lastCleanResult) {
+          theTrajectoryCleaner->clean(rawResult);
+          rawResult.erase(
+              std::remove_if(rawResult.begin() + lastCleanResult, rawResult.end(), std::not_fn(&Trajectory::isValid)),
+              rawResult.end());
+          lastCleanResult = rawResult.size();
+        }
+      };
+
+      auto theLoop = [&](size_t ii) {
+        auto j = indeces[ii];
+
+        ntseed++;
+
+        // to be moved inside a par section (how with tbb??)
+        std::vector<Trajectory> theTmpTrajectories;
+
+        LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
+
         {
           Lock lock(theMutex);
-          if (maxSeedsBeforeCleaning_ > 0 && rawResult.size() > maxSeedsBeforeCleaning_ + lastCleanResult) {
-            theTrajectoryCleaner->clean(rawResult);
-            rawResult.erase(
-                std::remove_if(rawResult.begin() + lastCleanResult, rawResult.end(), std::not_fn(&Trajectory::isValid)),
-                rawResult.end());
-            lastCleanResult = rawResult.size();
+          // Check if seed hits already used by another track
+          if (theSeedCleaner && !theSeedCleaner->good(&((*collseed)[j]))) {
+            LogDebug("CkfTrackCandidateMakerBase") << " Seed cleaning kills seed " << j;
+            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+            return;  // from the lambda!
           }
         }
+
+        SeedStopInfo seedStopInfo;
+        bool built = buildSeed(j, *theTrajectoryBuilder, theTmpTrajectories, seedStopInfo);
+        {
+          Lock lock(theMutex);
+          (*outputSeedStopInfos)[j] = seedStopInfo;
+          if (built)
+            storeSeed(j, theTmpTrajectories);
+        }
       };
       // end of loop over seeds
 
+      if (theMaxConcurrentSeedBatches > 1 && collseed_size > theSeedsPerBatch) {
+        // The seeds are taken in windows of up to theMaxConcurrentSeedBatches batches of theSeedsPerBatch seeds.
+        // The batches of a window are built concurrently in the framework arena, batch b with builder b, and
+        // their trajectories are then stored in seed order. A seed rejected by the seed cleaner at the start of
+        // the window is not built, and one rejected once the previous seeds are stored is dropped: the cleaner
+        // only learns hits, so the result is the one of the serial loop for any seedsPerBatch.
+        size_t windowSize = size_t(theMaxConcurrentSeedBatches) * theSeedsPerBatch;
+        size_t maxWindowSize = std::min(windowSize, collseed_size);
+        std::vector<std::vector<Trajectory>> seedTrajectories(maxWindowSize);
+        std::vector<SeedStopInfo> seedStopInfos(maxWindowSize);
+        std::vector<char> seedGood(maxWindowSize);
+        std::vector<char> seedBuilt(maxWindowSize);
+        for (size_t first = 0; first < collseed_size; first += windowSize) {
+          size_t last = std::min(collseed_size, first + windowSize);
+          for (size_t ii = first; ii < last; ++ii) {
+            seedGood[ii - first] = !theSeedCleaner || theSeedCleaner->good(&((*collseed)[indeces[ii]]));
+          }
+          size_t nBatches = (last - first + theSeedsPerBatch - 1) / theSeedsPerBatch;
+          tbb::parallel_for(size_t(0), nBatches, [&](size_t batch) {
+            auto const& builder = batch == 0 ? *theTrajectoryBuilder : *theConcurrentTrajectoryBuilders[batch - 1];
+            auto end = std::min(last, first + (batch + 1) * theSeedsPerBatch);
+            for (auto ii = first + batch * theSeedsPerBatch; ii < end; ++ii) {
+              auto k = ii - first;
+              seedStopInfos[k] = SeedStopInfo();
+              seedBuilt[k] = seedGood[k] && buildSeed(indeces[ii], builder, seedTrajectories[k], seedStopInfos[k]);
+            }
+          });
+          for (size_t ii = first; ii < last; ++ii) {
+            auto j = indeces[ii];
+            auto k = ii - first;
+            ntseed++;
+            if (!seedGood[k] || (theSeedCleaner && !theSeedCleaner->good(&((*collseed)[j])))) {
+              LogDebug("CkfTrackCandidateMakerBase") << " Seed cleaning kills seed " << j;
+              (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+              seedTrajectories[k].clear();
+              continue;
+            }
+            (*outputSeedStopInfos)[j] = seedStopInfos[k];
+            if (seedBuilt[k])
+              storeSeed(j, seedTrajectories[k]);
+          }
+        }
+      } else {
 #ifdef VI_TBB
-      tbb::parallel_for(0UL, collseed_size, 1UL, theLoop);
+        tbb::parallel_for(0UL, collseed_size, 1UL, theLoop);
 #else
 #ifdef VI_OMP
 #pragma omp parallel for schedule(dynamic, 4)
 #endif
-      for (size_t j = 0; j < collseed_size; j++) {
-        theLoop(j);
-      }
+        for (size_t j = 0; j < collseed_size; j++) {
+          theLoop(j);
+        }
 #endif
+      }
       assert(ntseed == collseed_size);
       if (theSeedCleaner)
         theSeedCleaner->done();
@@ -37,6 +37,7 @@ CkfTrajectoryBuilder::CkfTrajectoryBuilder(const edm::ParameterSet& conf, std::u
   theLostHitPenalty = conf.getParameter<double>("lostHitPenalty");
   theIntermediateCleaning = conf.getParameter<bool>("intermediateCleaning");
   theAlwaysUseInvalidHits = conf.getParameter<bool>("alwaysUseInvalidHits");
+  theBatchedUpdate = conf.existsAs<bool>("batchedUpdate") ? conf.getParameter<bool>("batchedUpdate") : false;
   /*
     theSharedSeedCheck = conf.getParameter<bool>("SharedSeedCheck");
     std::stringstream ss;
@@ -188,11 +189,48 @@ unsigned int CkfTrajectoryBuilder::limitedCandidates(const boost::shared_ptr<con
     return (a.chiSquared() + a.lostHits() * theLostHitPenalty) < (b.chiSquared() + b.lostHits() * theLostHitPenalty);
   };
 
+  auto lastToUse = [this](std::vector<TM> const& meas) {
+    if (theAlwaysUseInvalidHits || !meas.front().recHit()->isValid())
+      return meas.end();
+    return find_if(meas.begin(), meas.end(), [](auto const& meas) { return !meas.recHit()->isValid(); });
+  };
+
+  std::vector<std::vector<TM>> candMeas;
+  std::vector<const TSOS*> predictedStates;
+  std::vector<const TrackingRecHit*> hits;
+  std::vector<TSOS> updatedStates;
+
   while (!candidates.empty()) {
     newCand.clear();
+
+    // find the measurements of all the candidates first and update the predicted states
+    // with all their valid hits in one call, the candidates are then extended as below
+    if (theBatchedUpdate) {
+      candMeas.clear();
+      candMeas.resize(candidates.size());
+      predictedStates.clear();
+      hits.clear();
+      for (unsigned int i = 0; i < candidates.size(); ++i) {
+        findCompatibleMeasurements(*sharedSeed, candidates[i], candMeas[i]);
+        if (candMeas[i].empty())
+          continue;
+        for (auto itm = candMeas[i].cbegin(), last = lastToUse(candMeas[i]); itm != last; itm++) {
+          if (itm->recHit()->isValid()) {
+            predictedStates.push_back(&itm->predictedState());
+            hits.push_back(itm->recHit().get());
+          }
+        }
+      }
+      theUpdator->updateBatch(predictedStates, hits, updatedStates);
+    }
+    auto updatedState = updatedStates.begin();
+
     for (auto traj = candidates.begin(); traj != candidates.end(); traj++) {
       std::vector<TM> meas;
-      findCompatibleMeasurements(*sharedSeed, *traj, meas);
+      if (theBatchedUpdate)
+        meas.swap(candMeas[traj - candidates.begin()]);
+      else
+        findCompatibleMeasurements(*sharedSeed, *traj, meas);
 
       // --- method for debugging
       if (!analyzeMeasurementsDebugger(
@@ -203,19 +241,14 @@ unsigned int CkfTrajectoryBuilder::limitedCandidates(const boost::shared_ptr<con
       if (meas.empty()) {
         addToResult(sharedSeed, *traj, result);
       } else {
-        std::vector<TM>::const_iterator last;
-        if (theAlwaysUseInvalidHits)
-          last = meas.end();
-        else {
-          if (meas.front().recHit()->isValid()) {
-            last = find_if(meas.begin(), meas.end(), [](auto const& meas) { return !meas.recHit()->isValid(); });
-          } else
-            last = meas.end();
-        }
+        auto last = lastToUse(meas);
 
         for (auto itm = meas.begin(); itm != last; itm++) {
           TempTrajectory newTraj = *traj;
-          updateTrajectory(newTraj, std::move(*itm));
+          if (theBatchedUpdate && itm->recHit()->isValid())
+            updateTrajectory(newTraj, std::move(*itm), std::move(*updatedState++));
+          else
+            updateTrajectory(newTraj, std::move(*itm));
 
           if (toBeContinued(newTraj)) {
             newCand.push_back(std::move(newTraj));
@@ -309,6 +342,12 @@ void CkfTrajectoryBuilder::updateTrajectory(TempTrajectory& traj, TM&& tm) const
   }
 }
 
+void CkfTrajectoryBuilder::updateTrajectory(TempTrajectory& traj, TM&& tm, TSOS&& upState) const {
+  auto&& predictedState = tm.predictedState();
+  auto&& hit = tm.recHit();
+  traj.emplace(std::move(predictedState), std::move(upState), std::move(hit), tm.estimate(), tm.layer());
+}
+
 void CkfTrajectoryBuilder::findCompatibleMeasurements(const TrajectorySeed& seed,
                                                       const TempTrajectory& traj,
                                                       std::vector<TrajectoryMeasurement>& result) const {
@@ -0,0 +1,114 @@
+/*
+ * Compares the track candidates and the seed stop infos of two CkfTrackCandidateMaker modules and
+ * throws if they differ. Used to check that building the seeds in concurrent batches gives the
+ * track candidates of the serial loop.
+ */
+
+#include "DataFormats/TrackCandidate/interface/TrackCandidateCollection.h"
+#include "DataFormats/TrackReco/interface/SeedStopInfo.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <iterator>
+#include <vector>
+
+class TrackCandidateComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit TrackCandidateComparator(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions&);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  static bool same(const TrackCandidate& a, const TrackCandidate& b);
+
+  const edm::InputTag referenceTag_;
+  const edm::InputTag testTag_;
+  const edm::EDGetTokenT<TrackCandidateCollection> referenceCandidatesToken_;
+  const edm::EDGetTokenT<TrackCandidateCollection> testCandidatesToken_;
+  const edm::EDGetTokenT<std::vector<SeedStopInfo>> referenceSeedStopInfosToken_;
+  const edm::EDGetTokenT<std::vector<SeedStopInfo>> testSeedStopInfosToken_;
+};
+
+TrackCandidateComparator::TrackCandidateComparator(const edm::ParameterSet& iConfig)
+    : referenceTag_(iConfig.getParameter<edm::InputTag>("reference")),
+      testTag_(iConfig.getParameter<edm::InputTag>("test")),
+      referenceCandidatesToken_(consumes<TrackCandidateCollection>(referenceTag_)),
+      testCandidatesToken_(consumes<TrackCandidateCollection>(testTag_)),
+      referenceSeedStopInfosToken_(consumes<std::vector<SeedStopInfo>>(referenceTag_)),
+      testSeedStopInfosToken_(consumes<std::vector<SeedStopInfo>>(testTag_)) {}
+
+void TrackCandidateComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("reference", edm::InputTag("initialStepTrackCandidates"));
+  desc.add<edm::InputTag>("test", edm::InputTag("initialStepTrackCandidatesConcurrent"));
+  descriptions.add("trackCandidateComparator", desc);
+}
+
+bool TrackCandidateComparator::same(const TrackCandidate& a, const TrackCandidate& b) {
+  if (a.seedRef().key() != b.seedRef().key() || a.nLoops() != b.nLoops() || a.stopReason() != b.stopReason())
+    return false;
+  auto const& aState = a.trajectoryStateOnDet();
+  auto const& bState = b.trajectoryStateOnDet();
+  if (aState.detId() != bState.detId() || aState.parameters().vector() != bState.parameters().vector())
+    return false;
+  auto aHits = a.recHits();
+  auto bHits = b.recHits();
+  if (std::distance(aHits.first, aHits.second) != std::distance(bHits.first, bHits.second))
+    return false;
+  for (auto aHit = aHits.first, bHit = bHits.first; aHit != aHits.second; ++aHit, ++bHit) {
+    if (aHit->rawId() != bHit->rawId() || aHit->getType() != bHit->getType() ||
+        (aHit->isValid() && !aHit->sharesInput(&*bHit, TrackingRecHit::all)))
+      return false;
+  }
+  return true;
+}
+
+void TrackCandidateComparator::analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup&) const {
+  const auto& reference = iEvent.get(referenceCandidatesToken_);
+  const auto& test = iEvent.get(testCandidatesToken_);
+  if (reference.size() != test.size()) {
+    throw cms::Exception("TrackCandidateMismatch") << testTag_.encode() << " has " << test.size() << " candidates, "
+                                                   << referenceTag_.encode() << " " << reference.size()
+                                                   << " in event " << iEvent.id();
+  }
+  for (std::size_t i = 0; i < reference.size(); ++i) {
+    if (!same(reference[i], test[i])) {
+      throw cms::Exception("TrackCandidateMismatch")
+          << "candidate " << i << " of the seed " << reference[i].seedRef().key() << " differs in "
+          << referenceTag_.encode() << " and " << testTag_.encode() << " in event " << iEvent.id();
+    }
+  }
+
+  const auto& referenceStops = iEvent.get(referenceSeedStopInfosToken_);
+  const auto& testStops = iEvent.get(testSeedStopInfosToken_);
+  if (referenceStops.size() != testStops.size()) {
+    throw cms::Exception("TrackCandidateMismatch")
+        << testTag_.encode() << " has " << testStops.size() << " seed stop infos, " << referenceTag_.encode() << " "
+        << referenceStops.size() << " in event " << iEvent.id();
+  }
+  for (std::size_t i = 0; i < referenceStops.size(); ++i) {
+    if (referenceStops[i].stopReason() != testStops[i].stopReason() ||
+        referenceStops[i].candidatesPerSeed() != testStops[i].candidatesPerSeed()) {
+      throw cms::Exception("TrackCandidateMismatch")
+          << "seed " << i << " stopped as " << int(referenceStops[i].stopReasonUC()) << " after "
+          << referenceStops[i].candidatesPerSeed() << " candidates in " << referenceTag_.encode() << ", as "
+          << int(testStops[i].stopReasonUC()) << " after " << testStops[i].candidatesPerSeed() << " in "
+          << testTag_.encode() << " in event " << iEvent.id();
+    }
+  }
+  edm::LogInfo("TrackCandidateComparator")
+      << reference.size() << " identical track candidates from " << referenceStops.size() << " seeds in event "
+      << iEvent.id();
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(TrackCandidateComparator);
@@ -0,0 +1,49 @@
+# Runs the tracking up to the initial step track candidates from the raw data, builds the initial
+# step track candidates again with the seeds in concurrent batches, and checks that both give the
+# same track candidates and seed stop infos.
+#
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.Eras.Era_Run2_2017_cff import Run2_2017
+
+process = cms.Process("CompareCkf", Run2_2017)
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.RawToDigi_Data_cff")
+process.load("Configuration.StandardSequences.Reconstruction_Data_cff")
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_data', '')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+        '/store/relval/CMSSW_10_2_0_pre4/DoubleEG/RAW-RECO/ZElectron-102X_dataRun2_PromptLike_v1_RelVal_doubEG2017B-v1/20000/2A91DAFF-9161-E811-93F5-0CC47A4D765E.root'
+    )
+)
+
+# small batches, so that every event has several windows of concurrent batches
+process.initialStepTrackCandidatesConcurrent = process.initialStepTrackCandidates.clone(
+    maxConcurrentSeedBatches = 4,
+    seedsPerBatch = 10
+)
+
+process.trackCandidateComparator = cms.EDAnalyzer("TrackCandidateComparator",
+    reference = cms.InputTag("initialStepTrackCandidates"),
+    test = cms.InputTag("initialStepTrackCandidatesConcurrent")
+)
+
+process.p = cms.Path(process.RawToDigi * process.reconstruction_trackingOnly *
+                     process.initialStepTrackCandidatesConcurrent * process.trackCandidateComparator)
@@ -1,17 +1,21 @@
 #ifndef RecHitsSortedInPhi_H
 #define RecHitsSortedInPhi_H
 
+#include "DataFormats/GeometryVector/interface/Pi.h"
 #include "DataFormats/TrackerRecHit2D/interface/BaseTrackerRecHit.h"
 #include "TrackingTools/DetLayers/interface/DetLayer.h"
 
 #include <vector>
 #include <array>
+#include <utility>
 
 #include <cassert>
 
 /** A RecHit container sorted in phi.
  *  Provides fast access for hits in a given phi window
  *  using binary search.
+ *  The search is restricted to the hits of the bins of a fixed size
+ *  phi binning containing the ends of the window.
  */
 
 class RecHitsSortedInPhi {
@@ -40,6 +44,26 @@ public:
 
   using DoubleRange = std::array<int, 4>;
 
+  static constexpr int nPhiBins = 128;
+  static int phiBin(float phi) {
+    constexpr float scale = nPhiBins / Geom::ftwoPi();
+    float b = (phi + Geom::fpi()) * scale;
+    return !(b > 0.f) ? 0 : (b < float(nPhiBins) ? int(b) : nPhiBins - 1);
+  }
+
+  // index of the first hit of each phi bin (the last one is the number of hits)
+  using PhiBinOffsets = std::array<int, nPhiBins + 1>;
+
+  // fills the offsets of the bins of the sorted phis
+  static void fillPhiBinOffsets(const std::vector<float>& phis, PhiBinOffsets& offsets);
+
+  // indices of the first phi not below phiMin and of the first phi above phiMax, searched
+  // only in the bins of phiMin and phiMax: the result of lower_bound and upper_bound
+  static std::pair<int, int> phiRange(const std::vector<float>& phis,
+                                      const PhiBinOffsets& offsets,
+                                      float phiMin,
+                                      float phiMax);
+
   RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint const& origin, DetLayer const* il);
 
   bool empty() const { return theHits.empty(); }
@@ -84,7 +108,7 @@ public:
   Range all() const { return Range(theHits.begin(), theHits.end()); }
 
 public:
-  float phi(int i) const { return theHits[i].phi(); }
+  float phi(int i) const { return phis[i]; }
   float gv(int i) const { return isBarrel ? z[i] : gp(i).perp(); }  // global v
   float rv(int i) const { return isBarrel ? u[i] : v[i]; }          // dispaced r
   GlobalPoint gp(int i) const { return GlobalPoint(x[i], y[i], z[i]); }
@@ -109,6 +133,10 @@ public:
   std::vector<float> dv;
   std::vector<float> lphi;
 
+  // phi of the hits, and index of the first hit of each phi bin
+  std::vector<float> phis;
+  PhiBinOffsets phiBinOffsets;
+
   static void copyResult(const Range& range, std::vector<Hit>& result) {
     result.reserve(result.size() + (range.second - range.first));
     for (HitIter i = range.first; i != range.second; i++)
@@ -20,15 +20,26 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
   // cosmic region never used here
   // assert(origin.x()==0 && origin.y()==0);
 
-  theHits.reserve(hits.size());
-  for (auto const& hp : hits)
-    theHits.emplace_back(hp);
+  // the global state of each hit is computed once and the hits are then sorted in phi,
+  // until then phis is in the order of the input hits
+  std::vector<TrackingRecHitGlobalState> states;
+  states.reserve(hits.size());
+  phis.resize(hits.size());
+  std::vector<unsigned int> order(hits.size());
+  for (unsigned int i = 0; i != hits.size(); ++i) {
+    states.push_back(hits[i]->globalState());
+    phis[i] = states.back().phi;
+    order[i] = i;
+  }
+  // hits with the same phi keep the order of the input
+  std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return phis[a] < phis[b]; });
 
-  std::sort(theHits.begin(), theHits.end(), HitLessPhi());
+  theHits.reserve(hits.size());
+  for (unsigned int i = 0; i != order.size(); ++i)
+    theHits.emplace_back(hits[order[i]], phis[order[i]]);
 
   for (unsigned int i = 0; i != theHits.size(); ++i) {
-    auto const& h = *theHits[i].hit();
-    auto const& gs = static_cast<BaseTrackerRecHit const&>(h).globalState();
+    auto const& gs = states[order[i]];
     auto loc = gs.position - origin.basicVector();
     float lr = loc.perp();
     // float lr = gs.position.perp();
@@ -46,7 +57,35 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
     du[i] = isBarrel ? dr : dz;
     dv[i] = isBarrel ? dz : dr;
     lphi[i] = loc.barePhi();
+
+    phis[i] = theHits[i].phi();
   }
+  fillPhiBinOffsets(phis, phiBinOffsets);
+}
+
+void RecHitsSortedInPhi::fillPhiBinOffsets(const std::vector<float>& phis, PhiBinOffsets& offsets) {
+  int bin = 0;
+  for (unsigned int i = 0; i != phis.size(); ++i) {
+    for (int hb = phiBin(phis[i]); bin <= hb; ++bin)
+      offsets[bin] = i;
+  }
+  for (; bin <= nPhiBins; ++bin)
+    offsets[bin] = phis.size();
+}
+
+std::pair<int, int> RecHitsSortedInPhi::phiRange(const std::vector<float>& phis,
+                                                 const PhiBinOffsets& offsets,
+                                                 float phiMin,
+                                                 float phiMax) {
+  // the first hit not below phiMin is in the bin of phiMin (or is the first hit of the next one),
+  // the same holds for the first hit above phiMax
+  int bin = phiBin(phiMin);
+  int low = std::lower_bound(phis.begin() + offsets[bin], phis.begin() + offsets[bin + 1], phiMin) - phis.begin();
+  bin = phiBin(phiMax);
+  int first = std::max(low, offsets[bin]);
+  int high =
+      std::upper_bound(phis.begin() + first, phis.begin() + std::max(first, offsets[bin + 1]), phiMax) - phis.begin();
+  return std::make_pair(low, high);
 }
 
 RecHitsSortedInPhi::DoubleRange RecHitsSortedInPhi::doubleRange(float phiMin, float phiMax) const {
@@ -97,6 +136,6 @@ std::vector<RecHitsSortedInPhi::Hit> RecHitsSortedInPhi::hits(float phiMin, floa
 }
 
 RecHitsSortedInPhi::Range RecHitsSortedInPhi::unsafeRange(float phiMin, float phiMax) const {
-  auto low = std::lower_bound(theHits.begin(), theHits.end(), HitWithPhi(phiMin), HitLessPhi());
-  return Range(low, std::upper_bound(low, theHits.end(), HitWithPhi(phiMax), HitLessPhi()));
+  auto range = phiRange(phis, phiBinOffsets, phiMin, phiMax);
+  return Range(theHits.begin() + range.first, theHits.begin() + range.second);
 }
@@ -0,0 +1,87 @@
+#include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Checks that the phi range found in the bins of RecHitsSortedInPhi is the one of the binary
+// search over all the hits, i.e. lower_bound of phiMin and upper_bound of phiMax from there.
+namespace {
+  int checkRanges(std::vector<float> phis, std::vector<std::pair<float, float>> const& windows, const char* sample) {
+    std::sort(phis.begin(), phis.end());
+    RecHitsSortedInPhi::PhiBinOffsets offsets;
+    RecHitsSortedInPhi::fillPhiBinOffsets(phis, offsets);
+
+    int failures = 0;
+    for (auto const& window : windows) {
+      auto low = std::lower_bound(phis.begin(), phis.end(), window.first);
+      auto high = std::upper_bound(low, phis.end(), window.second);
+      auto range = RecHitsSortedInPhi::phiRange(phis, offsets, window.first, window.second);
+      if (range.first != low - phis.begin() || range.second != high - phis.begin()) {
+        std::cout << sample << ": window (" << window.first << ", " << window.second << ") gives [" << range.first
+                  << ", " << range.second << "), the binary search [" << low - phis.begin() << ", "
+                  << high - phis.begin() << ")" << std::endl;
+        ++failures;
+      }
+    }
+    return failures;
+  }
+}  // namespace
+
+int main() {
+  const float pi = Geom::fpi();
+  const float binWidth = Geom::ftwoPi() / RecHitsSortedInPhi::nPhiBins;
+  std::mt19937 engine(42);
+  std::uniform_real_distribution<float> uniformPhi(-pi, pi);
+  std::uniform_real_distribution<float> width(0.f, 0.5f);
+
+  // phis at the edges of the bins and at +-pi, which are also used as ends of the windows
+  std::vector<float> edges = {-pi, pi, std::nextafter(-pi, 0.f), std::nextafter(pi, 0.f)};
+  for (int bin = 1; bin < RecHitsSortedInPhi::nPhiBins; ++bin) {
+    float edge = -pi + bin * binWidth;
+    edges.push_back(edge);
+    edges.push_back(std::nextafter(edge, -pi));
+    edges.push_back(std::nextafter(edge, pi));
+  }
+
+  std::vector<std::pair<float, float>> windows = {{-pi, pi}, {-pi, -pi}, {pi, pi}, {0.f, 0.f}};
+  for (int i = 0; i < 10000; ++i) {
+    float phiMin = uniformPhi(engine);
+    windows.emplace_back(phiMin, std::min(pi, phiMin + width(engine)));
+  }
+  for (unsigned int i = 0; i < edges.size(); ++i) {
+    windows.emplace_back(edges[i], std::min(pi, edges[i] + width(engine)));
+    windows.emplace_back(std::max(-pi, edges[i] - width(engine)), edges[i]);
+    windows.emplace_back(edges[i], edges[i]);
+  }
+
+  int failures = checkRanges({}, windows, "no hits");
+  for (unsigned int n : {1, 10, 100, 1000, 10000}) {
+    std::vector<float> phis;
+    for (unsigned int i = 0; i < n; ++i)
+      phis.push_back(uniformPhi(engine));
+    failures += checkRanges(phis, windows, "random hits");
+
+    // many hits with the same phi
+    for (auto& phi : phis)
+      phi = std::round(phi * 10.f) / 10.f;
+    failures += checkRanges(phis, windows, "hits with the same phi");
+
+    // windows ending on the phi of a hit
+    std::vector<std::pair<float, float>> hitWindows;
+    for (auto phi : phis) {
+      hitWindows.emplace_back(phi, std::min(pi, phi + width(engine)));
+      hitWindows.emplace_back(std::max(-pi, phi - width(engine)), phi);
+    }
+    failures += checkRanges(phis, hitWindows, "windows ending on hits");
+  }
+  failures += checkRanges(edges, windows, "hits at the bin edges");
+
+  if (failures > 0) {
+    std::cout << failures << " windows differ from the binary search" << std::endl;
+    return 1;
+  }
+  return 0;
+}
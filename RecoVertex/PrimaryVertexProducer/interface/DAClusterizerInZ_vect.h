@@ -7,6 +7,9 @@
 
 	Version which auto-vectorizes with gcc 4.6 or newer
 
+	With zrange > 0 the tracks, sorted in z, only see the vertices within zrange*sigma(z)*sqrt(T);
+	with trackBlockSize > 0 the weight updates are done for blocks of tracks in parallel TBB tasks
+
  */
 
 #include "RecoVertex/PrimaryVertexProducer/interface/TrackClusterizerInZ.h"
@@ -28,6 +31,9 @@ public:
 
       pi.push_back(new_pi);  // track weight
       Z_sum.push_back(1.0);  // Z[i]   for DA clustering, initial value as done in ::fill
+
+      kmin.push_back(0);
+      kmax.push_back(0);
     }
 
     unsigned int GetSize() const { return z.size(); }
@@ -38,6 +44,8 @@ public:
       _dz2 = &dz2.front();
       _Z_sum = &Z_sum.front();
       _pi = &pi.front();
+      _kmin = &kmin.front();
+      _kmax = &kmax.front();
     }
 
     double *__restrict__ _z;    // z-coordinate at point of closest approach to the beamline
@@ -46,12 +54,18 @@ public:
     double *__restrict__ _Z_sum;  // Z[i]   for DA clustering
     double *__restrict__ _pi;     // track weight
 
+    unsigned int *__restrict__ _kmin;  // the track is used for the vertices kmin <= k < kmax
+    unsigned int *__restrict__ _kmax;
+
     std::vector<double> z;                         // z-coordinate at point of closest approach to the beamline
     std::vector<double> dz2;                       // square of the error of z(pca)
     std::vector<const reco::TransientTrack *> tt;  // a pointer to the Transient Track
 
     std::vector<double> Z_sum;  // Z[i]   for DA clustering
     std::vector<double> pi;     // track weight
+
+    std::vector<unsigned int> kmin;  // range of vertices seen by the track, see setVertexRange
+    std::vector<unsigned int> kmax;
   };
 
   struct vertex_t {
@@ -161,6 +175,8 @@ public:
 
   double beta0(const double betamax, track_t const &tks, vertex_t const &y) const;
 
+  void setVertexRange(const double beta, track_t &tks, vertex_t const &y) const;
+
 private:
   bool verbose_;
   double zdumpcenter_;
@@ -179,6 +195,9 @@ private:
   double uniquetrkweight_;
   double zmerge_;
   double betapurge_;
+
+  double zrange_;                // window of the vertices seen by a track, in units of sigma(z)*sqrt(T), 0: all
+  unsigned int trackBlockSize_;  // tracks per TBB task in update, 0: no TBB tasks
 };
 
 //#ifndef DAClusterizerInZ_new_h
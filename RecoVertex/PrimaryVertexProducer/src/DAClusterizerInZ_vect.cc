@@ -3,13 +3,18 @@
 #include "DataFormats/GeometryCommonDetAlgo/interface/Measurement1D.h"
 #include "RecoVertex/VertexPrimitives/interface/VertexException.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <limits>
 #include <iomanip>
+#include <numeric>
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
 using namespace std;
 
 DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
@@ -37,6 +42,9 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
   dzCutOff_ = conf.getParameter<double>("dzCutOff");
   uniquetrkweight_ = conf.getParameter<double>("uniquetrkweight");
   zmerge_ = conf.getParameter<double>("zmerge");
+  zrange_ = conf.existsAs<double>("zrange") ? conf.getParameter<double>("zrange") : 0.;
+  trackBlockSize_ =
+      conf.existsAs<unsigned int>("trackBlockSize") ? conf.getParameter<unsigned int>("trackBlockSize") : 0;
 
   if (verbose_) {
     std::cout << "DAClusterizerinZ_vect: mintrkweight = " << mintrkweight_ << std::endl;
@@ -49,6 +57,8 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
     std::cout << "DAClusterizerinZ_vect: coolingFactor = " << coolingFactor_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: d0CutOff = " << d0CutOff_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: dzCutOff = " << dzCutOff_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: zrange = " << zrange_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: trackBlockSize = " << trackBlockSize_ << std::endl;
   }
 
   if (Tmin == 0) {
@@ -114,6 +124,18 @@ DAClusterizerInZ_vect::track_t DAClusterizerInZ_vect::fill(const vector<reco::Tr
     LogTrace("DAClusterizerinZ_vectorized") << t_z << ' ' << t_dz2 << ' ' << t_pi;
     tks.AddItem(t_z, t_dz2, &(*it), t_pi);
   }
+
+  if (zrange_ > 0) {
+    // the range of vertices seen by the tracks is found for tracks sorted in z
+    std::vector<unsigned int> order(tks.GetSize());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(
+        order.begin(), order.end(), [&tks](unsigned int a, unsigned int b) { return tks.z[a] < tks.z[b]; });
+    track_t sorted;
+    for (auto i : order)
+      sorted.AddItem(tks.z[i], tks.dz2[i], tks.tt[i], tks.pi[i]);
+    tks = std::move(sorted);
+  }
   tks.ExtractRaw();
 
   if (verbose_) {
@@ -136,6 +158,8 @@ double DAClusterizerInZ_vect::update(
   const unsigned int nt = gtracks.GetSize();
   const unsigned int nv = gvertices.GetSize();
 
+  setVertexRange(beta, gtracks, gvertices);
+
   //initialize sums
   double sumpi = 0;
 
@@ -149,27 +173,46 @@ double DAClusterizerInZ_vect::update(
     Z_init = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_);  // cut-off
   }
 
-  // define kernels
-  auto kernel_calc_exp_arg = [beta, nv](const unsigned int itrack, track_t const& tracks, vertex_t const& vertices) {
+  // define kernels, for the vertices kmin <= k < kmax seen by a track
+  auto kernel_calc_exp_arg = [beta](const unsigned int itrack,
+                                    track_t const& tracks,
+                                    vertex_t const& vertices,
+                                    const unsigned int kmin,
+                                    const unsigned int kmax,
+                                    double* __restrict__ ei_cache) {
     const double track_z = tracks._z[itrack];
     const double botrack_dz2 = -beta * tracks._dz2[itrack];
 
     // auto-vectorized
-    for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
+    for (unsigned int ivertex = kmin; ivertex < kmax; ++ivertex) {
       auto mult_res = track_z - vertices._z[ivertex];
-      vertices._ei_cache[ivertex] = botrack_dz2 * (mult_res * mult_res);
+      ei_cache[ivertex] = botrack_dz2 * (mult_res * mult_res);
     }
   };
 
-  auto kernel_add_Z = [nv, Z_init](vertex_t const& vertices) -> double {
+  auto kernel_add_Z = [Z_init](vertex_t const& vertices,
+                               const unsigned int kmin,
+                               const unsigned int kmax,
+                               double const* __restrict__ ei) -> double {
     double ZTemp = Z_init;
-    for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
-      ZTemp += vertices._pk[ivertex] * vertices._ei[ivertex];
+    for (unsigned int ivertex = kmin; ivertex < kmax; ++ivertex) {
+      ZTemp += vertices._pk[ivertex] * ei[ivertex];
     }
     return ZTemp;
   };
 
-  auto kernel_calc_normalization = [beta, nv](const unsigned int track_num, track_t& tks_vec, vertex_t& y_vec) {
+  // contribution of a track to the sums of the vertices
+  auto kernel_calc_normalization = [beta](const unsigned int track_num,
+                                          track_t& tks_vec,
+                                          vertex_t const& y_vec,
+                                          const unsigned int kmin,
+                                          const unsigned int kmax,
+                                          double const* __restrict__ ei_cache,
+                                          double const* __restrict__ ei,
+                                          double* __restrict__ se,
+                                          double* __restrict__ sw,
+                                          double* __restrict__ swz,
+                                          double* __restrict__ swE) {
     auto tmp_trk_pi = tks_vec._pi[track_num];
     auto o_trk_Z_sum = 1. / tks_vec._Z_sum[track_num];
     auto o_trk_dz2 = tks_vec._dz2[track_num];
@@ -177,15 +220,44 @@ double DAClusterizerInZ_vect::update(
     auto obeta = -1. / beta;
 
     // auto-vectorized
-    for (unsigned int k = 0; k < nv; ++k) {
-      y_vec._se[k] += y_vec._ei[k] * (tmp_trk_pi * o_trk_Z_sum);
-      auto w = y_vec._pk[k] * y_vec._ei[k] * (tmp_trk_pi * o_trk_Z_sum * o_trk_dz2);
-      y_vec._sw[k] += w;
-      y_vec._swz[k] += w * tmp_trk_z;
-      y_vec._swE[k] += w * y_vec._ei_cache[k] * obeta;
+    for (unsigned int k = kmin; k < kmax; ++k) {
+      se[k] += ei[k] * (tmp_trk_pi * o_trk_Z_sum);
+      auto w = y_vec._pk[k] * ei[k] * (tmp_trk_pi * o_trk_Z_sum * o_trk_dz2);
+      sw[k] += w;
+      swz[k] += w * tmp_trk_z;
+      swE[k] += w * ei_cache[k] * obeta;
     }
   };
 
+  // loop over the tracks first <= itrack < last, ei_cache and ei are work arrays of nv elements
+  auto update_tracks = [&](const unsigned int first,
+                           const unsigned int last,
+                           double* __restrict__ ei_cache,
+                           double* __restrict__ ei,
+                           double* __restrict__ se,
+                           double* __restrict__ sw,
+                           double* __restrict__ swz,
+                           double* __restrict__ swE) -> double {
+    double sum = 0;
+    for (auto itrack = first; itrack < last; ++itrack) {
+      const unsigned int kmin = gtracks._kmin[itrack];
+      const unsigned int kmax = gtracks._kmax[itrack];
+      kernel_calc_exp_arg(itrack, gtracks, gvertices, kmin, kmax, ei_cache);
+      local_exp_list(ei_cache + kmin, ei + kmin, kmax - kmin);
+
+      gtracks._Z_sum[itrack] = kernel_add_Z(gvertices, kmin, kmax, ei);
+      if (edm::isNotFinite(gtracks._Z_sum[itrack]))
+        gtracks._Z_sum[itrack] = 0.0;
+      // used in the next major loop to follow
+      sum += gtracks._pi[itrack];
+
+      if (gtracks._Z_sum[itrack] > 1.e-100) {
+        kernel_calc_normalization(itrack, gtracks, gvertices, kmin, kmax, ei_cache, ei, se, sw, swz, swE);
+      }
+    }
+    return sum;
+  };
+
   for (auto ivertex = 0U; ivertex < nv; ++ivertex) {
     gvertices._se[ivertex] = 0.0;
     gvertices._sw[ivertex] = 0.0;
@@ -193,19 +265,44 @@ double DAClusterizerInZ_vect::update(
     gvertices._swE[ivertex] = 0.0;
   }
 
-  // loop over tracks
-  for (auto itrack = 0U; itrack < nt; ++itrack) {
-    kernel_calc_exp_arg(itrack, gtracks, gvertices);
-    local_exp_list(gvertices._ei_cache, gvertices._ei, nv);
-
-    gtracks._Z_sum[itrack] = kernel_add_Z(gvertices);
-    if (edm::isNotFinite(gtracks._Z_sum[itrack]))
-      gtracks._Z_sum[itrack] = 0.0;
-    // used in the next major loop to follow
-    sumpi += gtracks._pi[itrack];
-
-    if (gtracks._Z_sum[itrack] > 1.e-100) {
-      kernel_calc_normalization(itrack, gtracks, gvertices);
+  if (trackBlockSize_ == 0 || nt <= trackBlockSize_) {
+    // loop over tracks
+    sumpi = update_tracks(0,
+                          nt,
+                          gvertices._ei_cache,
+                          gvertices._ei,
+                          gvertices._se,
+                          gvertices._sw,
+                          gvertices._swz,
+                          gvertices._swE);
+  } else {
+    // blocks of tracks in TBB tasks, each with its own sums, added in the order of the blocks:
+    // the result does not depend on the number of threads
+    const unsigned int nBlocks = (nt + trackBlockSize_ - 1) / trackBlockSize_;
+    std::vector<double> blockArrays(6 * nv * nBlocks, 0.);
+    std::vector<double> blockSumpi(nBlocks);
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(0U, nBlocks, [&](unsigned int b) {
+        double* a = &blockArrays[6 * nv * b];
+        blockSumpi[b] = update_tracks(b * trackBlockSize_,
+                                      std::min(nt, (b + 1) * trackBlockSize_),
+                                      a,
+                                      a + nv,
+                                      a + 2 * nv,
+                                      a + 3 * nv,
+                                      a + 4 * nv,
+                                      a + 5 * nv);
+      });
+    });
+    for (unsigned int b = 0; b < nBlocks; ++b) {
+      sumpi += blockSumpi[b];
+      double const* a = &blockArrays[6 * nv * b];
+      for (auto ivertex = 0U; ivertex < nv; ++ivertex) {
+        gvertices._se[ivertex] += a[2 * nv + ivertex];
+        gvertices._sw[ivertex] += a[3 * nv + ivertex];
+        gvertices._swz[ivertex] += a[4 * nv + ivertex];
+        gvertices._swE[ivertex] += a[5 * nv + ivertex];
+      }
     }
   }
 
@@ -250,6 +347,36 @@ double DAClusterizerInZ_vect::update(
   return delta;
 }
 
+void DAClusterizerInZ_vect::setVertexRange(const double beta, track_t& tks, vertex_t const& y) const {
+  // a track only sees the vertices within zrange_ * sigma(z) * sqrt(T), whose weight is above
+  // exp(-zrange_^2), and at least the closest one, which takes all its weight when the others are far
+  const unsigned int nt = tks.GetSize();
+  const unsigned int nv = y.GetSize();
+
+  // the vertices are sorted in z, unless a position became invalid
+  if ((zrange_ <= 0) || (nv == 0) || !std::is_sorted(y._z, y._z + nv)) {
+    for (unsigned int i = 0; i < nt; i++) {
+      tks._kmin[i] = 0;
+      tks._kmax[i] = nv;
+    }
+    return;
+  }
+
+  for (unsigned int i = 0; i < nt; i++) {
+    const double zrange = zrange_ / std::sqrt(beta * tks._dz2[i]);
+    unsigned int kmin = std::lower_bound(y._z, y._z + nv, tks._z[i] - zrange) - y._z;
+    unsigned int kmax = std::upper_bound(y._z + kmin, y._z + nv, tks._z[i] + zrange) - y._z;
+    if (kmin == kmax) {
+      if ((kmin == nv) || ((kmin > 0) && (tks._z[i] - y._z[kmin - 1] < y._z[kmin] - tks._z[i])))
+        --kmin;
+      else
+        ++kmax;
+    }
+    tks._kmin[i] = kmin;
+    tks._kmax[i] = kmax;
+  }
+}
+
 bool DAClusterizerInZ_vect::merge(vertex_t& y, double& beta) const {
   // merge clusters that collapsed or never separated,
   // only merge if the estimated critical temperature of the merged vertex is below the current temperature
@@ -306,6 +433,9 @@ bool DAClusterizerInZ_vect::purge(vertex_t& y, track_t& tks, double& rho0, const
   if (nv < 2)
     return false;
 
+  // the window of the last update was set before the vertices moved
+  setVertexRange(beta, tks, y);
+
   double sumpmin = nt;
   unsigned int k0 = nv;
 
@@ -315,6 +445,8 @@ bool DAClusterizerInZ_vect::purge(vertex_t& y, track_t& tks, double& rho0, const
 
     double pmax = y._pk[k] / (y._pk[k] + rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_));
     for (unsigned int i = 0; i < nt; i++) {
+      if ((k < tks._kmin[i]) || (k >= tks._kmax[i]))
+        continue;
       if (tks._Z_sum[i] > 1.e-100) {
         double p = y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k], tks._dz2[i])) / tks._Z_sum[i];
         sump += p;
@@ -699,13 +831,14 @@ vector<TransientVertex> DAClusterizerInZ_vect::vertices(const vector<reco::Trans
       y._z[k] = 0;
     }
 
-  for (unsigned int i = 0; i < nt; i++)  // initialize
-    tks._Z_sum[i] = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_);
+  setVertexRange(beta, tks, y);
 
-  // improve vectorization (does not require reduction ....)
-  for (unsigned int k = 0; k < nv; k++) {
-    for (unsigned int i = 0; i < nt; i++)
-      tks._Z_sum[i] += y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k], tks._dz2[i]));
+  const double Z_init = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_);
+  for (unsigned int i = 0; i < nt; i++) {
+    double Z_sum = Z_init;
+    for (unsigned int k = tks._kmin[i]; k < tks._kmax[i]; k++)
+      Z_sum += y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k], tks._dz2[i]));
+    tks._Z_sum[i] = Z_sum;
   }
 
   for (unsigned int k = 0; k < nv; k++) {
@@ -713,6 +846,8 @@ vector<TransientVertex> DAClusterizerInZ_vect::vertices(const vector<reco::Trans
 
     vector<reco::TransientTrack> vertexTracks;
     for (unsigned int i = 0; i < nt; i++) {
+      if ((k < tks._kmin[i]) || (k >= tks._kmax[i]))
+        continue;
       if (tks._Z_sum[i] > 1e-100) {
         double p = y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k], tks._dz2[i])) / tks._Z_sum[i];
         if ((tks._pi[i] > 0) && (p > mintrkweight_)) {
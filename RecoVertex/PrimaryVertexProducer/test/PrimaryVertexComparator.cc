@@ -0,0 +1,91 @@
+/*
+ * Compares two primary vertex collections and throws if they differ: the vertices must have the
+ * same tracks, in the same order, and positions within a tolerance. Used to check that the zrange
+ * and trackBlockSize options of DAClusterizerInZ_vect give the vertices of the default clustering.
+ */
+
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <cmath>
+#include <vector>
+
+class PrimaryVertexComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit PrimaryVertexComparator(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions&);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  static std::vector<unsigned int> trackKeys(const reco::Vertex& vertex);
+
+  const edm::InputTag referenceTag_;
+  const edm::InputTag testTag_;
+  const double tolerance_;
+  const edm::EDGetTokenT<reco::VertexCollection> referenceToken_;
+  const edm::EDGetTokenT<reco::VertexCollection> testToken_;
+};
+
+PrimaryVertexComparator::PrimaryVertexComparator(const edm::ParameterSet& iConfig)
+    : referenceTag_(iConfig.getParameter<edm::InputTag>("reference")),
+      testTag_(iConfig.getParameter<edm::InputTag>("test")),
+      tolerance_(iConfig.getParameter<double>("tolerance")),
+      referenceToken_(consumes<reco::VertexCollection>(referenceTag_)),
+      testToken_(consumes<reco::VertexCollection>(testTag_)) {}
+
+void PrimaryVertexComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("reference", edm::InputTag("offlinePrimaryVertices"));
+  desc.add<edm::InputTag>("test", edm::InputTag("offlinePrimaryVerticesZRange"));
+  desc.add<double>("tolerance", 1.e-5)->setComment("largest allowed difference of the vertex positions, in cm");
+  descriptions.add("primaryVertexComparator", desc);
+}
+
+std::vector<unsigned int> PrimaryVertexComparator::trackKeys(const reco::Vertex& vertex) {
+  std::vector<unsigned int> keys;
+  for (auto track = vertex.tracks_begin(); track != vertex.tracks_end(); ++track)
+    keys.push_back(track->key());
+  return keys;
+}
+
+void PrimaryVertexComparator::analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup&) const {
+  const auto& reference = iEvent.get(referenceToken_);
+  const auto& test = iEvent.get(testToken_);
+  if (reference.size() != test.size()) {
+    throw cms::Exception("PrimaryVertexMismatch") << testTag_.encode() << " has " << test.size() << " vertices, "
+                                                  << referenceTag_.encode() << " " << reference.size()
+                                                  << " in event " << iEvent.id();
+  }
+  auto differ = [this](double a, double b) { return !(std::abs(a - b) <= tolerance_); };
+  for (std::size_t i = 0; i < reference.size(); ++i) {
+    const auto& referenceVertex = reference[i];
+    const auto& testVertex = test[i];
+    if (referenceVertex.isFake() != testVertex.isFake() || trackKeys(referenceVertex) != trackKeys(testVertex)) {
+      throw cms::Exception("PrimaryVertexMismatch")
+          << "vertex " << i << " has " << referenceVertex.tracksSize() << " tracks in " << referenceTag_.encode()
+          << ", " << testVertex.tracksSize() << " different ones in " << testTag_.encode() << " in event "
+          << iEvent.id();
+    }
+    if (differ(referenceVertex.x(), testVertex.x()) || differ(referenceVertex.y(), testVertex.y()) ||
+        differ(referenceVertex.z(), testVertex.z())) {
+      throw cms::Exception("PrimaryVertexMismatch")
+          << "vertex " << i << " at " << testVertex.position() << " in " << testTag_.encode() << ", "
+          << referenceVertex.position() << " in " << referenceTag_.encode() << " in event " << iEvent.id();
+    }
+  }
+  edm::LogInfo("PrimaryVertexComparator") << reference.size() << " identical vertices in event " << iEvent.id();
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(PrimaryVertexComparator);
@@ -0,0 +1,43 @@
+# Runs the offline primary vertices on the tracks of a RECO file with the default DA_vect clustering
+# and with the zrange and trackBlockSize options, and checks that they give the same vertices.
+#
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from Configuration.Eras.Era_Run2_2017_cff import Run2_2017
+
+process = cms.Process("CompareVertices", Run2_2017)
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("TrackingTools.TransientTrack.TransientTrackBuilder_cfi")
+process.load("RecoVertex.PrimaryVertexProducer.OfflinePrimaryVertices_cfi")
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_data', '')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+        '/store/relval/CMSSW_10_2_0_pre4/DoubleEG/RAW-RECO/ZElectron-102X_dataRun2_PromptLike_v1_RelVal_doubEG2017B-v1/20000/2A91DAFF-9161-E811-93F5-0CC47A4D765E.root'
+    )
+)
+
+# the weights of the vertices outside zrange=5 are below exp(-25), and the tracks are updated in blocks
+process.offlinePrimaryVerticesZRange = process.offlinePrimaryVertices.clone()
+process.offlinePrimaryVerticesZRange.TkClusParameters.TkDAClusParameters.zrange = 5.
+process.offlinePrimaryVerticesZRange.TkClusParameters.TkDAClusParameters.trackBlockSize = 64
+
+process.primaryVertexComparator = cms.EDAnalyzer("PrimaryVertexComparator",
+    reference = cms.InputTag("offlinePrimaryVertices"),
+    test = cms.InputTag("offlinePrimaryVerticesZRange"),
+    tolerance = cms.double(1.e-5)
+)
+
+process.p = cms.Path(process.offlinePrimaryVertices * process.offlinePrimaryVerticesZRange *
+                     process.primaryVertexComparator)
@@ -0,0 +1,78 @@
+#ifndef RKBatchPropagator_H
+#define RKBatchPropagator_H
+
+/** \class RKBatchPropagator
+ *  Runge-Kutta propagator in the global frame which, besides the usual single state interface,
+ *  propagates many states to the same surface at once.
+ *
+ *  The states of a batch are integrated in groups of batchSize lanes which step together, each
+ *  with its own adaptive step size, and query the field of all lanes with one
+ *  MagneticField::inTeslaBatch call per stage (see RKBatchSolver). The search of the surface (path length estimate,
+ *  integration, distance check, at most 100 times) is the one of RKPropagatorInS, done for each
+ *  state. The single state methods, and the states of a batch with a straight line trajectory,
+ *  use RKPropagatorInS (the defaultRKPropagator).
+ *  Only cylinders centred on the z axis are supported, as in RKPropagatorInS.
+ */
+
+#include "TrackingTools/GeomPropagators/interface/Propagator.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "TrackPropagation/RungeKutta/interface/defaultRKPropagator.h"
+
+#include <utility>
+
+class RKBatchPropagator final : public Propagator {
+public:
+  static constexpr unsigned int batchSize = 8;
+
+  explicit RKBatchPropagator(const MagneticField* field,
+                             PropagationDirection dir = alongMomentum,
+                             double tolerance = 5.e-5);
+
+  RKBatchPropagator(const RKBatchPropagator&) = delete;
+  RKBatchPropagator& operator=(const RKBatchPropagator&) = delete;
+
+  ~RKBatchPropagator() override {}
+
+  using Propagator::propagate;
+  using Propagator::propagateWithPath;
+
+  /// Propagate fts[0] ... fts[n-1] to the plane, result[i] is the propagation of fts[i]
+  void propagateWithPath(const FreeTrajectoryState* fts,
+                         unsigned int n,
+                         const Plane& plane,
+                         std::pair<TrajectoryStateOnSurface, double>* result) const;
+
+  /// Propagate fts[0] ... fts[n-1] to the cylinder, result[i] is the propagation of fts[i]
+  void propagateWithPath(const FreeTrajectoryState* fts,
+                         unsigned int n,
+                         const Cylinder& cylinder,
+                         std::pair<TrajectoryStateOnSurface, double>* result) const;
+
+private:
+  std::pair<TrajectoryStateOnSurface, double> propagateWithPath(const FreeTrajectoryState& fts,
+                                                                const Plane& plane) const override {
+    return static_cast<const Propagator&>(theScalar.propagator).propagateWithPath(fts, plane);
+  }
+
+  std::pair<TrajectoryStateOnSurface, double> propagateWithPath(const FreeTrajectoryState& fts,
+                                                                const Cylinder& cylinder) const override {
+    return static_cast<const Propagator&>(theScalar.propagator).propagateWithPath(fts, cylinder);
+  }
+
+public:
+  void setPropagationDirection(PropagationDirection dir) override {
+    Propagator::setPropagationDirection(dir);
+    theScalar.propagator.setPropagationDirection(dir);
+  }
+
+  Propagator* clone() const override;
+
+  const MagneticField* magneticField() const override { return theField; }
+
+private:
+  const MagneticField* theField;
+  double theTolerance;
+  defaultRKPropagator::Product theScalar;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include "FWCore/Framework/interface/ModuleFactory.h"
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
+#include "TrackingTools/Records/interface/TrackingComponentsRecord.h"
+#include "TrackPropagation/RungeKutta/interface/RKBatchPropagator.h"
+
+#include <memory>
+#include <string>
+
+namespace {
+
+  class RKBatchPropagatorESProducer : public edm::ESProducer {
+  public:
+    RKBatchPropagatorESProducer(const edm::ParameterSet& p);
+    std::unique_ptr<Propagator> produce(const TrackingComponentsRecord&);
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+      edm::ParameterSetDescription desc;
+      desc.add<std::string>("ComponentName", "RKBatchPropagator");
+      desc.add<std::string>("PropagationDirection", "alongMomentum")
+          ->setComment("alongMomentum, oppositeToMomentum or anyDirection");
+      desc.add<double>("tolerance", 5.e-5)->setComment("accuracy of the integration and of the end point, in cm");
+      desc.add<std::string>("MagneticFieldLabel", "");
+      descriptions.add("rkBatchPropagator", desc);
+    }
+
+  private:
+    edm::ESGetToken<MagneticField, IdealMagneticFieldRecord> magToken_;
+    PropagationDirection dir_;
+    const double tolerance_;
+  };
+
+  RKBatchPropagatorESProducer::RKBatchPropagatorESProducer(const edm::ParameterSet& p)
+      : dir_{alongMomentum}, tolerance_{p.getParameter<double>("tolerance")} {
+    std::string pdir = p.getParameter<std::string>("PropagationDirection");
+    if (pdir == "oppositeToMomentum")
+      dir_ = oppositeToMomentum;
+    else if (pdir == "anyDirection")
+      dir_ = anyDirection;
+    else if (pdir != "alongMomentum")
+      throw cms::Exception("Configuration") << "RKBatchPropagatorESProducer: unknown PropagationDirection " << pdir;
+
+    setWhatProduced(this, p.getParameter<std::string>("ComponentName"))
+        .setConsumes(magToken_, edm::ESInputTag("", p.getParameter<std::string>("MagneticFieldLabel")));
+  }
+
+  std::unique_ptr<Propagator> RKBatchPropagatorESProducer::produce(const TrackingComponentsRecord& iRecord) {
+    return std::make_unique<RKBatchPropagator>(&iRecord.get(magToken_), dir_, tolerance_);
+  }
+
+}  // namespace
+
+DEFINE_FWK_EVENTSETUP_MODULE(RKBatchPropagatorESProducer);
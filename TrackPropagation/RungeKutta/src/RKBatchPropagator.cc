@@ -0,0 +1,227 @@
+#include "TrackPropagation/RungeKutta/interface/RKBatchPropagator.h"
+#include "RKBatchSolver.h"
+#include "RKLocalFieldProvider.h"
+#include "PathToPlane2Order.h"
+#include "AnalyticalErrorPropagation.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "DataFormats/GeometrySurface/interface/Cylinder.h"
+#include "TrackingTools/GeomPropagators/interface/StraightLineCylinderCrossing.h"
+#include "TrackingTools/GeomPropagators/interface/PropagationDirectionFromPath.h"
+#include "TrackingTools/GeomPropagators/interface/PropagationExceptions.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Likely.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+  struct BatchTrack {
+    enum Status { active, done, failed };
+
+    unsigned int index;  // in the input
+    double state[6];     // global position and momentum
+    float charge;
+    double stot;
+    double startDistance;
+    PropagationDirection direction;
+    Status status;
+
+    GlobalPoint position() const { return GlobalPoint(state[0], state[1], state[2]); }
+    GlobalVector momentum() const { return GlobalVector(state[3], state[4], state[5]); }
+  };
+
+  PropagationDirection invertDirection(PropagationDirection dir) {
+    if (dir == anyDirection)
+      return dir;
+    return (dir == alongMomentum ? oppositeToMomentum : alongMomentum);
+  }
+
+  // Same iterations as RKPropagatorInS::propagateParametersOnPlane/Cylinder, the integration of
+  // the active tracks being done in groups of N.
+  // pathLength(track) gives the estimated path to the surface, distance(track) the distance to it.
+  template <unsigned int N, typename PathLength, typename Distance>
+  void solve(const MagneticField& field,
+             std::vector<BatchTrack>& tracks,
+             float eps,
+             PathLength pathLength,
+             Distance distance) {
+    RKBatchSolver<N> solver(field);
+    std::vector<unsigned int> active;
+    std::vector<double> steps(tracks.size());
+    int safeGuard = 0;
+    while (safeGuard++ < 100) {
+      active.clear();
+      for (unsigned int i = 0; i < tracks.size(); ++i) {
+        auto& track = tracks[i];
+        if (track.status != BatchTrack::active)
+          continue;
+        std::pair<bool, double> path = pathLength(track);
+        if
+          UNLIKELY(!path.first) {
+            LogDebug("RKBatchPropagator") << "RKBatchPropagator: Path length calculation failed for track "
+                                          << track.index;
+            track.status = BatchTrack::failed;
+            continue;
+          }
+        if
+          UNLIKELY(std::abs(path.second) < eps) {
+            track.status = BatchTrack::done;
+            continue;
+          }
+        steps[i] = path.second;
+        active.push_back(i);
+      }
+      if (active.empty())
+        return;
+
+      for (unsigned int first = 0; first < active.size(); first += N) {
+        unsigned int n = std::min<unsigned int>(N, active.size() - first);
+        typename RKBatchSolver<N>::State state;
+        double s[N];
+        float charge[N];
+        for (unsigned int l = 0; l < N; ++l) {
+          // the unused lanes repeat the first track, with a null path
+          unsigned int i = active[first + (l < n ? l : 0)];
+          for (unsigned int j = 0; j < 6; ++j)
+            state[j][l] = tracks[i].state[j];
+          s[l] = l < n ? steps[i] : 0.;
+          charge[l] = tracks[i].charge;
+        }
+        solver(state, s, charge, n, eps);
+        for (unsigned int l = 0; l < n; ++l) {
+          auto& track = tracks[active[first + l]];
+          for (unsigned int j = 0; j < 6; ++j)
+            track.state[j] = state[j][l];
+        }
+      }
+
+      for (auto i : active) {
+        auto& track = tracks[i];
+        track.stot += steps[i];
+        double remaining = distance(track);
+        if (std::abs(remaining) < eps) {
+          track.status = BatchTrack::done;
+          continue;
+        }
+        if (remaining * track.startDistance <= 0)
+          track.direction = invertDirection(track.direction);
+        track.startDistance = remaining;
+      }
+    }
+
+    for (auto& track : tracks)
+      if (track.status == BatchTrack::active) {
+        edm::LogError("FailedPropagation") << " too many iterations trying to reach surface ";
+        track.status = BatchTrack::failed;
+      }
+  }
+
+  std::pair<TrajectoryStateOnSurface, double> finalState(const FreeTrajectoryState& fts,
+                                                        const BatchTrack& track,
+                                                        const Surface& surface,
+                                                        const MagneticField* field,
+                                                        PropagationDirection dir) {
+    if (track.status != BatchTrack::done)
+      return std::pair<TrajectoryStateOnSurface, double>(TrajectoryStateOnSurface(), 0.);
+
+    GlobalTrajectoryParameters gtp(track.position(), track.momentum(), fts.charge(), field);
+    SurfaceSideDefinition::SurfaceSide side = PropagationDirectionFromPath()(track.stot, dir) == alongMomentum
+                                                  ? SurfaceSideDefinition::beforeSurface
+                                                  : SurfaceSideDefinition::afterSurface;
+    return analyticalErrorPropagation(fts, surface, side, gtp, track.stot);
+  }
+
+}  // namespace
+
+RKBatchPropagator::RKBatchPropagator(const MagneticField* field, PropagationDirection dir, double tolerance)
+    : Propagator(dir), theField(field), theTolerance(tolerance), theScalar(field, dir, tolerance) {}
+
+Propagator* RKBatchPropagator::clone() const {
+  return new RKBatchPropagator(theField, propagationDirection(), theTolerance);
+}
+
+void RKBatchPropagator::propagateWithPath(const FreeTrajectoryState* fts,
+                                          unsigned int n,
+                                          const Plane& plane,
+                                          std::pair<TrajectoryStateOnSurface, double>* result) const {
+  std::vector<BatchTrack> tracks;
+  tracks.reserve(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    // straight line
+    if
+      UNLIKELY(std::abs(fts[i].transverseCurvature()) < 1.e-10) {
+        result[i] = propagateWithPath(fts[i], plane);
+        continue;
+      }
+    GlobalPoint gpos(fts[i].position());
+    GlobalVector gmom(fts[i].momentum());
+    tracks.push_back(BatchTrack{i,
+                                {gpos.x(), gpos.y(), gpos.z(), gmom.x(), gmom.y(), gmom.z()},
+                                float(fts[i].charge()),
+                                0.,
+                                plane.localZ(gpos),
+                                propagationDirection(),
+                                BatchTrack::active});
+  }
+
+  RKLocalFieldProvider field(theScalar.volume);
+  PathToPlane2Order pathToPlane(field, &field.frame());
+  solve<batchSize>(
+      *theField,
+      tracks,
+      theTolerance,
+      [&](const BatchTrack& track) {
+        return pathToPlane(plane, track.position(), track.momentum(), track.charge, track.direction);
+      },
+      [&](const BatchTrack& track) { return plane.localZ(track.position()); });
+
+  for (auto const& track : tracks)
+    result[track.index] = finalState(fts[track.index], track, plane, theField, propagationDirection());
+}
+
+void RKBatchPropagator::propagateWithPath(const FreeTrajectoryState* fts,
+                                          unsigned int n,
+                                          const Cylinder& cyl,
+                                          std::pair<TrajectoryStateOnSurface, double>* result) const {
+  const GlobalPoint& sp = cyl.position();
+  if
+    UNLIKELY(sp.x() != 0. || sp.y() != 0.) { throw PropagationException("Cannot propagate to an arbitrary cylinder"); }
+
+  std::vector<BatchTrack> tracks;
+  tracks.reserve(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    // straight line
+    if
+      UNLIKELY(std::abs(fts[i].transverseCurvature()) < 1.e-10) {
+        result[i] = propagateWithPath(fts[i], cyl);
+        continue;
+      }
+    GlobalPoint gpos(fts[i].position());
+    GlobalVector gmom(fts[i].momentum());
+    tracks.push_back(BatchTrack{i,
+                                {gpos.x(), gpos.y(), gpos.z(), gmom.x(), gmom.y(), gmom.z()},
+                                float(fts[i].charge()),
+                                0.,
+                                cyl.radius() - cyl.toLocal(gpos).perp(),
+                                propagationDirection(),
+                                BatchTrack::active});
+  }
+
+  const float eps = theTolerance;
+  solve<batchSize>(
+      *theField,
+      tracks,
+      eps,
+      [&](const BatchTrack& track) {
+        StraightLineCylinderCrossing pathLength(
+            cyl.toLocal(track.position()), cyl.toLocal(track.momentum()), track.direction, eps);
+        return pathLength.pathLength(cyl);
+      },
+      [&](const BatchTrack& track) { return cyl.radius() - cyl.toLocal(track.position()).perp(); });
+
+  for (auto const& track : tracks)
+    result[track.index] = finalState(fts[track.index], track, cyl, theField, propagationDirection());
+}
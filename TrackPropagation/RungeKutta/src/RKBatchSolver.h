@@ -0,0 +1,187 @@
+#ifndef RKBatchSolver_H
+#define RKBatchSolver_H
+
+#include "FWCore/Utilities/interface/Visibility.h"
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "RKAdaptiveSolver.h"  // RKDetails::fastPow
+
+#include <algorithm>
+#include <cmath>
+
+/** Cash-Karp Runge-Kutta integration of the Lorentz force for N tracks at once.
+ *
+ *  The state of lane l is (x, y, z, px, py, pz) in the global frame, stored as state[i][l],
+ *  and is integrated over the path length s[l] with the adaptive step control of RKAdaptiveSolver.
+ *  Every lane has its own step size: all the lanes do their next step together, the field at the
+ *  positions of a stage being obtained with one MagneticField::inTeslaBatch call for the lanes
+ *  which are not finished, everything else being loops over the lanes.
+ *  Only the first n lanes are used, the others must hold a valid state (e.g. a copy of lane 0)
+ *  and are not modified.
+ */
+template <unsigned int N>
+class dso_internal RKBatchSolver {
+public:
+  typedef double State[6][N];
+
+  explicit RKBatchSolver(const MagneticField& field) : theField(field) {}
+
+  void operator()(State& state, const double (&s)[N], const float (&charge)[N], unsigned int n, float eps) const;
+
+private:
+  /// h[l] times the derivative of the state v in k, the field is computed for the lanes with h[l] != 0
+  void derivative(const State& v, const double (&h)[N], const float (&kq)[N], State& k) const;
+
+  /// One step of h[l] for each lane, the result is in r and the error estimate in acc
+  void step(const State& v, const double (&h)[N], const float (&kq)[N], State& r, float (&acc)[N]) const;
+
+  const MagneticField& theField;
+};
+
+template <unsigned int N>
+void RKBatchSolver<N>::derivative(const State& v, const double (&h)[N], const float (&kq)[N], State& k) const {
+  GlobalPoint pos[N];
+  GlobalVector b[N];
+  unsigned int lane[N];
+  unsigned int n = 0;
+  for (unsigned int l = 0; l < N; ++l)
+    if (h[l] != 0) {
+      pos[n] = GlobalPoint(v[0][l], v[1][l], v[2][l]);
+      lane[n++] = l;
+    }
+  theField.inTeslaBatch(pos, b, n);
+
+  float bx[N] = {}, by[N] = {}, bz[N] = {};
+  for (unsigned int j = 0; j < n; ++j) {
+    bx[lane[j]] = b[j].x();
+    by[lane[j]] = b[j].y();
+    bz[lane[j]] = b[j].z();
+  }
+
+  for (unsigned int l = 0; l < N; ++l) {
+    // d(pos)/ds is the unit momentum, d(mom)/ds the Lorentz force
+    double hp = h[l] / std::sqrt(v[3][l] * v[3][l] + v[4][l] * v[4][l] + v[5][l] * v[5][l]);
+    double ux = v[3][l] * hp, uy = v[4][l] * hp, uz = v[5][l] * hp;
+    k[0][l] = ux;
+    k[1][l] = uy;
+    k[2][l] = uz;
+    k[3][l] = kq[l] * (uy * bz[l] - uz * by[l]);
+    k[4][l] = kq[l] * (uz * bx[l] - ux * bz[l]);
+    k[5][l] = kq[l] * (ux * by[l] - uy * bx[l]);
+  }
+}
+
+template <unsigned int N>
+void RKBatchSolver<N>::step(
+    const State& v, const double (&h)[N], const float (&kq)[N], State& r, float (&acc)[N]) const {
+  // same coefficients as RKOneCashKarpStep
+  constexpr double b21 = 0.2;
+  constexpr double b31 = 3. / 40., b32 = 9. / 40.;
+  constexpr double b41 = 0.3, b42 = -0.9, b43 = 1.2;
+  constexpr double b51 = -11. / 54., b52 = 5. / 2., b53 = -70. / 27., b54 = 35. / 27.;
+  constexpr double b61 = 1631. / 55296., b62 = 175. / 512., b63 = 575. / 13824., b64 = 44275. / 110592.,
+                   b65 = 253. / 4096.;
+  constexpr double c1 = 37. / 378., c3 = 250. / 621., c4 = 125. / 594., c6 = 512. / 1771.;
+  constexpr double d1 = 2825. / 27648., d3 = 18575. / 48384., d4 = 13525. / 55296., d5 = 277. / 14336., d6 = 0.25;
+
+  State k1, k2, k3, k4, k5, k6, arg;
+  derivative(v, h, kq, k1);
+  for (unsigned int i = 0; i < 6; ++i)
+    for (unsigned int l = 0; l < N; ++l)
+      arg[i][l] = v[i][l] + b21 * k1[i][l];
+  derivative(arg, h, kq, k2);
+  for (unsigned int i = 0; i < 6; ++i)
+    for (unsigned int l = 0; l < N; ++l)
+      arg[i][l] = v[i][l] + b31 * k1[i][l] + b32 * k2[i][l];
+  derivative(arg, h, kq, k3);
+  for (unsigned int i = 0; i < 6; ++i)
+    for (unsigned int l = 0; l < N; ++l)
+      arg[i][l] = v[i][l] + b41 * k1[i][l] + b42 * k2[i][l] + b43 * k3[i][l];
+  derivative(arg, h, kq, k4);
+  for (unsigned int i = 0; i < 6; ++i)
+    for (unsigned int l = 0; l < N; ++l)
+      arg[i][l] = v[i][l] + b51 * k1[i][l] + b52 * k2[i][l] + b53 * k3[i][l] + b54 * k4[i][l];
+  derivative(arg, h, kq, k5);
+  for (unsigned int i = 0; i < 6; ++i)
+    for (unsigned int l = 0; l < N; ++l)
+      arg[i][l] = v[i][l] + b61 * k1[i][l] + b62 * k2[i][l] + b63 * k3[i][l] + b64 * k4[i][l] + b65 * k5[i][l];
+  derivative(arg, h, kq, k6);
+
+  // 5th order result, and its distance to the 4th order one as in RKCartesianDistance
+  double dpos2[N] = {}, dmom2[N] = {}, mom2[N] = {};
+  for (unsigned int i = 0; i < 6; ++i)
+    for (unsigned int l = 0; l < N; ++l) {
+      r[i][l] = v[i][l] + c1 * k1[i][l] + c3 * k3[i][l] + c4 * k4[i][l] + c6 * k6[i][l];
+      double d =
+          (c1 - d1) * k1[i][l] + (c3 - d3) * k3[i][l] + (c4 - d4) * k4[i][l] - d5 * k5[i][l] + (c6 - d6) * k6[i][l];
+      if (i < 3)
+        dpos2[l] += d * d;
+      else {
+        dmom2[l] += d * d;
+        mom2[l] += r[i][l] * r[i][l];
+      }
+    }
+  for (unsigned int l = 0; l < N; ++l)
+    acc[l] = std::sqrt(dpos2[l]) + std::sqrt(dmom2[l] / mom2[l]);
+}
+
+template <unsigned int N>
+void RKBatchSolver<N>::operator()(
+    State& state, const double (&s)[N], const float (&charge)[N], unsigned int n, float eps) const {
+  using namespace RKDetails;
+  constexpr float Safety = 0.9;
+  constexpr float k = 2.99792458e-3;  // conversion to [cm]
+
+  float kq[N];
+  double remainingStep[N], stepSize[N];
+  unsigned int nActive = 0;
+  for (unsigned int l = 0; l < N; ++l) {
+    kq[l] = k * charge[l];
+    remainingStep[l] = l < n ? s[l] : 0.;
+    stepSize[l] = remainingStep[l];  // attempt to solve in one step
+    if (stepSize[l] != 0)
+      ++nActive;
+  }
+
+  // the step control of each lane is the one of RKAdaptiveSolver; a finished lane has a null step
+  State tryStep;
+  float acc[N];
+  while (nActive > 0) {
+    step(state, stepSize, kq, tryStep, acc);
+    for (unsigned int l = 0; l < N; ++l) {
+      if (stepSize[l] == 0)
+        continue;
+      if (acc[l] < eps || std::abs(stepSize[l]) < std::abs(remainingStep[l]) * 0.1f) {
+        for (unsigned int i = 0; i < 6; ++i)
+          state[i][l] = tryStep[i][l];
+        if (std::abs(remainingStep[l] - stepSize[l]) < 0.5f * eps) {
+          stepSize[l] = 0;  // we are there
+          --nActive;
+          continue;
+        }
+        remainingStep[l] -= stepSize[l];
+        if (std::abs(remainingStep[l]) <= eps * 0.5f) {
+          stepSize[l] = 0;
+          --nActive;
+          continue;
+        }
+        // increase step size
+        const float cut = std::pow(4.f / Safety, 5.f);
+        float factor = (eps < cut * acc[l]) ? Safety * fastPow(eps / acc[l], 0.2) : 4.f;
+        double absRemainingStep = std::abs(remainingStep[l]);
+        double absSize = std::min(std::abs(stepSize[l] * factor), absRemainingStep);
+        if (absSize < 0.05f * absRemainingStep)
+          absSize = 0.05f * absRemainingStep;
+        stepSize[l] = std::copysign(absSize, stepSize[l]);
+      } else {
+        // decrease step size
+        constexpr float cut = Safety * Safety * Safety * Safety * 100 * 100;
+        float factor = (cut * eps > acc[l]) ? Safety * fastPow(eps / acc[l], 0.25) : 0.1f;
+        stepSize[l] *= factor;
+        if (std::abs(stepSize[l]) < 0.05f * std::abs(remainingStep[l]))
+          stepSize[l] = 0.05f * remainingStep[l];
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,125 @@
+// Compare the batch propagation of RKBatchPropagator with the propagation of
+// each state by RKPropagatorInS, to planes and to a cylinder.
+
+#include "TrackPropagation/RungeKutta/interface/RKBatchPropagator.h"
+#include "TrackPropagation/RungeKutta/interface/defaultRKPropagator.h"
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "DataFormats/GeometrySurface/interface/Cylinder.h"
+#include "TrackingTools/TrajectoryState/interface/FreeTrajectoryState.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+  // solenoid-like field, with some radial component
+  class TestField final : public MagneticField {
+  public:
+    GlobalVector inTesla(const GlobalPoint& gp) const override {
+      float r2 = gp.perp2(), z = gp.z();
+      float br = 3.e-6f * z;  // Br/r
+      return GlobalVector(br * gp.x(), br * gp.y(), 3.8f - 3.e-6f * z * z - 1.e-5f * r2);
+    }
+  };
+
+  using TsosWP = std::pair<TrajectoryStateOnSurface, double>;
+
+  int compare(const char* what, const std::vector<TsosWP>& batch, const std::vector<TsosWP>& single) {
+    int failures = 0;
+    double maxDPos = 0, maxDMom = 0, maxDPath = 0;
+    for (unsigned int i = 0; i < batch.size(); ++i) {
+      if (batch[i].first.isValid() != single[i].first.isValid()) {
+        std::cout << what << ": state " << i << " valid " << batch[i].first.isValid() << " vs "
+                  << single[i].first.isValid() << std::endl;
+        ++failures;
+        continue;
+      }
+      if (!batch[i].first.isValid())
+        continue;
+      maxDPos = std::max(maxDPos, double((batch[i].first.globalPosition() - single[i].first.globalPosition()).mag()));
+      maxDMom = std::max(maxDMom,
+                         double((batch[i].first.globalMomentum() - single[i].first.globalMomentum()).mag() /
+                                single[i].first.globalMomentum().mag()));
+      maxDPath = std::max(maxDPath, std::abs(batch[i].second - single[i].second));
+    }
+    std::cout << what << ": max |dpos| " << maxDPos << " cm, max |dp|/p " << maxDMom << ", max |dpath| " << maxDPath
+              << " cm" << std::endl;
+    // the tolerance is 5.e-5 cm, the two propagators differ by the float/double rounding and the step control
+    if (maxDPos > 1.e-3 || maxDMom > 1.e-5 || maxDPath > 1.e-3)
+      ++failures;
+    return failures;
+  }
+}  // namespace
+
+int main() {
+  TestField field;
+  RKBatchPropagator batchPropagator(&field, anyDirection);
+  defaultRKPropagator::Product scalar(&field, anyDirection);
+  const Propagator& singlePropagator = scalar.propagator;
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> u(0.f, 1.f);
+  std::vector<FreeTrajectoryState> states;
+  for (int i = 0; i < 1000; ++i) {
+    float pt = 0.8f + 20.f * u(gen), phi = 6.28f * u(gen), eta = 2.4f * (2.f * u(gen) - 1.f);
+    GlobalPoint x(0.1f * u(gen), 0.1f * u(gen), 10.f * (2.f * u(gen) - 1.f));
+    GlobalVector p(pt * std::cos(phi), pt * std::sin(phi), pt * std::sinh(eta));
+    states.emplace_back(GlobalTrajectoryParameters(x, p, u(gen) < 0.5f ? -1 : 1, &field));
+  }
+  // a straight line, done by RKPropagatorInS
+  states.emplace_back(GlobalTrajectoryParameters(GlobalPoint(0, 0, 0), GlobalVector(1.e9, 0, 0), 1, &field));
+
+  int failures = 0;
+  std::vector<TsosWP> batch(states.size()), single(states.size());
+
+  // cylinder
+  Cylinder::CylinderPointer cylinder = Cylinder::build(50.f, Surface::PositionType(0, 0, 0), Surface::RotationType());
+  auto start = std::chrono::steady_clock::now();
+  batchPropagator.propagateWithPath(states.data(), states.size(), *cylinder, batch.data());
+  auto batchTime = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < states.size(); ++i)
+    single[i] = singlePropagator.propagateWithPath(states[i], *cylinder);
+  auto singleTime = std::chrono::steady_clock::now() - start;
+  failures += compare("cylinder", batch, single);
+  std::cout << "time per state: batch " << std::chrono::duration<double, std::micro>(batchTime).count() / states.size()
+            << " us, single " << std::chrono::duration<double, std::micro>(singleTime).count() / states.size() << " us"
+            << std::endl;
+
+  // planes along the momentum
+  for (float d : {20.f, 80.f}) {
+    for (unsigned int i = 0; i < states.size(); ++i)
+      batch[i] = single[i] = TsosWP();
+    std::vector<Plane::PlanePointer> planes;
+    for (auto const& fts : states) {
+      GlobalVector zAxis = fts.momentum().unit();
+      GlobalVector yAxis(zAxis.y(), -zAxis.x(), 0);
+      GlobalVector xAxis = yAxis.cross(zAxis);
+      planes.push_back(Plane::build(fts.position() + d * zAxis, Surface::RotationType(xAxis, yAxis, zAxis)));
+    }
+    // one plane at a time, the batch call is for states propagated to the same surface
+    for (unsigned int i = 0; i < states.size(); ++i) {
+      batchPropagator.propagateWithPath(&states[i], 1, *planes[i], &batch[i]);
+      single[i] = singlePropagator.propagateWithPath(states[i], *planes[i]);
+    }
+    failures += compare(d < 50 ? "plane at 20 cm" : "plane at 80 cm", batch, single);
+  }
+
+  // a plane transverse to the beam line, for the forward states
+  Plane::PlanePointer disk = Plane::build(Surface::PositionType(0, 0, 100), Surface::RotationType());
+  std::vector<FreeTrajectoryState> forward;
+  for (auto const& fts : states)
+    if (fts.momentum().z() > fts.momentum().perp())
+      forward.push_back(fts);
+  batch.resize(forward.size());
+  single.resize(forward.size());
+  batchPropagator.propagateWithPath(forward.data(), forward.size(), *disk, batch.data());
+  for (unsigned int i = 0; i < forward.size(); ++i)
+    single[i] = singlePropagator.propagateWithPath(forward[i], *disk);
+  failures += compare("disk at z=100 cm", batch, single);
+
+  return failures == 0 ? 0 : 1;
+}
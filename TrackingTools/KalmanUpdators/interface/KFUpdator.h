@@ -18,6 +18,13 @@
  * It relies on CLHEP double precision vectors and matrices for 
  * matrix calculations. <BR>
  *
+ * The 1D and 2D measurements of the local position (strip, pixel and
+ * matched hits) use the same sparse kernel as updateBatch() instead of the
+ * 5x5 matrix products. <BR>
+ *
+ * updateBatch() processes the 2D local position measurements in groups
+ * of states stored as structure of arrays (see KFUpdatorSoA.h). <BR>
+ *
  * Arguments: TrajectoryState &   predicted state <BR>
  *            RecHit &            reconstructed hit <BR>
  *
@@ -37,6 +44,10 @@ public:
 
   TrajectoryStateOnSurface update(const TrajectoryStateOnSurface&, const TrackingRecHit&) const override;
 
+  void updateBatch(std::vector<const TrajectoryStateOnSurface*> const& tsos,
+                   std::vector<const TrackingRecHit*> const& hits,
+                   std::vector<TrajectoryStateOnSurface>& result) const override;
+
   KFUpdator* clone() const override { return new KFUpdator(*this); }
 };
 
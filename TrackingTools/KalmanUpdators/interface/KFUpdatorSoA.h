@@ -0,0 +1,136 @@
+#ifndef TrackingTools_KalmanUpdators_KFUpdatorSoA_h
+#define TrackingTools_KalmanUpdators_KFUpdatorSoA_h
+
+/** \class KFUpdatorSoA
+ *  Kalman update of N trajectory states at once with D-dimensional (1 or 2)
+ *  measurements of the local position (H projects on the local x, and on the
+ *  local y for D=2, of the state).
+ *
+ *  All matrices are stored as structure of arrays: element e of the matrix of
+ *  lane i is at [e][i], so that every step of the update is a loop over the
+ *  lanes which the compiler vectorises. With N=1 the same code is the scalar
+ *  fast path of KFUpdator::update.
+ *  Symmetric matrices use the lower triangle, row by row, as MatRepSym does.
+ *  The filtered error is computed in Joseph form as in KFUpdator, using the
+ *  sparsity of H instead of full 5x5 products.
+ *  All N lanes are always computed, unused lanes must hold a valid input
+ *  (e.g. a copy of lane 0) and their output is ignored.
+ *  posDef tells for each lane if the covariance matrix of the residuals is
+ *  positive definite; the output of the lanes where it is not is meaningless.
+ */
+
+namespace kfSoA {
+
+  constexpr unsigned int symIndex(unsigned int i, unsigned int j) {
+    return i >= j ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i;
+  }
+
+  template <typename T, unsigned int D, unsigned int N>
+  struct UpdateLocal {
+    static_assert(D == 1 || D == 2, "only the local x or the local (x,y) can be measured");
+    static constexpr unsigned int size = N;
+    static constexpr unsigned int dim = D;
+    // first component of the local parameters which is measured
+    static constexpr unsigned int first = 3;
+
+    // input
+    alignas(64) T x[5][N];                 // predicted local parameters
+    alignas(64) T c[15][N];                // predicted local error
+    alignas(64) T r[D][N];                 // residual: measured position - projected state
+    alignas(64) T v[D * (D + 1) / 2][N];   // hit error
+    alignas(64) T vp[D * (D + 1) / 2][N];  // projected state error
+
+    // output
+    alignas(64) T fx[5][N];   // filtered local parameters
+    alignas(64) T fc[15][N];  // filtered local error
+    bool posDef[N];           // the residual covariance V + VP could be inverted
+
+    void run();
+  };
+
+  template <typename T, unsigned int N>
+  using Update2D = UpdateLocal<T, 2, N>;
+
+  template <typename T, unsigned int D, unsigned int N>
+  void UpdateLocal<T, D, N>::run() {
+    // inverse of the covariance matrix of the residuals (fastInvertPDM2 for D=2), which is
+    // positive definite if its pivots (and so its determinant) are positive
+    alignas(64) T ri[D * (D + 1) / 2][N];
+    if constexpr (D == 1) {
+      for (unsigned int l = 0; l < N; ++l) {
+        T r0 = v[0][l] + vp[0][l];
+        posDef[l] = r0 > T(0.);
+        ri[0][l] = T(1.) / r0;
+      }
+    } else {
+      for (unsigned int l = 0; l < N; ++l) {
+        T r0 = v[0][l] + vp[0][l];
+        T r1 = v[1][l] + vp[1][l];
+        T r2 = v[2][l] + vp[2][l];
+        T c0 = T(1.) / r0;
+        T c1 = r1 * r1 * c0;
+        T p1 = r2 - c1;
+        posDef[l] = r0 > T(0.) && p1 > T(0.);
+        T c2 = T(1.) / p1;
+        ri[0][l] = c1 * c0 * c2 + c0;
+        ri[1][l] = -r1 * c0 * c2;
+        ri[2][l] = c2;
+      }
+    }
+
+    // Kalman gain K = C H^T R^-1
+    alignas(64) T k[5][D][N];
+    for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int a = 0; a < D; ++a)
+        for (unsigned int l = 0; l < N; ++l) {
+          T s = c[symIndex(i, first)][l] * ri[symIndex(0, a)][l];
+          for (unsigned int b = 1; b < D; ++b)
+            s += c[symIndex(i, first + b)][l] * ri[symIndex(b, a)][l];
+          k[i][a][l] = s;
+        }
+
+    // filtered state x + K r
+    for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int l = 0; l < N; ++l) {
+        T s = k[i][0][l] * r[0][l];
+        for (unsigned int a = 1; a < D; ++a)
+          s += k[i][a][l] * r[a][l];
+        fx[i][l] = x[i][l] + s;
+      }
+
+    // filtered error M C M^T + K V K^T with M = 1 - K H.
+    // H only picks the measured components, so M C = C - K (H C) and (M C) M^T = M C - (M C H^T) K^T
+    alignas(64) T mc[5][5][N];
+    for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int j = 0; j < 5; ++j)
+        for (unsigned int l = 0; l < N; ++l) {
+          T s = k[i][0][l] * c[symIndex(first, j)][l];
+          for (unsigned int a = 1; a < D; ++a)
+            s += k[i][a][l] * c[symIndex(first + a, j)][l];
+          mc[i][j][l] = c[symIndex(i, j)][l] - s;
+        }
+    alignas(64) T kv[5][D][N];
+    for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int a = 0; a < D; ++a)
+        for (unsigned int l = 0; l < N; ++l) {
+          T s = k[i][0][l] * v[symIndex(a, 0)][l];
+          for (unsigned int b = 1; b < D; ++b)
+            s += k[i][b][l] * v[symIndex(a, b)][l];
+          kv[i][a][l] = s;
+        }
+    for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int j = 0; j <= i; ++j)
+        for (unsigned int l = 0; l < N; ++l) {
+          T m = mc[i][first][l] * k[j][0][l];
+          T p = kv[i][0][l] * k[j][0][l];
+          for (unsigned int a = 1; a < D; ++a) {
+            m += mc[i][first + a][l] * k[j][a][l];
+            p += kv[i][a][l] * k[j][a][l];
+          }
+          fc[symIndex(i, j)][l] = (mc[i][j][l] - m) + p;
+        }
+  }
+
+}  // namespace kfSoA
+
+#endif
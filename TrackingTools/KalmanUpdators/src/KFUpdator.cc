@@ -1,4 +1,5 @@
 #include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "TrackingTools/KalmanUpdators/interface/KFUpdatorSoA.h"
 #include "TrackingTools/PatternTools/interface/MeasurementExtractor.h"
 #include "TrackingTools/TransientTrackingRecHit/interface/TransientTrackingRecHit.h"
 #include "DataFormats/GeometrySurface/interface/Plane.h"
@@ -54,6 +55,54 @@ namespace {
 
 namespace {
 
+  // true if H just picks the local position, i.e. the measured components are the kfSoA ones
+  template <unsigned int D>
+  bool measuresLocalPosition(ProjectMatrix<double, 5, D> const& pf) {
+    for (unsigned int i = 0; i < D; ++i)
+      if (pf.index[i] != kfSoA::UpdateLocal<double, D, 1>::first + i)
+        return false;
+    return true;
+  }
+
+  // same update as lupdate for the 1D and 2D hits measuring the local position, using the sparsity of H,
+  // an invalid state if the covariance of the residuals is not positive definite
+  template <unsigned int D>
+  TrajectoryStateOnSurface lupdateLocal(const TrajectoryStateOnSurface& tsos,
+                                        AlgebraicROOTObject<5>::Vector const& x,
+                                        AlgebraicSymMatrix55 const& C,
+                                        typename AlgebraicROOTObject<D>::Vector const& r,
+                                        typename AlgebraicROOTObject<D, D>::SymMatrix const& V,
+                                        typename AlgebraicROOTObject<D, D>::SymMatrix const& VMeas) {
+    kfSoA::UpdateLocal<double, D, 1> kernel;
+    for (unsigned int i = 0; i < 5; ++i)
+      kernel.x[i][0] = x[i];
+    for (unsigned int i = 0; i < 15; ++i)
+      kernel.c[i][0] = C.Array()[i];
+    for (unsigned int i = 0; i < D; ++i)
+      kernel.r[i][0] = r[i];
+    for (unsigned int i = 0; i < D * (D + 1) / 2; ++i) {
+      kernel.v[i][0] = V.Array()[i];
+      kernel.vp[i][0] = VMeas.Array()[i];
+    }
+    kernel.run();
+    if (!kernel.posDef[0]) {
+      edm::LogError("KFUpdator") << " could not invert martix:\n" << (V + VMeas);
+      return TrajectoryStateOnSurface();
+    }
+
+    AlgebraicVector5 fsv;
+    AlgebraicSymMatrix55 fse;
+    for (unsigned int i = 0; i < 5; ++i)
+      fsv[i] = kernel.fx[i][0];
+    for (unsigned int i = 0; i < 15; ++i)
+      fse.Array()[i] = kernel.fc[i][0];
+    return TrajectoryStateOnSurface(LocalTrajectoryParameters(fsv, tsos.localParameters().pzSign()),
+                                    LocalTrajectoryError(fse),
+                                    tsos.surface(),
+                                    &(tsos.globalParameters().magneticField()),
+                                    tsos.surfaceSide());
+  }
+
   template <unsigned int D>
   TrajectoryStateOnSurface lupdate(const TrajectoryStateOnSurface& tsos, const TrackingRecHit& aRecHit) {
     typedef typename AlgebraicROOTObject<D, 5>::Matrix MatD5;
@@ -79,6 +128,15 @@ namespace {
 
     r -= rMeas;
 
+#ifndef KU_JF_TEST
+    // the fast path checks that the residual covariance is positive definite, the 1D and 2D
+    // invertPosDefMatrix below do not
+    if constexpr (D <= 2) {
+      if (measuresLocalPosition(pf))
+        return lupdateLocal<D>(tsos, x, C, r, V, VMeas);
+    }
+#endif
+
     // and covariance matrix of residuals
     SMatDD R = V + VMeas;
     bool ok = invertPosDefMatrix(R);
@@ -190,3 +248,93 @@ TrajectoryStateOnSurface KFUpdator::update(const TrajectoryStateOnSurface& tsos,
   throw cms::Exception("Rec hit of invalid dimension (not 1,2,3,4,5)")
       << "The value was " << aRecHit.dimension() << ", type is " << typeid(aRecHit).name() << "\n";
 }
+
+void KFUpdator::updateBatch(std::vector<const TrajectoryStateOnSurface*> const& tsos,
+                            std::vector<const TrackingRecHit*> const& hits,
+                            std::vector<TrajectoryStateOnSurface>& result) const {
+  constexpr unsigned int N = 8;
+  kfSoA::Update2D<double, N> batch;
+  unsigned int index[N];
+  unsigned int n = 0;
+
+  result.clear();
+  result.resize(tsos.size());
+
+  auto flush = [&]() {
+    // the unused lanes repeat the first one
+    for (unsigned int l = n; l < N; ++l) {
+      for (unsigned int i = 0; i < 5; ++i)
+        batch.x[i][l] = batch.x[i][0];
+      for (unsigned int i = 0; i < 15; ++i)
+        batch.c[i][l] = batch.c[i][0];
+      for (unsigned int i = 0; i < 2; ++i)
+        batch.r[i][l] = batch.r[i][0];
+      for (unsigned int i = 0; i < 3; ++i) {
+        batch.v[i][l] = batch.v[i][0];
+        batch.vp[i][l] = batch.vp[i][0];
+      }
+    }
+    batch.run();
+    for (unsigned int l = 0; l < n; ++l) {
+      // the states whose residual covariance cannot be inverted are left to update, which reports it
+      if (!batch.posDef[l]) {
+        result[index[l]] = update(*tsos[index[l]], *hits[index[l]]);
+        continue;
+      }
+      auto const& ts = *tsos[index[l]];
+      AlgebraicVector5 fsv;
+      AlgebraicSymMatrix55 fse;
+      for (unsigned int i = 0; i < 5; ++i)
+        fsv[i] = batch.fx[i][l];
+      for (unsigned int i = 0; i < 15; ++i)
+        fse.Array()[i] = batch.fc[i][l];
+      result[index[l]] = TrajectoryStateOnSurface(LocalTrajectoryParameters(fsv, ts.localParameters().pzSign()),
+                                                  LocalTrajectoryError(fse),
+                                                  ts.surface(),
+                                                  &(ts.globalParameters().magneticField()),
+                                                  ts.surfaceSide());
+    }
+    n = 0;
+  };
+
+  for (unsigned int k = 0; k < tsos.size(); ++k) {
+    if (hits[k]->dimension() != 2) {
+      result[k] = update(*tsos[k], *hits[k]);
+      continue;
+    }
+
+    auto&& x = tsos[k]->localParameters().vector();
+    auto&& C = tsos[k]->localError().matrix();
+
+    ProjectMatrix<double, 5, 2> pf;
+    AlgebraicVector2 r, rMeas;
+    AlgebraicSymMatrix22 V(ROOT::Math::SMatrixNoInit{}), VMeas(ROOT::Math::SMatrixNoInit{});
+
+    KfComponentsHolder holder;
+    holder.setup<2>(&r, &V, &pf, &rMeas, &VMeas, x, C);
+    hits[k]->getKfComponents(holder);
+
+    // the batch assumes H picks the local position
+    if (!measuresLocalPosition(pf)) {
+      result[k] = update(*tsos[k], *hits[k]);
+      continue;
+    }
+
+    r -= rMeas;
+    for (unsigned int i = 0; i < 5; ++i)
+      batch.x[i][n] = x[i];
+    for (unsigned int i = 0; i < 15; ++i)
+      batch.c[i][n] = C.Array()[i];
+    for (unsigned int i = 0; i < 2; ++i)
+      batch.r[i][n] = r[i];
+    for (unsigned int i = 0; i < 3; ++i) {
+      batch.v[i][n] = V.Array()[i];
+      batch.vp[i][n] = VMeas.Array()[i];
+    }
+    index[n++] = k;
+    if (n == N)
+      flush();
+  }
+  if (n > 0)
+    flush();
+}
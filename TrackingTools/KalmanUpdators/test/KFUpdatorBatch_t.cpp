@@ -0,0 +1,132 @@
+#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "DataFormats/GeometrySurface/interface/Surface.h"
+#include "DataFormats/GeometrySurface/interface/BoundPlane.h"
+#include <Geometry/CommonDetUnit/interface/GeomDet.h>
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit2D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit1D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// compare KFUpdator::updateBatch with the update of one state at a time
+
+class ConstMagneticField : public MagneticField {
+public:
+  GlobalVector inTesla(const GlobalPoint&) const override { return GlobalVector(0, 0, 4); }
+};
+
+class MyDet : public GeomDet {
+public:
+  MyDet(BoundPlane* bp, DetId id) : GeomDet(bp) { setDetId(id); }
+
+  std::vector<const GeomDet*> components() const override { return std::vector<const GeomDet*>(); }
+
+  SubDetector subDetector() const override { return GeomDetEnumerators::PixelBarrel; }
+};
+
+namespace {
+  bool close(double a, double b) { return std::abs(a - b) <= 1.e-9 * std::max(1., std::max(std::abs(a), std::abs(b))); }
+
+  bool same(TrajectoryStateOnSurface const& a, TrajectoryStateOnSurface const& b) {
+    if (a.isValid() != b.isValid())
+      return false;
+    if (!a.isValid())
+      return true;
+    auto const& va = a.localParameters().vector();
+    auto const& vb = b.localParameters().vector();
+    for (unsigned int i = 0; i < 5; ++i)
+      if (!close(va[i], vb[i]))
+        return false;
+    auto const& ea = a.localError().matrix();
+    auto const& eb = b.localError().matrix();
+    for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int j = 0; j <= i; ++j)
+        if (!close(ea(i, j), eb(i, j)))
+          return false;
+    return a.localParameters().pzSign() == b.localParameters().pzSign() && &a.surface() == &b.surface();
+  }
+}  // namespace
+
+int main() {
+  MagneticField* field = new ConstMagneticField;
+  GlobalPoint gp(0, 0, 0);
+  BoundPlane* plane = new BoundPlane(gp, Surface::RotationType());
+  GeomDet* det = new MyDet(plane, 41);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> pos(-1.f, 1.f);
+  std::uniform_real_distribution<float> err(0.001f, 0.1f);
+
+  OmniClusterRef cref;
+  SiPixelRecHit::ClusterRef pref;
+
+  // 2D hits of different kinds mixed with 1D hits, which are not batched, and hits whose residual
+  // covariance cannot be inverted
+  std::vector<TrajectoryStateOnSurface> states;
+  std::vector<std::unique_ptr<TrackingRecHit>> hitStore;
+  for (unsigned int i = 0; i < 101; ++i) {
+    LocalPoint lp(pos(gen), pos(gen), 0);
+    LocalVector lv(pos(gen), pos(gen), 1.f + pos(gen));
+    LocalTrajectoryParameters ltp(lp, lv, i % 2 ? 1 : -1);
+    LocalTrajectoryError ler(err(gen), err(gen), err(gen), err(gen), err(gen));
+    states.emplace_back(ltp, ler, *plane, field);
+
+    LocalPoint m(pos(gen), pos(gen), 0);
+    float exx = err(gen), eyy = err(gen);
+    float exy = 0.5f * pos(gen) * std::sqrt(exx * eyy);
+    // with a negative error the covariance of the residuals is not positive definite
+    if (i % 10 == 5)
+      exx = -1.f;
+    LocalError e(exx, exy, eyy);
+    switch (i % 3) {
+      case 0:
+        hitStore.emplace_back(new SiPixelRecHit(m, e, 1., *det, pref));
+        break;
+      case 1:
+        hitStore.emplace_back(new SiStripRecHit2D(m, e, *det, cref));
+        break;
+      default:
+        hitStore.emplace_back(new SiStripRecHit1D(m, e, *det, cref));
+    }
+  }
+
+  KFUpdator updator;
+  int failures = 0;
+  for (unsigned int n : {0u, 1u, 7u, 8u, 9u, 64u, 101u}) {
+    std::vector<const TrajectoryStateOnSurface*> tsos;
+    std::vector<const TrackingRecHit*> hits;
+    for (unsigned int i = 0; i < n; ++i) {
+      tsos.push_back(&states[i]);
+      hits.push_back(hitStore[i].get());
+    }
+    std::vector<TrajectoryStateOnSurface> result;
+    updator.updateBatch(tsos, hits, result);
+    if (result.size() != n) {
+      std::cout << "batch of " << n << " returned " << result.size() << " states" << std::endl;
+      ++failures;
+      continue;
+    }
+    for (unsigned int i = 0; i < n; ++i) {
+      if (i % 10 == 5 && result[i].isValid()) {
+        std::cout << "batch of " << n << ": state " << i << " is valid" << std::endl;
+        ++failures;
+      }
+      if (!same(result[i], updator.update(*tsos[i], *hits[i]))) {
+        std::cout << "batch of " << n << ": state " << i << " differs" << std::endl;
+        ++failures;
+      }
+    }
+  }
+
+  std::cout << (failures ? "FAILED" : "OK") << std::endl;
+  return failures ? 1 : 0;
+}
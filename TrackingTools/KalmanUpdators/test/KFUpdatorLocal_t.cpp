@@ -0,0 +1,156 @@
+#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "DataFormats/TrackingRecHit/interface/KfComponentsHolder.h"
+#include "DataFormats/Math/interface/invertPosDefMatrix.h"
+#include "DataFormats/Math/interface/ProjectMatrix.h"
+
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "DataFormats/GeometrySurface/interface/Surface.h"
+#include "DataFormats/GeometrySurface/interface/BoundPlane.h"
+#include <Geometry/CommonDetUnit/interface/GeomDet.h>
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+
+#include "DataFormats/TrackerRecHit2D/interface/SiStripMatchedRecHit2D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit2D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit1D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// compare the sparse update of KFUpdator for 1D and 2D hits with the dense Joseph form
+
+class ConstMagneticField : public MagneticField {
+public:
+  GlobalVector inTesla(const GlobalPoint&) const override { return GlobalVector(0, 0, 4); }
+};
+
+class MyDet : public GeomDet {
+public:
+  MyDet(BoundPlane* bp, DetId id) : GeomDet(bp) { setDetId(id); }
+
+  std::vector<const GeomDet*> components() const override { return std::vector<const GeomDet*>(); }
+
+  SubDetector subDetector() const override { return GeomDetEnumerators::PixelBarrel; }
+};
+
+namespace {
+  bool close(double a, double b) { return std::abs(a - b) <= 1.e-9 * std::max(1., std::max(std::abs(a), std::abs(b))); }
+
+  bool same(TrajectoryStateOnSurface const& a, TrajectoryStateOnSurface const& b) {
+    if (a.isValid() != b.isValid())
+      return false;
+    if (!a.isValid())
+      return true;
+    auto const& va = a.localParameters().vector();
+    auto const& vb = b.localParameters().vector();
+    for (unsigned int i = 0; i < 5; ++i)
+      if (!close(va[i], vb[i]))
+        return false;
+    auto const& ea = a.localError().matrix();
+    auto const& eb = b.localError().matrix();
+    for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int j = 0; j <= i; ++j)
+        if (!close(ea(i, j), eb(i, j)))
+          return false;
+    return a.localParameters().pzSign() == b.localParameters().pzSign() && &a.surface() == &b.surface();
+  }
+
+  // the update with the full 5x5 matrices, as done for the hits of any dimension
+  template <unsigned int D>
+  TrajectoryStateOnSurface denseUpdate(const TrajectoryStateOnSurface& tsos, const TrackingRecHit& aRecHit) {
+    typedef typename AlgebraicROOTObject<5, D>::Matrix Mat5D;
+    typedef typename AlgebraicROOTObject<D, D>::SymMatrix SMatDD;
+    typedef typename AlgebraicROOTObject<D>::Vector VecD;
+
+    auto&& x = tsos.localParameters().vector();
+    auto&& C = tsos.localError().matrix();
+    ProjectMatrix<double, 5, D> pf;
+    VecD r, rMeas;
+    SMatDD V(ROOT::Math::SMatrixNoInit{}), VMeas(ROOT::Math::SMatrixNoInit{});
+    KfComponentsHolder holder;
+    holder.template setup<D>(&r, &V, &pf, &rMeas, &VMeas, x, C);
+    aRecHit.getKfComponents(holder);
+    r -= rMeas;
+
+    SMatDD R = V + VMeas;
+    invertPosDefMatrix(R);
+    AlgebraicMatrix55 M = AlgebraicMatrixID();
+    Mat5D K = C * pf.project(R);
+    pf.projectAndSubtractFrom(M, K);
+    AlgebraicVector5 fsv = x + K * r;
+    AlgebraicSymMatrix55 fse = ROOT::Math::Similarity(M, C) + ROOT::Math::Similarity(K, V);
+    return TrajectoryStateOnSurface(LocalTrajectoryParameters(fsv, tsos.localParameters().pzSign()),
+                                    LocalTrajectoryError(fse),
+                                    tsos.surface(),
+                                    &(tsos.globalParameters().magneticField()),
+                                    tsos.surfaceSide());
+  }
+}  // namespace
+
+int main() {
+  MagneticField* field = new ConstMagneticField;
+  GlobalPoint gp(0, 0, 0);
+  BoundPlane* plane = new BoundPlane(gp, Surface::RotationType());
+  GeomDet* det = new MyDet(plane, 41);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> pos(-1.f, 1.f);
+  std::uniform_real_distribution<float> err(0.001f, 0.1f);
+
+  OmniClusterRef cref;
+  SiPixelRecHit::ClusterRef pref;
+  SiStripRecHit2D dummy;
+
+  KFUpdator updator;
+  int failures = 0;
+  for (unsigned int i = 0; i < 400; ++i) {
+    LocalPoint lp(pos(gen), pos(gen), 0);
+    LocalVector lv(pos(gen), pos(gen), 1.f + pos(gen));
+    LocalTrajectoryParameters ltp(lp, lv, i % 2 ? 1 : -1);
+    LocalTrajectoryError ler(err(gen), err(gen), err(gen), err(gen), err(gen));
+    TrajectoryStateOnSurface state(ltp, ler, *plane, field);
+
+    LocalPoint m(pos(gen), pos(gen), 0);
+    float exx = err(gen), eyy = err(gen);
+    float exy = 0.5f * pos(gen) * std::sqrt(exx * eyy);
+    // with a negative error the covariance of the residuals is not positive definite
+    const bool posDef = i % 10 != 5;
+    if (!posDef)
+      exx = -1.f;
+    LocalError e(exx, exy, eyy);
+    std::unique_ptr<TrackingRecHit> hit;
+    switch (i % 4) {
+      case 0:
+        hit = std::make_unique<SiPixelRecHit>(m, e, 1., *det, pref);
+        break;
+      case 1:
+        hit = std::make_unique<SiStripRecHit2D>(m, e, *det, cref);
+        break;
+      case 2:
+        hit = std::make_unique<SiStripMatchedRecHit2D>(m, e, *det, &dummy, &dummy);
+        break;
+      default:
+        hit = std::make_unique<SiStripRecHit1D>(m, e, *det, cref);
+    }
+
+    if (!posDef) {
+      if (updator.update(state, *hit).isValid()) {
+        std::cout << "state " << i << " with a hit of dimension " << hit->dimension() << " is valid" << std::endl;
+        ++failures;
+      }
+      continue;
+    }
+    auto reference = hit->dimension() == 1 ? denseUpdate<1>(state, *hit) : denseUpdate<2>(state, *hit);
+    if (!same(updator.update(state, *hit), reference)) {
+      std::cout << "state " << i << " with a hit of dimension " << hit->dimension() << " differs" << std::endl;
+      ++failures;
+    }
+  }
+
+  std::cout << (failures ? "FAILED" : "OK") << std::endl;
+  return failures ? 1 : 0;
+}
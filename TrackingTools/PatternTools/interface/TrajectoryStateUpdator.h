@@ -3,6 +3,8 @@
 
 #include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
 
+#include <vector>
+
 class TrackingRecHit;
 
 /** The TrajectoryState updator is a basic track fititng component 
@@ -18,6 +20,18 @@ public:
 
   virtual TrajectoryStateOnSurface update(const TrajectoryStateOnSurface&, const TrackingRecHit&) const = 0;
 
+  /** Update the predicted states tsos[i] with the hits hits[i], result[i] is what update(*tsos[i], *hits[i])
+   *  returns. Implementations may process the pairs together, the default just loops over them.
+   */
+  virtual void updateBatch(std::vector<const TrajectoryStateOnSurface*> const& tsos,
+                           std::vector<const TrackingRecHit*> const& hits,
+                           std::vector<TrajectoryStateOnSurface>& result) const {
+    result.clear();
+    result.reserve(tsos.size());
+    for (unsigned int i = 0; i < tsos.size(); ++i)
+      result.push_back(update(*tsos[i], *hits[i]));
+  }
+
   virtual TrajectoryStateUpdator* clone() const = 0;
 };
 